@@ -1,4 +1,6 @@
 TEMPLATE = subdirs
-SUBDIRS = src
+SUBDIRS = src tests
+
+tests.depends = src
 
 OTHER_FILES += rpm/buteo-sync-plugins-social.spec
@@ -9,6 +9,7 @@ BuildRequires:  pkgconfig(Qt5Core)
 BuildRequires:  pkgconfig(Qt5DBus)
 BuildRequires:  pkgconfig(Qt5Sql)
 BuildRequires:  pkgconfig(Qt5Network)
+BuildRequires:  pkgconfig(Qt5Test)
 BuildRequires:  pkgconfig(Qt5Gui)
 BuildRequires:  pkgconfig(Qt5Contacts)
 BuildRequires:  qt5-qttools-linguist
@@ -86,6 +87,13 @@ Summary:    Translation source for sociald
 %description ts-devel
 %{summary}.
 
+%package tests
+Summary:    Benchmarks for the social sync plugins
+Requires:   %{name} = %{version}-%{release}
+
+%description tests
+%{summary}.
+
 %prep
 %setup -q -n %{name}-%{version}
 
@@ -375,3 +383,7 @@ done
 
 %files ts-devel
 %{_datadir}/translations/source/lipstick-jolla-home-twitter-notif.ts
+
+%files tests
+%dir /opt/tests/buteo-sync-plugins-social
+/opt/tests/buteo-sync-plugins-social/benchmarks
@@ -0,0 +1,173 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "accesstokenbroker_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSettings>
+#include <QtCore/QStringList>
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+    // a token must stay valid for this long to be served, to last through a sync.
+    const int MinimumValidity = 10 * 60; // secs
+
+    const QString TokenKey = QStringLiteral("token");
+    const QString ExpiryKey = QStringLiteral("expiry");
+
+    qint64 currentSecs()
+    {
+        return QDateTime::currentMSecsSinceEpoch() / 1000;
+    }
+
+    // Creates the file readable by its owner only, before any token is
+    // written to it.  QSettings saves through a temporary file which takes
+    // the permissions of the existing file, so the tokens are never
+    // readable by others, not even while the store is being rewritten.
+    bool ensurePrivateFile(const QString &fileName)
+    {
+        QDir().mkpath(QFileInfo(fileName).absolutePath());
+        const QByteArray path = QFile::encodeName(fileName);
+        const int fd = open(path.constData(), O_RDONLY | O_CREAT | O_CLOEXEC | O_NOCTTY | O_NOFOLLOW, 0600);
+        if (fd < 0) {
+            qCWarning(lcSocialPlugin) << "unable to create access token store" << fileName << ":" << strerror(errno);
+            return false;
+        }
+        struct stat buf;
+        const bool ok = fstat(fd, &buf) == 0 && ((buf.st_mode & 0077) == 0 || fchmod(fd, 0600) == 0);
+        if (!ok) {
+            qCWarning(lcSocialPlugin) << "unable to restrict access token store" << fileName << ":" << strerror(errno);
+        }
+        close(fd);
+        return ok;
+    }
+}
+
+AccessTokenBroker *AccessTokenBroker::instance()
+{
+    static AccessTokenBroker broker;
+    return &broker;
+}
+
+AccessTokenBroker::AccessTokenBroker()
+{
+}
+
+QString AccessTokenBroker::storeFileName()
+{
+    return QString::fromLatin1("%1/%2/accesstokens.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+// The scope is hashed, so that it can be used as a settings key.
+QString AccessTokenBroker::scope(const QString &mechanism, const QVariantMap &sessionParameters)
+{
+    const QVariant scopes = sessionParameters.value(QStringLiteral("Scope"));
+    QStringList parts;
+    parts << mechanism
+          << sessionParameters.value(QStringLiteral("ClientId")).toString()
+          << (scopes.type() == QVariant::StringList ? scopes.toStringList().join(QLatin1Char(' '))
+                                                     : scopes.toString());
+    return QString::fromLatin1(QCryptographicHash::hash(parts.join(QLatin1Char('\n')).toUtf8(),
+                                                        QCryptographicHash::Sha1).toHex().left(16));
+}
+
+QString AccessTokenBroker::token(int accountId, const QString &scope)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 validUntil = currentSecs() + MinimumValidity;
+
+    Token cached = m_tokens.value(accountId).value(scope);
+    if (cached.value.isEmpty() || cached.expiry < validUntil) {
+        // another sync plugin process may have signed in.
+        QSettings store(storeFileName(), QSettings::IniFormat);
+        store.beginGroup(QString::number(accountId));
+        store.beginGroup(scope);
+        cached.value = store.value(TokenKey).toString();
+        cached.expiry = store.value(ExpiryKey, 0).toLongLong();
+        if (cached.value.isEmpty() || cached.expiry < validUntil) {
+            return QString();
+        }
+        m_tokens[accountId].insert(scope, cached);
+    }
+
+    qCDebug(lcSocialPlugin) << "using access token of account" << accountId << "valid for"
+                            << cached.expiry - currentSecs() << "secs";
+    return cached.value;
+}
+
+void AccessTokenBroker::insert(int accountId, const QString &scope, const QString &token, int expiresIn)
+{
+    // tokens without an expiry time (or about to expire) are always requested from signond.
+    if (token.isEmpty() || expiresIn <= MinimumValidity) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Token entry;
+    entry.value = token;
+    entry.expiry = currentSecs() + expiresIn;
+    m_tokens[accountId].insert(scope, entry);
+
+    // other processes can't share the token then, but it is still used by this one.
+    const QString fileName = storeFileName();
+    if (!ensurePrivateFile(fileName)) {
+        return;
+    }
+
+    QSettings store(fileName, QSettings::IniFormat);
+    store.beginGroup(QString::number(accountId));
+    store.beginGroup(scope);
+    store.setValue(TokenKey, entry.value);
+    store.setValue(ExpiryKey, entry.expiry);
+    store.endGroup();
+    store.endGroup();
+    store.sync();
+}
+
+void AccessTokenBroker::invalidate(int accountId)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_tokens.remove(accountId) > 0) {
+        qCInfo(lcSocialPlugin) << "invalidating access tokens of account" << accountId;
+    }
+    removeAccount(accountId);
+}
+
+void AccessTokenBroker::removeAccount(int accountId)
+{
+    QSettings store(storeFileName(), QSettings::IniFormat);
+    store.remove(QString::number(accountId));
+    store.sync();
+}
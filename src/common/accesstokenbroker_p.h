@@ -0,0 +1,71 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_ACCESSTOKENBROKER_P_H
+#define SOCIALD_ACCESSTOKENBROKER_P_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+/*
+    Shares the OAuth2 access tokens of an account between its data types,
+    so that e.g. the calendars, contacts and signon syncs of a Google
+    account don't each request a token from signond within seconds of
+    each other.
+
+    Tokens are keyed on the account and a scope, which identifies the
+    signon mechanism, client and requested permissions, as the services
+    of an account may ask for different permissions.  They are kept in
+    memory and in a store in the sync database directory shared by the
+    sync plugin processes, and only served while they remain valid for
+    a while longer, so that a token doesn't expire during the sync.
+    Tokens rejected by the server must be invalidated.
+*/
+class AccessTokenBroker
+{
+public:
+    static AccessTokenBroker *instance();
+
+    static QString scope(const QString &mechanism, const QVariantMap &sessionParameters);
+
+    // Returns a valid token for the scope, or an empty string.
+    QString token(int accountId, const QString &scope);
+    void insert(int accountId, const QString &scope, const QString &token, int expiresIn);
+    void invalidate(int accountId);
+
+    static void removeAccount(int accountId);
+
+private:
+    struct Token {
+        QString value;
+        qint64 expiry;  // secs since epoch
+    };
+
+    AccessTokenBroker();
+    static QString storeFileName();
+
+    QMutex m_mutex;
+    QHash<int, QHash<QString, Token> > m_tokens;
+};
+
+#endif // SOCIALD_ACCESSTOKENBROKER_P_H
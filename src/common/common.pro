@@ -6,23 +6,62 @@ QT += network dbus
 CONFIG += link_pkgconfig
 PKGCONFIG += \
     accounts-qt5 \
+    libsailfishkeyprovider \
     buteosyncfw5 \
     socialcache \
 
+DEFINES += 'SYNC_DATABASE_DIR=\'\"Sync\"\''
+
 TARGET = syncpluginscommon
 TARGET = $$qtLibraryTarget($$TARGET)
 
 HEADERS += \
+    $$PWD/accesstokenbroker_p.h \
     $$PWD/buteosyncfw_p.h \
     $$PWD/socialdbuteoplugin.h \
     $$PWD/socialnetworksyncadaptor.h \
     $$PWD/socialdnetworkaccessmanager_p.h \
+    $$PWD/replydeadlinescheduler_p.h \
+    $$PWD/hostlatencyestimator_p.h \
+    $$PWD/imagecachepurger_p.h \
+    $$PWD/keyprovidercache_p.h \
+    $$PWD/networkrequestmetrics_p.h \
+    $$PWD/memoryusagemonitor_p.h \
+    $$PWD/flightrecorder_p.h \
+    $$PWD/networkcostpolicy_p.h \
+    $$PWD/jsonstreamreader_p.h \
+    $$PWD/replaynetworkaccessmanager_p.h \
+    $$PWD/proxyreply_p.h \
+    $$PWD/retryingreply_p.h \
+    $$PWD/requestratelimiter_p.h \
+    $$PWD/sharedslotscheduler_p.h \
+    $$PWD/synccheckpointstore_p.h \
+    $$PWD/syncprofileindex_p.h \
+    $$PWD/synctasktracker_p.h \
     $$PWD/trace.h
 
 SOURCES += \
+    $$PWD/accesstokenbroker_p.cpp \
     $$PWD/socialdbuteoplugin.cpp \
     $$PWD/socialnetworksyncadaptor.cpp \
     $$PWD/socialdnetworkaccessmanager_p.cpp \
+    $$PWD/replydeadlinescheduler_p.cpp \
+    $$PWD/hostlatencyestimator_p.cpp \
+    $$PWD/imagecachepurger_p.cpp \
+    $$PWD/keyprovidercache_p.cpp \
+    $$PWD/networkrequestmetrics_p.cpp \
+    $$PWD/memoryusagemonitor_p.cpp \
+    $$PWD/flightrecorder_p.cpp \
+    $$PWD/networkcostpolicy_p.cpp \
+    $$PWD/jsonstreamreader_p.cpp \
+    $$PWD/replaynetworkaccessmanager_p.cpp \
+    $$PWD/proxyreply_p.cpp \
+    $$PWD/retryingreply_p.cpp \
+    $$PWD/requestratelimiter_p.cpp \
+    $$PWD/sharedslotscheduler_p.cpp \
+    $$PWD/synccheckpointstore_p.cpp \
+    $$PWD/syncprofileindex_p.cpp \
+    $$PWD/synctasktracker_p.cpp \
     $$PWD/trace.cpp
 
 TARGETPATH = $$[QT_INSTALL_LIBS]
@@ -0,0 +1,384 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "flightrecorder_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QUrl>
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+    // path segments which look like identifiers are replaced in the recorded urls,
+    // so that the entries show which endpoint was requested, not for which object.
+    const int MaximumTemplateSegment = 24;
+
+    const int CrashSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+    const int CrashSignalCount = sizeof(CrashSignals) / sizeof(CrashSignals[0]);
+    struct sigaction previousActions[CrashSignalCount];
+
+    // the crash dump file and header are formatted in advance, the signal handler
+    // only uses async-signal-safe functions.
+    char crashPath[1024];
+    char crashHeader[256];
+    FlightRecorder *crashRecorder = 0;
+
+    class LineBuffer
+    {
+    public:
+        LineBuffer() : m_size(0) {}
+
+        void append(const char *text)
+        {
+            while (*text && m_size < int(sizeof(m_data)) - 1) {
+                m_data[m_size++] = *text++;
+            }
+        }
+
+        void append(const char *label, qint64 value)
+        {
+            char digits[24];
+            int count = 0;
+            quint64 magnitude = value < 0 ? quint64(-(value + 1)) + 1 : quint64(value);
+            do {
+                digits[count++] = char('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude > 0);
+            if (value < 0) {
+                digits[count++] = '-';
+            }
+
+            append(label);
+            while (count > 0 && m_size < int(sizeof(m_data)) - 1) {
+                m_data[m_size++] = digits[--count];
+            }
+        }
+
+        void write(int fd)
+        {
+            append("\n");
+            const char *data = m_data;
+            int remaining = m_size;
+            while (remaining > 0) {
+                const ssize_t written = ::write(fd, data, remaining);
+                if (written <= 0) {
+                    break;
+                }
+                data += written;
+                remaining -= written;
+            }
+            m_size = 0;
+        }
+
+    private:
+        char m_data[512];
+        int m_size;
+    };
+
+    void copyText(char *destination, int size, const char *source, int length)
+    {
+        const int count = qMin(length, size - 1);
+        memcpy(destination, source, count);
+        destination[count] = '\0';
+    }
+
+    qint32 clampMsecs(qint64 msecs)
+    {
+        return qint32(qBound<qint64>(-1, msecs, INT_MAX));
+    }
+}
+
+FlightRecorder *FlightRecorder::instance()
+{
+    static FlightRecorder recorder;
+    return &recorder;
+}
+
+FlightRecorder::FlightRecorder()
+    : m_next(0)
+{
+    for (int i = 0; i < Capacity; ++i) {
+        m_entries[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+QString FlightRecorder::dumpDirectory()
+{
+    return QString::fromLatin1("%1/%2/flightrecorder")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+FlightRecorder::Entry *FlightRecorder::claim(quint64 *index)
+{
+    *index = m_next.fetch_add(1, std::memory_order_relaxed);
+    Entry *entry = &m_entries[*index % Capacity];
+    entry->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry->timestamp = QDateTime::currentMSecsSinceEpoch();
+    return entry;
+}
+
+void FlightRecorder::publish(Entry *entry, quint64 index)
+{
+    entry->sequence.store(index + 1, std::memory_order_release);
+}
+
+void FlightRecorder::recordRequest(int accountId, const QUrl &url, int httpStatus, int networkError, int retries,
+                                   qint64 bytesSent, qint64 bytesReceived, qint64 headerMsecs, qint64 totalMsecs)
+{
+    // host and path only: queries carry access tokens and user data.
+    const QByteArray encoded = url.toEncoded(QUrl::RemoveScheme | QUrl::RemoveUserInfo
+                                             | QUrl::RemoveQuery | QUrl::RemoveFragment);
+    char text[TextSize];
+    int size = 0;
+    int start = encoded.startsWith("//") ? 2 : 0;
+    bool host = start > 0;
+    while (start < encoded.size() && size < TextSize - 1) {
+        int end = encoded.indexOf('/', start + 1);
+        if (end < 0) {
+            end = encoded.size();
+        }
+        const char *segment = encoded.constData() + start;
+        int length = end - start;
+        bool identifier = !host && length - 1 > MaximumTemplateSegment;
+        for (int i = 0; !host && !identifier && i < length; ++i) {
+            identifier = segment[i] >= '0' && segment[i] <= '9';
+        }
+        if (identifier) {
+            segment = "/*";
+            length = 2;
+        }
+        length = qMin(length, TextSize - 1 - size);
+        memcpy(text + size, segment, length);
+        size += length;
+        start = end;
+        host = false;
+    }
+    text[size] = '\0';
+
+    quint64 index = 0;
+    Entry *entry = claim(&index);
+    entry->kind = Request;
+    entry->accountId = accountId;
+    entry->status = httpStatus;
+    entry->error = networkError;
+    entry->retries = retries;
+    entry->bytesSent = bytesSent;
+    entry->bytesReceived = bytesReceived;
+    entry->headerMsecs = clampMsecs(headerMsecs);
+    entry->totalMsecs = clampMsecs(totalMsecs);
+    copyText(entry->text, TextSize, text, size);
+    publish(entry, index);
+}
+
+void FlightRecorder::recordStatus(int accountId, int status, const char *name)
+{
+    quint64 index = 0;
+    Entry *entry = claim(&index);
+    entry->kind = Status;
+    entry->accountId = accountId;
+    entry->status = status;
+    entry->error = 0;
+    entry->retries = 0;
+    entry->bytesSent = 0;
+    entry->bytesReceived = 0;
+    entry->headerMsecs = -1;
+    entry->totalMsecs = -1;
+    copyText(entry->text, TextSize, name, int(strlen(name)));
+    publish(entry, index);
+}
+
+void FlightRecorder::recordEvent(int accountId, const char *event)
+{
+    quint64 index = 0;
+    Entry *entry = claim(&index);
+    entry->kind = Event;
+    entry->accountId = accountId;
+    entry->status = 0;
+    entry->error = 0;
+    entry->retries = 0;
+    entry->bytesSent = 0;
+    entry->bytesReceived = 0;
+    entry->headerMsecs = -1;
+    entry->totalMsecs = -1;
+    copyText(entry->text, TextSize, event, int(strlen(event)));
+    publish(entry, index);
+}
+
+void FlightRecorder::writeEntries(int fd, const char *header, const char *reason) const
+{
+    LineBuffer line;
+    line.append("# ");
+    line.append(header);
+    line.append(" reason=");
+    line.append(reason);
+    line.write(fd);
+
+    const quint64 next = m_next.load(std::memory_order_acquire);
+    for (quint64 index = next > quint64(Capacity) ? next - Capacity : 0; index < next; ++index) {
+        const Entry &slot(m_entries[index % Capacity]);
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+
+        Entry entry;
+        entry.timestamp = slot.timestamp;
+        entry.bytesSent = slot.bytesSent;
+        entry.bytesReceived = slot.bytesReceived;
+        entry.kind = slot.kind;
+        entry.accountId = slot.accountId;
+        entry.status = slot.status;
+        entry.error = slot.error;
+        entry.retries = slot.retries;
+        entry.headerMsecs = slot.headerMsecs;
+        entry.totalMsecs = slot.totalMsecs;
+        memcpy(entry.text, slot.text, TextSize);
+        entry.text[TextSize - 1] = '\0';
+
+        // the slot was overwritten while it was being copied.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+            continue;
+        }
+
+        line.append("", entry.timestamp);
+        line.append(" account=", entry.accountId);
+        switch (entry.kind) {
+        case Request:
+            line.append(" request ");
+            line.append(entry.text);
+            line.append(" http=", entry.status);
+            line.append(" error=", entry.error);
+            line.append(" retries=", entry.retries);
+            line.append(" sent=", entry.bytesSent);
+            line.append(" received=", entry.bytesReceived);
+            line.append(" headers=", entry.headerMsecs);
+            line.append(" total=", entry.totalMsecs);
+            break;
+        case Status:
+            line.append(" status ");
+            line.append(entry.text);
+            break;
+        default:
+            line.append(" event ");
+            line.append(entry.text);
+            break;
+        }
+        line.write(fd);
+    }
+}
+
+void FlightRecorder::dump(const QString &serviceName, const QString &dataType, const char *reason)
+{
+    const QString directory = dumpDirectory();
+    if (!QDir().mkpath(directory)) {
+        qCWarning(lcSocialPlugin) << "unable to create flight recorder directory" << directory;
+        return;
+    }
+
+    // the requests are as private as in the crash dump, and dumps of older
+    // versions may still be readable by others.
+    const QString fileName = QString::fromLatin1("%1/%2.%3.log").arg(directory, serviceName, dataType);
+    const int fd = ::open(QFile::encodeName(fileName).constData(),
+                          O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0 || ::fchmod(fd, 0600) != 0) {
+        qCWarning(lcSocialPlugin) << "unable to write flight recorder dump to" << fileName << ":" << strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+
+    const QByteArray header = QString::fromLatin1("%1 %2 pid=%3 time=%4")
+            .arg(serviceName, dataType)
+            .arg(QCoreApplication::applicationPid())
+            .arg(QDateTime::currentMSecsSinceEpoch()).toUtf8();
+    writeEntries(fd, header.constData(), reason);
+    ::close(fd);
+
+    qCInfo(lcSocialPlugin) << "recent requests of" << serviceName << dataType << "written to" << fileName;
+}
+
+void FlightRecorder::installCrashHandler(const QString &serviceName, const QString &dataType)
+{
+    const QString directory = dumpDirectory();
+    QDir().mkpath(directory);
+
+    const QByteArray path = QFile::encodeName(QString::fromLatin1("%1/%2.%3-crash.log")
+                                              .arg(directory, serviceName, dataType));
+    const QByteArray header = QString::fromLatin1("%1 %2 pid=%3")
+            .arg(serviceName, dataType)
+            .arg(QCoreApplication::applicationPid()).toUtf8();
+    copyText(crashPath, sizeof(crashPath), path.constData(), path.size());
+    copyText(crashHeader, sizeof(crashHeader), header.constData(), header.size());
+
+    if (crashRecorder) {
+        return;
+    }
+    crashRecorder = this;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &FlightRecorder::crashHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+    for (int i = 0; i < CrashSignalCount; ++i) {
+        sigaction(CrashSignals[i], &action, &previousActions[i]);
+    }
+}
+
+void FlightRecorder::crashHandler(int signal)
+{
+    const int fd = ::open(crashPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd >= 0) {
+        char reason[16] = "signal ";
+        int length = 7;
+        if (signal >= 10) {
+            reason[length++] = char('0' + signal / 10 % 10);
+        }
+        reason[length++] = char('0' + signal % 10);
+        reason[length] = '\0';
+        crashRecorder->writeEntries(fd, crashHeader, reason);
+        ::close(fd);
+    }
+
+    // let the previous handler (or the default action) deal with the signal.
+    for (int i = 0; i < CrashSignalCount; ++i) {
+        if (CrashSignals[i] == signal) {
+            sigaction(signal, &previousActions[i], 0);
+            break;
+        }
+    }
+    raise(signal);
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_FLIGHTRECORDER_P_H
+#define SOCIALD_FLIGHTRECORDER_P_H
+
+#include <QtCore/QString>
+
+#include <atomic>
+
+class QUrl;
+
+/*
+    Records compact metadata of the most recent network requests and
+    adaptor events of the process in a fixed-size ring buffer, so that
+    failed or slow syncs can be diagnosed without enabling the trace
+    category.
+
+    Recording does not lock: each writer claims a slot with
+    an atomic counter and publishes it with a per-slot sequence number,
+    so that readers skip slots which are being overwritten.  The buffer
+    is written to the sync database directory by dump(), and also from
+    the crash signal handlers installed by installCrashHandler().
+*/
+class FlightRecorder
+{
+public:
+    enum Kind {
+        Request = 1,
+        Status,
+        Event
+    };
+
+    static FlightRecorder *instance();
+
+    void recordRequest(int accountId, const QUrl &url, int httpStatus, int networkError, int retries,
+                       qint64 bytesSent, qint64 bytesReceived, qint64 headerMsecs, qint64 totalMsecs);
+    void recordStatus(int accountId, int status, const char *name);
+    void recordEvent(int accountId, const char *event);
+
+    // Writes the recorded entries to <service>.<dataType>.log in the dump directory.
+    void dump(const QString &serviceName, const QString &dataType, const char *reason);
+
+    // Dumps the recorded entries to <service>.<dataType>-crash.log on fatal signals.
+    void installCrashHandler(const QString &serviceName, const QString &dataType);
+
+    static QString dumpDirectory();
+
+private:
+    FlightRecorder();
+
+    enum { Capacity = 256, TextSize = 96 };
+
+    struct Entry {
+        std::atomic<quint64> sequence;  // 0 while being written, otherwise index + 1
+        qint64 timestamp;
+        qint64 bytesSent;
+        qint64 bytesReceived;
+        qint32 kind;
+        qint32 accountId;
+        qint32 status;
+        qint32 error;
+        qint32 retries;
+        qint32 headerMsecs;
+        qint32 totalMsecs;
+        char text[TextSize];
+    };
+
+    Entry *claim(quint64 *index);
+    void publish(Entry *entry, quint64 index);
+    void writeEntries(int fd, const char *header, const char *reason) const;
+
+    static void crashHandler(int signal);
+
+    std::atomic<quint64> m_next;
+    Entry m_entries[Capacity];
+};
+
+#endif // SOCIALD_FLIGHTRECORDER_P_H
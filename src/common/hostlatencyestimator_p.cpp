@@ -0,0 +1,128 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "hostlatencyestimator_p.h"
+#include "buteosyncfw_p.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtCore/QStringList>
+
+#include <cmath>
+
+namespace {
+    // the response headers must arrive within this multiple of the
+    // estimated latency (plus four deviations).
+    const int LatencyMultiplier = 3;
+
+    // estimates which are based on fewer samples are not trusted.
+    const int MinimumSamples = 3;
+}
+
+HostLatencyEstimator::HostLatencyEstimator()
+    : m_loaded(false)
+    , m_dirty(false)
+{
+}
+
+HostLatencyEstimator *HostLatencyEstimator::instance()
+{
+    static HostLatencyEstimator estimator;
+    return &estimator;
+}
+
+QString HostLatencyEstimator::fileName()
+{
+    return QString::fromLatin1("%1/%2/hostlatency.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+void HostLatencyEstimator::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    QSettings settings(fileName(), QSettings::IniFormat);
+    Q_FOREACH (const QString &host, settings.childGroups()) {
+        settings.beginGroup(host);
+        Estimate estimate;
+        estimate.smoothed = settings.value(QStringLiteral("smoothed")).toDouble();
+        estimate.deviation = settings.value(QStringLiteral("deviation")).toDouble();
+        estimate.samples = settings.value(QStringLiteral("samples")).toInt();
+        settings.endGroup();
+        if (estimate.samples > 0) {
+            m_estimates.insert(host, estimate);
+        }
+    }
+}
+
+void HostLatencyEstimator::addSample(const QString &host, qint64 msecs)
+{
+    if (host.isEmpty() || msecs < 0) {
+        return;
+    }
+
+    ensureLoaded();
+    Estimate &estimate(m_estimates[host.toLower()]);
+    if (estimate.samples == 0) {
+        estimate.smoothed = msecs;
+        estimate.deviation = msecs / 2.0;
+    } else {
+        estimate.deviation = 0.75 * estimate.deviation + 0.25 * std::fabs(estimate.smoothed - msecs);
+        estimate.smoothed = 0.875 * estimate.smoothed + 0.125 * msecs;
+    }
+    estimate.samples = qMin(estimate.samples + 1, 1000);
+    m_dirty = true;
+}
+
+int HostLatencyEstimator::firstByteTimeout(const QString &host, int minimumMsecs, int maximumMsecs)
+{
+    ensureLoaded();
+    QHash<QString, Estimate>::const_iterator it = m_estimates.constFind(host.toLower());
+    if (it == m_estimates.constEnd() || it->samples < MinimumSamples) {
+        return maximumMsecs;
+    }
+
+    const double timeout = LatencyMultiplier * (it->smoothed + 4 * it->deviation);
+    return qBound(qMin(minimumMsecs, maximumMsecs), static_cast<int>(qMin(timeout, 1e9)), maximumMsecs);
+}
+
+void HostLatencyEstimator::save()
+{
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    QDir().mkpath(QFileInfo(fileName()).absolutePath());
+    QSettings settings(fileName(), QSettings::IniFormat);
+    for (QHash<QString, Estimate>::const_iterator it = m_estimates.constBegin(); it != m_estimates.constEnd(); ++it) {
+        settings.beginGroup(it.key());
+        settings.setValue(QStringLiteral("smoothed"), it->smoothed);
+        settings.setValue(QStringLiteral("deviation"), it->deviation);
+        settings.setValue(QStringLiteral("samples"), it->samples);
+        settings.endGroup();
+    }
+    settings.sync();
+}
@@ -0,0 +1,68 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_HOSTLATENCYESTIMATOR_P_H
+#define SOCIALD_HOSTLATENCYESTIMATOR_P_H
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+/*
+    Estimates the time until the response headers arrive for the
+    requests to each host, as a smoothed mean and mean deviation of
+    the observed latencies (as for the TCP retransmission timeout).
+
+    The estimates are shared by all adaptors of the process, and are
+    stored in the sync database directory so that each sync starts
+    from the history of the previous ones.
+*/
+class HostLatencyEstimator
+{
+public:
+    static HostLatencyEstimator *instance();
+
+    void addSample(const QString &host, qint64 msecs);
+
+    // Returns the time to wait for the response headers of a request to the
+    // host, between minimumMsecs and maximumMsecs, or maximumMsecs if there
+    // is no history for the host.
+    int firstByteTimeout(const QString &host, int minimumMsecs, int maximumMsecs);
+
+    void save();
+
+private:
+    HostLatencyEstimator();
+
+    struct Estimate {
+        Estimate() : smoothed(0), deviation(0), samples(0) {}
+        double smoothed;
+        double deviation;
+        int samples;
+    };
+
+    void ensureLoaded();
+    static QString fileName();
+
+    QHash<QString, Estimate> m_estimates;
+    bool m_loaded;
+    bool m_dirty;
+};
+
+#endif // SOCIALD_HOSTLATENCYESTIMATOR_P_H
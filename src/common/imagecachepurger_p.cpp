@@ -0,0 +1,329 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "imagecachepurger_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QSettings>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const int BatchSize = 256;          // files unlinked between interruption checks
+    const int CommitInterval = 500;     // msec
+
+    // evict down to this share of the budget, so that every sync doesn't evict a few images.
+    const double EvictionLowWatermark = 0.9;
+    const int MaximumEvictionsPerRun = 2000;
+
+    // the budget of the cache, unless set by budgetMiB in imagecache.ini
+    const qint64 DefaultBudget = Q_INT64_C(256) * 1024 * 1024;
+
+    struct CachedFile {
+        qint64 lastUsed;    // secs since epoch
+        qint64 size;
+        int index;
+
+        bool operator<(const CachedFile &other) const { return lastUsed < other.lastUsed; }
+    };
+}
+
+class ImageCachePurger::Job : public QRunnable
+{
+public:
+    // removes all of the images
+    Job(ImageCachePurger *purger, const QList<SocialImage::ConstPtr> &images, bool interruptible, int generation)
+        : m_purger(purger), m_images(images), m_interruptible(interruptible)
+        , m_budget(-1), m_generation(generation)
+    {
+    }
+
+    // evicts the images of the accounts down to the budget
+    Job(ImageCachePurger *purger, const QList<int> &accountIds, qint64 budget, int generation)
+        : m_purger(purger), m_accountIds(accountIds), m_interruptible(true)
+        , m_budget(budget), m_generation(generation)
+    {
+    }
+
+    void run() override
+    {
+        if (m_budget < 0) {
+            m_purger->removeFiles(m_images, m_interruptible, m_generation);
+        } else {
+            m_purger->evictFiles(m_accountIds, m_budget, m_generation);
+        }
+        QMetaObject::invokeMethod(m_purger, "jobFinished", Qt::QueuedConnection);
+    }
+
+private:
+    ImageCachePurger *m_purger;
+    QList<SocialImage::ConstPtr> m_images;
+    QList<int> m_accountIds;
+    bool m_interruptible;
+    qint64 m_budget;
+    int m_generation;
+};
+
+ImageCachePurger::ImageCachePurger(QObject *parent)
+    : QObject(parent)
+    , m_commitTimer(new QTimer(this))
+    , m_runningJobs(0)
+{
+    // one job at a time, the purges are not urgent.
+    m_pool.setMaxThreadCount(1);
+    m_commitTimer->setInterval(CommitInterval);
+    connect(m_commitTimer, &QTimer::timeout, this, &ImageCachePurger::commitRemovedImages);
+}
+
+ImageCachePurger::~ImageCachePurger()
+{
+    // the sync results have already been reported, finish the queued purges.
+    m_pool.waitForDone();
+    commitRemovedImages();
+    m_database.wait();
+}
+
+void ImageCachePurger::purge(const QList<SocialImage::ConstPtr> &images, bool interruptible)
+{
+    if (images.isEmpty()) {
+        return;
+    }
+
+    qCDebug(lcSocialPlugin) << "purging" << images.size() << "cached images in the background";
+    m_runningJobs += 1;
+    m_commitTimer->start();
+    m_pool.start(new Job(this, images, interruptible, m_generation.loadAcquire()));
+}
+
+// Removes the least recently used images of the accounts until they fit in the budget.
+void ImageCachePurger::evict(const QList<int> &accountIds, qint64 budgetBytes)
+{
+    if (accountIds.isEmpty() || budgetBytes < 0) {
+        return;
+    }
+
+    m_runningJobs += 1;
+    m_commitTimer->start();
+    m_pool.start(new Job(this, accountIds, budgetBytes, m_generation.loadAcquire()));
+}
+
+/*
+    Returns the byte budget of the image cache.  The cache is shared by
+    all services and accounts, so the budget is a single global setting,
+    the budgetMiB key of imagecache.ini in the sync database directory.
+*/
+qint64 ImageCachePurger::budget()
+{
+    QSettings settings(statisticsFileName(), QSettings::IniFormat);
+    bool ok = false;
+    const int budgetMiB = settings.value(QStringLiteral("budgetMiB")).toInt(&ok);
+    return ok && budgetMiB > 0 ? qint64(budgetMiB) * 1024 * 1024 : DefaultBudget;
+}
+
+QString ImageCachePurger::statisticsFileName()
+{
+    return QString::fromLatin1("%1/%2/imagecache.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+// Stops the interruptible purges after their current batch.
+void ImageCachePurger::interrupt()
+{
+    m_generation.fetchAndAddOrdered(1);
+}
+
+bool ImageCachePurger::isRunning() const
+{
+    return m_runningJobs > 0;
+}
+
+void ImageCachePurger::removeFiles(const QList<SocialImage::ConstPtr> &images, bool interruptible, int generation)
+{
+    for (int start = 0; start < images.size(); start += BatchSize) {
+        if (interruptible && m_generation.loadAcquire() != generation) {
+            qCDebug(lcSocialPlugin) << "image cache purge interrupted," << images.size() - start << "images left";
+            return;
+        }
+
+        // group the batch by directory, so that each directory is only resolved once.
+        const QList<SocialImage::ConstPtr> batch = images.mid(start, BatchSize);
+        QMap<QString, QList<int> > directories;
+        for (int i = 0; i < batch.size(); ++i) {
+            directories[QFileInfo(batch.at(i)->imageFile()).absolutePath()].append(i);
+        }
+
+        QList<SocialImage::ConstPtr> removed;
+        for (QMap<QString, QList<int> >::const_iterator it = directories.constBegin(); it != directories.constEnd(); ++it) {
+            const int directory = ::open(QFile::encodeName(it.key()).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (directory < 0 && errno != ENOENT) {
+                qCWarning(lcSocialPlugin) << "unable to open image cache directory" << it.key() << ":" << strerror(errno);
+                continue;
+            }
+            Q_FOREACH (int index, it.value()) {
+                const SocialImage::ConstPtr &image(batch.at(index));
+                const QByteArray fileName = QFile::encodeName(QFileInfo(image->imageFile()).fileName());
+                // a missing directory or file has nothing left to remove.
+                if (directory < 0 || fileName.isEmpty()
+                        || ::unlinkat(directory, fileName.constData(), 0) == 0 || errno == ENOENT) {
+                    removed.append(image);
+                } else {
+                    qCWarning(lcSocialPlugin) << "unable to remove cached image" << image->imageFile()
+                                              << ":" << strerror(errno);
+                }
+            }
+            if (directory >= 0) {
+                ::close(directory);
+            }
+        }
+
+        QMutexLocker locker(&m_removedMutex);
+        m_removed.append(removed);
+    }
+}
+
+void ImageCachePurger::evictFiles(const QList<int> &accountIds, qint64 budgetBytes, int generation)
+{
+    // m_database belongs to the purger's thread, query with a connection of this one.
+    QList<SocialImage::ConstPtr> images;
+    {
+        SocialImagesDatabase database;
+        Q_FOREACH (int accountId, accountIds) {
+            if (m_generation.loadAcquire() != generation) {
+                qCDebug(lcSocialPlugin) << "image cache eviction interrupted while listing the images";
+                return;
+            }
+            database.queryImages(accountId);
+            database.wait();
+            images.append(database.images());
+        }
+    }
+
+    QSettings statistics(statisticsFileName(), QSettings::IniFormat);
+    const qint64 previousRun = statistics.value(QStringLiteral("lastRun"), 0).toLongLong();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    // the access time is only updated about once a day with relatime,
+    // which is precise enough to tell the recently viewed images apart.
+    // On a noatime mount it is never updated, so the files are ordered
+    // by when they were downloaded, and recentlyUsedFraction only counts
+    // the images downloaded since the previous run.
+    QVector<CachedFile> files;
+    files.reserve(images.size());
+    QList<SocialImage::ConstPtr> missing;
+    qint64 cachedBytes = 0;
+    int recentlyUsed = 0;
+    for (int i = 0; i < images.size(); ++i) {
+        struct stat info;
+        if (::stat(QFile::encodeName(images.at(i)->imageFile()).constData(), &info) != 0) {
+            if (errno == ENOENT) {
+                missing.append(images.at(i));
+            }
+            continue;
+        }
+        CachedFile file;
+        file.lastUsed = qMax<qint64>(info.st_atime, info.st_mtime);
+        file.size = qint64(info.st_blocks) * 512;
+        file.index = i;
+        files.append(file);
+        cachedBytes += file.size;
+        if (file.lastUsed > previousRun) {
+            recentlyUsed += 1;
+        }
+    }
+
+    QList<SocialImage::ConstPtr> evicted;
+    qint64 reclaimedBytes = 0;
+    if (cachedBytes > budgetBytes) {
+        std::sort(files.begin(), files.end());
+        const qint64 target = qint64(budgetBytes * EvictionLowWatermark);
+        for (int i = 0; i < files.size() && evicted.size() < MaximumEvictionsPerRun
+                && cachedBytes - reclaimedBytes > target; ++i) {
+            evicted.append(images.at(files.at(i).index));
+            reclaimedBytes += files.at(i).size;
+        }
+    }
+
+    qCInfo(lcSocialPlugin) << "image cache holds" << files.size() << "images in" << cachedBytes / 1024
+                           << "KiB of a budget of" << budgetBytes / 1024 << "KiB," << recentlyUsed
+                           << "used since the previous check; evicting" << evicted.size() << "images,"
+                           << reclaimedBytes / 1024 << "KiB";
+
+    // entries whose files are gone are removed from the database as well.
+    {
+        QMutexLocker locker(&m_removedMutex);
+        m_removed.append(missing);
+    }
+    removeFiles(evicted, true, generation);
+
+    statistics.setValue(QStringLiteral("lastRun"), now);
+    statistics.setValue(QStringLiteral("budgetBytes"), budgetBytes);
+    statistics.setValue(QStringLiteral("cachedImages"), files.size());
+    statistics.setValue(QStringLiteral("cachedBytes"), cachedBytes - reclaimedBytes);
+    statistics.remove(QStringLiteral("hitRate"));
+    statistics.setValue(QStringLiteral("recentlyUsedFraction"), files.isEmpty() ? 0.0 : double(recentlyUsed) / files.size());
+    statistics.setValue(QStringLiteral("evictedImages"), evicted.size());
+    statistics.setValue(QStringLiteral("reclaimedBytes"), reclaimedBytes);
+    statistics.setValue(QStringLiteral("totalReclaimedBytes"),
+                        statistics.value(QStringLiteral("totalReclaimedBytes"), 0).toLongLong() + reclaimedBytes);
+    QDir().mkpath(QFileInfo(statistics.fileName()).absolutePath());
+    statistics.sync();
+}
+
+void ImageCachePurger::jobFinished()
+{
+    m_runningJobs -= 1;
+    if (m_runningJobs == 0) {
+        m_commitTimer->stop();
+        commitRemovedImages();
+        emit finished();
+    }
+}
+
+void ImageCachePurger::commitRemovedImages()
+{
+    QList<SocialImage::ConstPtr> removed;
+    {
+        QMutexLocker locker(&m_removedMutex);
+        removed.swap(m_removed);
+    }
+
+    if (!removed.isEmpty()) {
+        m_database.removeImages(removed);
+        m_database.commit();
+    }
+}
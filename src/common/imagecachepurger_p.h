@@ -0,0 +1,101 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_IMAGECACHEPURGER_P_H
+#define SOCIALD_IMAGECACHEPURGER_P_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+
+#include <socialcache/socialimagesdatabase.h>
+
+class QTimer;
+
+/*
+    Removes cached images without blocking the event loop.
+
+    The image files are unlinked by a worker thread in batches, relative
+    to a descriptor of their directory, and the images whose files are
+    gone are removed from the image cache database in chunks, using a
+    database connection of the purger.
+
+    The cache can also be bounded by a byte budget shared by all services
+    and accounts (see budget()): evict() removes the least recently used
+    images until the cache fits in the budget again,
+    at most a limited number of images per run, so that a large cache is
+    brought within the budget over a few syncs.  The cached images of the
+    accounts are listed by the worker thread as well, with a database
+    connection of its own.  The size of the cache, the share of images
+    used since the previous run and the bytes reclaimed are stored in the
+    sync database directory.
+
+    The last use of an image is the later of the access and modification
+    times of its file.  On noatime mounts the access time is never updated,
+    so the eviction degrades to removing the oldest downloads first; with
+    relatime it is updated at most about once a day.
+
+    Purges of expired images and evictions can be interrupted, e.g. by a
+    new sync, leaving the remaining images in the database for a later
+    purge.  Purges of the images of removed accounts always run to
+    completion.  Queued purges are completed when the purger is destroyed.
+*/
+class ImageCachePurger : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageCachePurger(QObject *parent = nullptr);
+    ~ImageCachePurger();
+
+    void purge(const QList<SocialImage::ConstPtr> &images, bool interruptible);
+    void evict(const QList<int> &accountIds, qint64 budgetBytes);
+    void interrupt();
+    bool isRunning() const;
+
+    static qint64 budget();
+
+Q_SIGNALS:
+    void finished();
+
+private Q_SLOTS:
+    void jobFinished();
+    void commitRemovedImages();
+
+private:
+    class Job;
+
+    void removeFiles(const QList<SocialImage::ConstPtr> &images, bool interruptible, int generation);
+    void evictFiles(const QList<int> &accountIds, qint64 budgetBytes, int generation);
+    static QString statisticsFileName();
+
+    SocialImagesDatabase m_database;
+    QThreadPool m_pool;
+    QTimer *m_commitTimer;
+    QMutex m_removedMutex;
+    QList<SocialImage::ConstPtr> m_removed;
+    QAtomicInt m_generation;
+    int m_runningJobs;
+};
+
+#endif // SOCIALD_IMAGECACHEPURGER_P_H
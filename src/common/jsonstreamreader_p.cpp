@@ -0,0 +1,344 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "jsonstreamreader_p.h"
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonParseError>
+#include <QtNetwork/QNetworkReply>
+
+namespace {
+    inline bool isJsonSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+}
+
+JsonStreamReader::JsonStreamReader(QObject *parent)
+    : JsonStreamReader(QStringList(), false, parent)
+{
+}
+
+JsonStreamReader::JsonStreamReader(const QStringList &arrayKeys, bool streamTopLevelArray, QObject *parent)
+    : QObject(parent)
+    , m_arrayKeys(arrayKeys)
+    , m_streamTopLevelArray(streamTopLevelArray)
+    , m_streaming(streamTopLevelArray || !arrayKeys.isEmpty())
+    , m_depth(0)
+    , m_inString(false)
+    , m_escape(false)
+    , m_topLevelIsObject(false)
+    , m_expectKey(false)
+    , m_expectValue(false)
+    , m_capturingKey(false)
+    , m_streamDepth(0)
+    , m_inItem(false)
+    , m_itemCount(0)
+    , m_finished(false)
+    , m_error(false)
+{
+}
+
+JsonStreamReader::~JsonStreamReader()
+{
+}
+
+QStringList JsonStreamReader::defaultArrayKeys()
+{
+    return QStringList() << QStringLiteral("data")
+                         << QStringLiteral("items")
+                         << QStringLiteral("children")
+                         << QStringLiteral("entries")
+                         << QStringLiteral("value");
+}
+
+JsonStreamReader *JsonStreamReader::attach(QNetworkReply *reply, const QStringList &arrayKeys, bool streamTopLevelArray)
+{
+    JsonStreamReader *reader = new JsonStreamReader(arrayKeys, streamTopLevelArray, reply);
+    connect(reply, &QIODevice::readyRead, reader, &JsonStreamReader::replyReadyRead);
+    return reader;
+}
+
+JsonStreamReader *JsonStreamReader::fromReply(QNetworkReply *reply)
+{
+    return reply ? reply->findChild<JsonStreamReader*>(QString(), Qt::FindDirectChildrenOnly) : nullptr;
+}
+
+void JsonStreamReader::replyReadyRead()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(parent());
+    if (reply) {
+        addData(reply->readAll());
+    }
+}
+
+void JsonStreamReader::addData(const QByteArray &data)
+{
+    if (m_error || data.isEmpty()) {
+        return;
+    }
+
+    if (!m_streaming) {
+        m_envelope.append(data);
+        return;
+    }
+
+    scan(data);
+    if (!m_items.isEmpty()) {
+        emit itemsAvailable();
+    }
+}
+
+bool JsonStreamReader::finish()
+{
+    if (m_streaming && !m_finished) {
+        // the top-level value was truncated.
+        m_error = true;
+    }
+
+    if (!m_error) {
+        QJsonParseError parseError;
+        m_envelopeDocument = QJsonDocument::fromJson(m_envelope, &parseError);
+        m_error = parseError.error != QJsonParseError::NoError;
+    }
+
+    m_envelope.clear();
+    m_finished = true;
+    return !m_error;
+}
+
+bool JsonStreamReader::readNext()
+{
+    if (m_items.isEmpty()) {
+        m_current = QPair<QString, QJsonValue>();
+        return false;
+    }
+
+    m_current = m_items.dequeue();
+    return true;
+}
+
+QJsonValue JsonStreamReader::item() const
+{
+    return m_current.second;
+}
+
+QString JsonStreamReader::arrayKey() const
+{
+    return m_current.first;
+}
+
+int JsonStreamReader::itemCount() const
+{
+    return m_itemCount;
+}
+
+bool JsonStreamReader::isFinished() const
+{
+    return m_finished;
+}
+
+bool JsonStreamReader::hasError() const
+{
+    return m_error;
+}
+
+QJsonDocument JsonStreamReader::envelope() const
+{
+    return m_envelopeDocument;
+}
+
+void JsonStreamReader::scan(const QByteArray &data)
+{
+    const char *bytes = data.constData();
+    const int size = data.size();
+
+    for (int i = 0; i < size && !m_error; ++i) {
+        const char c = bytes[i];
+
+        if (m_finished) {
+            if (!isJsonSpace(c)) {
+                m_error = true; // trailing garbage after the top-level value
+            }
+            continue;
+        }
+
+        if (m_inString) {
+            if (m_inItem) {
+                m_item.append(c);
+            } else {
+                m_envelope.append(c);
+            }
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                if (m_capturingKey) {
+                    m_capturingKey = false;
+                    m_lastKey = m_key;
+                }
+                continue;
+            }
+            if (m_capturingKey) {
+                m_key.append(c);
+            }
+            continue;
+        }
+
+        if (m_streamDepth > 0 && !m_inItem && m_depth == m_streamDepth) {
+            // between the elements of a streamed array.
+            if (isJsonSpace(c) || c == ',') {
+                continue;
+            } else if (c == ']') {
+                finishArray();
+                continue;
+            }
+            beginItem();
+        }
+
+        if (m_inItem) {
+            if (m_depth == m_streamDepth && (c == ',' || c == ']')) {
+                // end of a scalar element.
+                finishItem();
+                if (c == ']') {
+                    finishArray();
+                }
+                continue;
+            }
+            m_item.append(c);
+            if (c == '"') {
+                m_inString = true;
+            } else if (c == '{' || c == '[') {
+                ++m_depth;
+            } else if (c == '}' || c == ']') {
+                --m_depth;
+                if (m_depth == m_streamDepth) {
+                    finishItem();
+                }
+            }
+            continue;
+        }
+
+        // everything else is part of the envelope.
+        if (isJsonSpace(c)) {
+            continue;
+        }
+        m_envelope.append(c);
+
+        const bool valueStart = m_depth == 1 && m_expectValue;
+        if (m_depth == 1) {
+            m_expectValue = false;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            if (m_depth == 1 && m_topLevelIsObject && m_expectKey) {
+                m_expectKey = false;
+                m_capturingKey = true;
+                m_key.clear();
+            }
+            break;
+        case ':':
+            if (m_depth == 1) {
+                m_expectValue = true;
+            }
+            break;
+        case ',':
+            if (m_depth == 1 && m_topLevelIsObject) {
+                m_expectKey = true;
+            }
+            break;
+        case '{':
+        case '[':
+            ++m_depth;
+            if (m_depth == 1) {
+                m_topLevelIsObject = c == '{';
+                m_expectKey = m_topLevelIsObject;
+                if (c == '[' && m_streamTopLevelArray) {
+                    m_streamDepth = 1;
+                    m_currentArrayKey.clear();
+                }
+            } else if (m_depth == 2 && c == '[' && valueStart
+                       && m_arrayKeys.contains(QString::fromUtf8(m_lastKey))) {
+                m_streamDepth = 2;
+                m_currentArrayKey = QString::fromUtf8(m_lastKey);
+            }
+            break;
+        case '}':
+        case ']':
+            --m_depth;
+            if (m_depth == 0) {
+                m_finished = true;
+            } else if (m_depth < 0) {
+                m_error = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void JsonStreamReader::beginItem()
+{
+    m_inItem = true;
+    m_item.clear();
+}
+
+void JsonStreamReader::finishItem()
+{
+    m_inItem = false;
+
+    QJsonParseError parseError;
+    QJsonValue value;
+    if (m_item.startsWith('{') || m_item.startsWith('[')) {
+        const QJsonDocument document = QJsonDocument::fromJson(m_item, &parseError);
+        value = document.isObject() ? QJsonValue(document.object()) : QJsonValue(document.array());
+    } else {
+        // QJsonDocument only parses objects and arrays, so wrap scalar elements.
+        const QJsonDocument document = QJsonDocument::fromJson('[' + m_item + ']', &parseError);
+        value = document.array().at(0);
+    }
+    m_item.clear();
+
+    if (parseError.error != QJsonParseError::NoError) {
+        m_error = true;
+        return;
+    }
+
+    m_items.enqueue(qMakePair(m_currentArrayKey, value));
+    m_itemCount += 1;
+}
+
+void JsonStreamReader::finishArray()
+{
+    // the envelope keeps the (now empty) array.
+    m_envelope.append(']');
+    --m_depth;
+    m_streamDepth = 0;
+    m_currentArrayKey.clear();
+    if (m_depth == 0) {
+        m_finished = true;
+    }
+}
@@ -0,0 +1,125 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_JSONSTREAMREADER_P_H
+#define SOCIALD_JSONSTREAMREADER_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonValue>
+#include <QtCore/QQueue>
+#include <QtCore/QPair>
+
+class QNetworkReply;
+
+/*
+    Incremental JSON reader for paged API responses.
+
+    Data can be fed to the reader in arbitrary chunks as it arrives.
+    The elements of the top-level array, or of any array which is the
+    value of one of the given keys of the top-level object (e.g. the
+    "data" array of a Facebook Graph API response), are parsed one at
+    a time as soon as they are complete, and can then be pulled with
+    readNext() and item().  The raw bytes of an element are discarded
+    once it has been parsed, so neither the whole reply body nor a
+    document of the whole reply need to be kept in memory.
+
+    Everything else is collected into the envelope() document, with
+    the streamed arrays left empty.
+
+    If no array keys are given (and the top-level array is not
+    streamed), the reader simply buffers the data and parses it in
+    one go in finish().
+*/
+class JsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JsonStreamReader(QObject *parent = nullptr);
+    JsonStreamReader(const QStringList &arrayKeys, bool streamTopLevelArray, QObject *parent = nullptr);
+    ~JsonStreamReader();
+
+    static QStringList defaultArrayKeys();
+
+    // Creates a reader owned by the reply, which is fed whenever the reply emits readyRead().
+    static JsonStreamReader *attach(QNetworkReply *reply,
+                                    const QStringList &arrayKeys = defaultArrayKeys(),
+                                    bool streamTopLevelArray = true);
+    static JsonStreamReader *fromReply(QNetworkReply *reply);
+
+    void addData(const QByteArray &data);
+    bool finish();
+
+    bool readNext();
+    QJsonValue item() const;
+    QString arrayKey() const;
+    int itemCount() const;
+
+    bool isFinished() const;
+    bool hasError() const;
+    QJsonDocument envelope() const;
+
+Q_SIGNALS:
+    void itemsAvailable();
+
+private Q_SLOTS:
+    void replyReadyRead();
+
+private:
+    void scan(const QByteArray &data);
+    void beginItem();
+    void finishItem();
+    void finishArray();
+
+    QStringList m_arrayKeys;
+    bool m_streamTopLevelArray;
+    bool m_streaming;
+
+    // tokenizer state
+    int m_depth;
+    bool m_inString;
+    bool m_escape;
+    bool m_topLevelIsObject;
+    bool m_expectKey;
+    bool m_expectValue;
+    bool m_capturingKey;
+    QByteArray m_key;
+    QByteArray m_lastKey;
+
+    // streamed array state
+    int m_streamDepth;
+    bool m_inItem;
+    QString m_currentArrayKey;
+    QByteArray m_item;
+
+    QByteArray m_envelope;
+    QJsonDocument m_envelopeDocument;
+    QQueue<QPair<QString, QJsonValue> > m_items;
+    QPair<QString, QJsonValue> m_current;
+    int m_itemCount;
+    bool m_finished;
+    bool m_error;
+};
+
+#endif // SOCIALD_JSONSTREAMREADER_P_H
@@ -0,0 +1,67 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "keyprovidercache_p.h"
+#include "trace.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+// libsailfishkeyprovider
+#include <sailfishkeyprovider.h>
+
+#include <stdlib.h>
+
+QString KeyProviderCache::storedKey(const char *provider, const char *service, const char *keyName)
+{
+    static QMutex mutex;
+    static QHash<QByteArray, QString> keys;
+
+    const QByteArray id = QByteArray(provider) + '/' + service + '/' + keyName;
+    QMutexLocker locker(&mutex);
+    QHash<QByteArray, QString>::const_iterator it = keys.constFind(id);
+    if (it != keys.constEnd()) {
+        return *it;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    char *cKey = NULL;
+    const int success = SailfishKeyProvider_storedKey(provider, service, keyName, &cKey);
+    QString key;
+    if (success == 0 && cKey != NULL) {
+        key = QLatin1String(cKey);
+    }
+    free(cKey);
+
+    if (key.isEmpty()) {
+        // don't remember the failure, the key may be available next time.
+        qCInfo(lcSocialPlugin) << "no valid" << keyName << "found for" << provider;
+        return key;
+    }
+
+    qCDebug(lcSocialPlugin) << "loaded" << id << "from keyprovider in" << timer.elapsed() << "msec";
+    keys.insert(id, key);
+    return key;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_KEYPROVIDERCACHE_P_H
+#define SOCIALD_KEYPROVIDERCACHE_P_H
+
+#include <QtCore/QString>
+
+/*
+    Caches the client ids and secrets stored by libsailfishkeyprovider.
+
+    Looking up a key decrypts the key store, so each key is loaded at most
+    once per process, on first use, and then shared by every sync adaptor
+    of the process.  Keys which couldn't be loaded aren't cached, so that
+    the next sync looks them up again, e.g. once the key store has been
+    installed or unlocked.  Thread-safe.
+*/
+class KeyProviderCache
+{
+public:
+    static QString storedKey(const char *provider, const char *service, const char *keyName);
+};
+
+#endif // SOCIALD_KEYPROVIDERCACHE_P_H
@@ -0,0 +1,242 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "memoryusagemonitor_p.h"
+#include "trace.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTimer>
+
+#include <malloc.h>
+#include <unistd.h>
+
+namespace {
+    const int SampleInterval = 1000; // msec
+
+    qint64 statusValue(const QByteArray &key)
+    {
+        QFile file(QStringLiteral("/proc/self/status"));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        // e.g. "VmHWM:     12345 kB"
+        Q_FOREACH (const QByteArray &line, file.readAll().split('\n')) {
+            if (line.startsWith(key)) {
+                return line.mid(key.size()).simplified().split(' ').value(0).toLongLong() * 1024;
+            }
+        }
+        return -1;
+    }
+}
+
+MemoryUsageMonitor::MemoryUsageMonitor(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_startRss(-1)
+    , m_endRss(-1)
+    , m_peakRss(-1)
+    , m_startHeap(-1)
+    , m_endHeap(-1)
+    , m_peakHeap(-1)
+    , m_heapAccounting(qgetenv("SOCIALD_MEMORY_ACCOUNTING") == "malloc")
+    , m_running(false)
+{
+    m_timer->setInterval(SampleInterval);
+    connect(m_timer, &QTimer::timeout, this, &MemoryUsageMonitor::sample);
+}
+
+MemoryUsageMonitor::~MemoryUsageMonitor()
+{
+}
+
+qint64 MemoryUsageMonitor::residentBytes()
+{
+    // /proc/self/statm: size resident shared text lib data dt, in pages
+    QFile file(QStringLiteral("/proc/self/statm"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+}
+
+qint64 MemoryUsageMonitor::peakResidentBytes()
+{
+    return statusValue(QByteArrayLiteral("VmHWM:"));
+}
+
+qint64 MemoryUsageMonitor::heapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    // the fields of mallinfo overflow above 2 GiB, which is not a concern here.
+    const struct mallinfo info = mallinfo();
+    return qint64(unsigned(info.uordblks)) + qint64(unsigned(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+// Resets the kernel high water mark of the resident set size (Linux 4.0+).
+bool MemoryUsageMonitor::resetPeak()
+{
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    return file.open(QIODevice::WriteOnly) && file.write("5") == 1;
+}
+
+void MemoryUsageMonitor::begin()
+{
+    m_phases.clear();
+    m_startRss = residentBytes();
+    m_endRss = -1;
+    m_peakRss = m_startRss;
+    m_startHeap = m_heapAccounting ? heapBytes() : -1;
+    m_endHeap = -1;
+    m_peakHeap = m_startHeap;
+    m_running = true;
+    resetPeak();
+    m_timer->start();
+}
+
+void MemoryUsageMonitor::end()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_timer->stop();
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases.at(i).open) {
+            endPhase(m_phases.at(i).accountId, m_phases.at(i).name);
+        }
+    }
+    sample();
+    m_endRss = residentBytes();
+    m_endHeap = m_heapAccounting ? heapBytes() : -1;
+    m_running = false;
+
+    qCInfo(lcSocialPlugin) << "sync memory usage: peak" << m_peakRss / 1024 << "KiB resident, from"
+                           << m_startRss / 1024 << "KiB to" << m_endRss / 1024 << "KiB";
+}
+
+bool MemoryUsageMonitor::isRunning() const
+{
+    return m_running;
+}
+
+void MemoryUsageMonitor::updatePeak(qint64 bytes)
+{
+    m_peakRss = qMax(m_peakRss, bytes);
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases.at(i).open) {
+            m_phases[i].peak = qMax(m_phases.at(i).peak, bytes);
+        }
+    }
+}
+
+void MemoryUsageMonitor::sample()
+{
+    updatePeak(qMax(residentBytes(), peakResidentBytes()));
+    if (m_heapAccounting) {
+        m_peakHeap = qMax(m_peakHeap, heapBytes());
+    }
+}
+
+void MemoryUsageMonitor::beginPhase(int accountId, const QString &name)
+{
+    if (!m_running) {
+        return;
+    }
+
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases.at(i).open && m_phases.at(i).accountId == accountId && m_phases.at(i).name == name) {
+            return;
+        }
+    }
+
+    // the high water mark of the previous phases is kept by the open phases.
+    sample();
+    resetPeak();
+
+    Phase phase;
+    phase.accountId = accountId;
+    phase.name = name;
+    phase.rssBefore = residentBytes();
+    phase.rssAfter = -1;
+    phase.peak = phase.rssBefore;
+    phase.heapBefore = m_heapAccounting ? heapBytes() : -1;
+    phase.heapAfter = -1;
+    phase.open = true;
+    m_phases.append(phase);
+}
+
+void MemoryUsageMonitor::endPhase(int accountId, const QString &name)
+{
+    for (int i = 0; i < m_phases.size(); ++i) {
+        Phase &phase(m_phases[i]);
+        if (phase.open && phase.accountId == accountId && phase.name == name) {
+            sample();
+            phase.rssAfter = residentBytes();
+            phase.heapAfter = m_heapAccounting ? heapBytes() : -1;
+            phase.open = false;
+            qCDebug(lcSocialPlugin) << "memory usage of" << name << "for account" << accountId << ": peak"
+                                    << phase.peak / 1024 << "KiB, from" << phase.rssBefore / 1024
+                                    << "KiB to" << phase.rssAfter / 1024 << "KiB";
+            return;
+        }
+    }
+}
+
+QJsonObject MemoryUsageMonitor::toJson() const
+{
+    QJsonArray phases;
+    Q_FOREACH (const Phase &phase, m_phases) {
+        QJsonObject object;
+        object.insert(QStringLiteral("accountId"), phase.accountId);
+        object.insert(QStringLiteral("name"), phase.name);
+        object.insert(QStringLiteral("rssBefore"), phase.rssBefore);
+        object.insert(QStringLiteral("rssAfter"), phase.rssAfter);
+        object.insert(QStringLiteral("rssPeak"), phase.peak);
+        if (m_heapAccounting) {
+            object.insert(QStringLiteral("heapBefore"), phase.heapBefore);
+            object.insert(QStringLiteral("heapAfter"), phase.heapAfter);
+        }
+        phases.append(object);
+    }
+
+    QJsonObject retn;
+    retn.insert(QStringLiteral("rssStart"), m_startRss);
+    retn.insert(QStringLiteral("rssEnd"), m_endRss);
+    retn.insert(QStringLiteral("rssPeak"), m_peakRss);
+    if (m_heapAccounting) {
+        retn.insert(QStringLiteral("heapStart"), m_startHeap);
+        retn.insert(QStringLiteral("heapEnd"), m_endHeap);
+        retn.insert(QStringLiteral("heapPeak"), m_peakHeap);
+    }
+    retn.insert(QStringLiteral("phases"), phases);
+    return retn;
+}
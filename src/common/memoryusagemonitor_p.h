@@ -0,0 +1,94 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_MEMORYUSAGEMONITOR_P_H
+#define SOCIALD_MEMORYUSAGEMONITOR_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class QTimer;
+
+/*
+    Records the memory usage of the process during a sync run.
+
+    The resident set size is sampled periodically and at the start and
+    end of each phase (e.g. the download and the finalization of the
+    data of an account), and the peak is read from the kernel high water
+    mark, which is reset at the start of each phase where the kernel
+    allows it.  If SOCIALD_MEMORY_ACCOUNTING=malloc is set in the
+    environment, the bytes allocated from the heap are recorded too.
+*/
+class MemoryUsageMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryUsageMonitor(QObject *parent = nullptr);
+    ~MemoryUsageMonitor();
+
+    void begin();
+    void end();
+    bool isRunning() const;
+
+    void beginPhase(int accountId, const QString &name);
+    void endPhase(int accountId, const QString &name);
+
+    QJsonObject toJson() const;
+
+    // in bytes, or -1 if unavailable
+    static qint64 residentBytes();
+    static qint64 peakResidentBytes();
+    static qint64 heapBytes();
+
+private Q_SLOTS:
+    void sample();
+
+private:
+    struct Phase {
+        int accountId;
+        QString name;
+        qint64 rssBefore;
+        qint64 rssAfter;
+        qint64 peak;
+        qint64 heapBefore;
+        qint64 heapAfter;
+        bool open;
+    };
+
+    void updatePeak(qint64 bytes);
+    static bool resetPeak();
+
+    QTimer *m_timer;
+    QVector<Phase> m_phases;
+    qint64 m_startRss;
+    qint64 m_endRss;
+    qint64 m_peakRss;
+    qint64 m_startHeap;
+    qint64 m_endHeap;
+    qint64 m_peakHeap;
+    bool m_heapAccounting;
+    bool m_running;
+};
+
+#endif // SOCIALD_MEMORYUSAGEMONITOR_P_H
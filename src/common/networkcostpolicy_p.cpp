@@ -0,0 +1,172 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "networkcostpolicy_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtNetwork/QNetworkConfiguration>
+#include <QtNetwork/QNetworkConfigurationManager>
+
+namespace {
+    const qint64 DefaultMeteredBudget = 5 * 1024 * 1024; // bytes
+    const QString DeferredGroup = QStringLiteral("deferred");
+}
+
+NetworkCostPolicy::NetworkCostPolicy(const QString &serviceName, const QString &dataType)
+    : m_profileName(QStringLiteral("%1.%2").arg(serviceName, dataType))
+    , m_cost(dataTypeCost(dataType))
+    , m_link(Unmetered)
+    , m_meteredBudget(DefaultMeteredBudget)
+    , m_remainingBudget(DefaultMeteredBudget)
+    , m_deferred(0)
+    , m_active(false)
+{
+}
+
+QString NetworkCostPolicy::fileName()
+{
+    return QString::fromLatin1("%1/%2/networkcostpolicy.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+NetworkCostPolicy::Link NetworkCostPolicy::currentLink()
+{
+    // the bearer management API is deprecated in Qt 5.15, but has no replacement in Qt 5.
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_DEPRECATED
+    QNetworkConfigurationManager manager;
+    const QNetworkConfiguration configuration = manager.defaultConfiguration();
+    switch (configuration.bearerType()) {
+    case QNetworkConfiguration::Bearer2G:
+    case QNetworkConfiguration::BearerCDMA2000:
+        return Weak;
+    case QNetworkConfiguration::BearerWCDMA:
+    case QNetworkConfiguration::BearerHSPA:
+    case QNetworkConfiguration::BearerEVDO:
+    case QNetworkConfiguration::BearerLTE:
+    case QNetworkConfiguration::Bearer3G:
+    case QNetworkConfiguration::Bearer4G:
+    case QNetworkConfiguration::BearerBluetooth:
+    case QNetworkConfiguration::BearerWiMAX:
+        return Metered;
+    default:
+        // WLAN, ethernet, or a bearer we know nothing about.
+        return Unmetered;
+    }
+QT_WARNING_POP
+}
+
+NetworkCostPolicy::Cost NetworkCostPolicy::dataTypeCost(const QString &dataType)
+{
+    if (dataType == QStringLiteral("Backup") || dataType == QStringLiteral("BackupRestore")) {
+        return Bulk;
+    }
+    if (dataType == QStringLiteral("Contacts")      // avatars
+            || dataType == QStringLiteral("Images")
+            || dataType == QStringLiteral("Videos")) {
+        return Heavy;
+    }
+    return Light;
+}
+
+QStringList NetworkCostPolicy::deferredProfiles()
+{
+    QSettings settings(fileName(), QSettings::IniFormat);
+    settings.beginGroup(DeferredGroup);
+    return settings.childKeys();
+}
+
+void NetworkCostPolicy::setMeteredBudget(qint64 bytes)
+{
+    m_meteredBudget = qMax<qint64>(0, bytes);
+}
+
+void NetworkCostPolicy::begin()
+{
+    m_active = true;
+    m_deferred = 0;
+    m_remainingBudget = m_meteredBudget;
+    updateLink();
+}
+
+void NetworkCostPolicy::updateLink()
+{
+    const Link link = currentLink();
+    if (link != m_link) {
+        qCInfo(lcSocialPlugin) << m_profileName << "network link is now"
+                               << (link == Unmetered ? "unmetered" : (link == Metered ? "metered" : "weak"));
+        m_link = link;
+    }
+}
+
+void NetworkCostPolicy::end(bool succeeded)
+{
+    if (!m_active) {
+        return;
+    }
+    m_active = false;
+
+    QSettings settings(fileName(), QSettings::IniFormat);
+    const bool wasDeferred = settings.contains(DeferredGroup + QLatin1Char('/') + m_profileName);
+
+    if (m_deferred > 0) {
+        qCInfo(lcSocialPlugin) << m_profileName << "deferred" << m_deferred << "transfers until an unmetered link is available";
+        QDir().mkpath(QFileInfo(fileName()).absolutePath());
+        settings.setValue(DeferredGroup + QLatin1Char('/') + m_profileName, m_deferred);
+    } else if (succeeded && wasDeferred) {
+        settings.remove(DeferredGroup + QLatin1Char('/') + m_profileName);
+    }
+}
+
+NetworkCostPolicy::Link NetworkCostPolicy::link() const
+{
+    return m_link;
+}
+
+bool NetworkCostPolicy::isRestricted() const
+{
+    return m_link != Unmetered && m_cost != Light;
+}
+
+bool NetworkCostPolicy::allowBulkTransfer(qint64 expectedBytes)
+{
+    if (!isRestricted()) {
+        return true;
+    }
+
+    if (m_link == Metered && expectedBytes <= m_remainingBudget) {
+        m_remainingBudget -= expectedBytes;
+        return true;
+    }
+
+    m_deferred += 1;
+    return false;
+}
+
+int NetworkCostPolicy::deferredCount() const
+{
+    return m_deferred;
+}
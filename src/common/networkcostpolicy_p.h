@@ -0,0 +1,90 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_NETWORKCOSTPOLICY_P_H
+#define SOCIALD_NETWORKCOSTPOLICY_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+/*
+    Decides which transfers of a sync may use the current network link.
+
+    Data types are classified by their byte cost: light data types
+    (notifications, calendars, posts...) are always synced, while the
+    bulk transfers of heavy data types (avatars, images) are limited to
+    a per-sync byte budget on metered links and deferred altogether on
+    weak links.  Deferred transfers are picked up by the next sync, and
+    the data types which deferred transfers are remembered in the sync
+    database directory, so that they can be synced again once an
+    unmetered link (WLAN) is available.
+*/
+class NetworkCostPolicy
+{
+public:
+    enum Link {
+        Unmetered = 0,
+        Metered,
+        Weak
+    };
+
+    enum Cost {
+        Light = 0,
+        Heavy,
+        Bulk
+    };
+
+    NetworkCostPolicy(const QString &serviceName, const QString &dataType);
+
+    static Link currentLink();
+    static Cost dataTypeCost(const QString &dataType);
+
+    // Returns the template profiles (<service>.<DataType>) which deferred transfers.
+    static QStringList deferredProfiles();
+
+    // The bytes which may be spent on bulk transfers per sync on a metered link.
+    void setMeteredBudget(qint64 bytes);
+
+    void begin();
+    void end(bool succeeded);
+    void updateLink();
+
+    Link link() const;
+    bool isRestricted() const;
+
+    // Returns whether a bulk transfer of about expectedBytes may be started,
+    // and charges it to the budget.  Otherwise the transfer is counted as deferred.
+    bool allowBulkTransfer(qint64 expectedBytes);
+    int deferredCount() const;
+
+private:
+    static QString fileName();
+
+    QString m_profileName;
+    Cost m_cost;
+    Link m_link;
+    qint64 m_meteredBudget;
+    qint64 m_remainingBudget;
+    int m_deferred;
+    bool m_active;
+};
+
+#endif // SOCIALD_NETWORKCOSTPOLICY_P_H
@@ -0,0 +1,289 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "networkrequestmetrics_p.h"
+#include "flightrecorder_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStandardPaths>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusMessage>
+
+namespace {
+    // upper bounds (in msec) of the latency histogram buckets.
+    // the last bucket collects everything slower than the last bound.
+    const qint64 HistogramBounds[] = { 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000 };
+    const int HistogramBoundCount = sizeof(HistogramBounds) / sizeof(HistogramBounds[0]);
+
+    const QString MetricsObjectPath = QStringLiteral("/sociald/metrics");
+    const QString MetricsInterface = QStringLiteral("org.sailfishos.sociald.Metrics");
+}
+
+NetworkRequestMetrics::Histogram::Histogram()
+    : m_buckets(HistogramBoundCount + 1, 0)
+    , m_count(0)
+    , m_sum(0)
+    , m_max(0)
+{
+}
+
+void NetworkRequestMetrics::Histogram::add(qint64 msecs)
+{
+    int bucket = 0;
+    while (bucket < HistogramBoundCount && msecs > HistogramBounds[bucket]) {
+        ++bucket;
+    }
+    m_buckets[bucket] += 1;
+    m_count += 1;
+    m_sum += msecs;
+    m_max = qMax(m_max, msecs);
+}
+
+QJsonObject NetworkRequestMetrics::Histogram::toJson() const
+{
+    QJsonArray buckets;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        QJsonObject bucket;
+        if (i < HistogramBoundCount) {
+            bucket.insert(QStringLiteral("le"), HistogramBounds[i]);
+        }
+        bucket.insert(QStringLiteral("count"), m_buckets.at(i));
+        buckets.append(bucket);
+    }
+
+    QJsonObject retn;
+    retn.insert(QStringLiteral("count"), m_count);
+    retn.insert(QStringLiteral("sum"), m_sum);
+    retn.insert(QStringLiteral("max"), m_max);
+    retn.insert(QStringLiteral("buckets"), buckets);
+    return retn;
+}
+
+NetworkRequestMetrics::NetworkRequestMetrics(const QString &serviceName, const QString &dataType, QObject *parent)
+    : QObject(parent)
+    , m_serviceName(serviceName)
+    , m_dataType(dataType)
+{
+}
+
+NetworkRequestMetrics::~NetworkRequestMetrics()
+{
+}
+
+QString NetworkRequestMetrics::metricsDirectory()
+{
+    return QString::fromLatin1("%1/%2/metrics")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+void NetworkRequestMetrics::requestStarted(int accountId, QNetworkReply *reply)
+{
+    if (!reply || m_pending.contains(reply)) {
+        return;
+    }
+
+    if (m_pending.isEmpty() && m_accounts.isEmpty()) {
+        m_started = QDateTime::currentDateTimeUtc();
+    }
+
+    PendingRequest &request(m_pending[reply]);
+    request.accountId = accountId;
+    request.headersReceived = -1;
+    request.bytesSent = 0;
+    request.bytesReceived = 0;
+    request.timer.start();
+
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply] {
+        QHash<QNetworkReply*, PendingRequest>::iterator it = m_pending.find(reply);
+        if (it != m_pending.end() && it->headersReceived < 0) {
+            it->headersReceived = it->timer.elapsed();
+        }
+    });
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply] (qint64 received, qint64) {
+        QHash<QNetworkReply*, PendingRequest>::iterator it = m_pending.find(reply);
+        if (it != m_pending.end()) {
+            it->bytesReceived = received;
+        }
+    });
+    connect(reply, &QNetworkReply::uploadProgress, this, [this, reply] (qint64 sent, qint64) {
+        QHash<QNetworkReply*, PendingRequest>::iterator it = m_pending.find(reply);
+        if (it != m_pending.end()) {
+            it->bytesSent = sent;
+        }
+    });
+    connect(reply, &QObject::destroyed, this, [this, reply] {
+        m_pending.remove(reply);
+    });
+}
+
+void NetworkRequestMetrics::requestFinished(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, PendingRequest>::iterator it = m_pending.find(reply);
+    if (it == m_pending.end()) {
+        return;
+    }
+
+    const qint64 total = it->timer.elapsed();
+    AccountMetrics &metrics(m_accounts[it->accountId]);
+    metrics.requests += 1;
+    metrics.retries += reply->property("retryCount").toInt();
+    if (reply->property("isError").toBool() || reply->error() != QNetworkReply::NoError) {
+        metrics.errors += 1;
+    }
+
+    metrics.bytesSent += it->bytesSent;
+    metrics.bytesReceived += it->bytesReceived > 0
+            ? it->bytesReceived
+            : reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    metrics.httpStatus[httpStatus] += 1;
+    metrics.hosts[reply->url().host()] += 1;
+
+    if (it->headersReceived >= 0) {
+        metrics.headerLatency.add(it->headersReceived);
+    }
+    metrics.totalLatency.add(total);
+
+    // requests which were timed out or failed to be parsed are recorded with error -1.
+    const int networkError = reply->error() == QNetworkReply::NoError && reply->property("isError").toBool()
+            ? -1 : int(reply->error());
+    FlightRecorder::instance()->recordRequest(it->accountId, reply->url(), httpStatus, networkError,
+                                              reply->property("retryCount").toInt(),
+                                              it->bytesSent, it->bytesReceived, it->headersReceived, total);
+
+    qCDebug(lcSocialPlugin) << "request to" << reply->url().host() << "finished with status" << httpStatus
+                            << "in" << total << "msec, received" << it->bytesReceived << "bytes";
+
+    m_pending.erase(it);
+    disconnect(reply, nullptr, this, nullptr);
+}
+
+void NetworkRequestMetrics::setMemoryUsage(const QJsonObject &memoryUsage)
+{
+    m_memoryUsage = memoryUsage;
+}
+
+bool NetworkRequestMetrics::isEmpty() const
+{
+    return m_accounts.isEmpty() && m_pending.isEmpty();
+}
+
+int NetworkRequestMetrics::unfinishedCount(int accountId) const
+{
+    int count = 0;
+    for (QHash<QNetworkReply*, PendingRequest>::const_iterator it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (it->accountId == accountId) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QJsonObject NetworkRequestMetrics::toJson(int accountId) const
+{
+    const AccountMetrics metrics = m_accounts.value(accountId);
+
+    QJsonObject httpStatus;
+    for (QMap<int, int>::const_iterator it = metrics.httpStatus.constBegin(); it != metrics.httpStatus.constEnd(); ++it) {
+        httpStatus.insert(QString::number(it.key()), it.value());
+    }
+
+    QJsonObject hosts;
+    for (QMap<QString, int>::const_iterator it = metrics.hosts.constBegin(); it != metrics.hosts.constEnd(); ++it) {
+        hosts.insert(it.key(), it.value());
+    }
+
+    QJsonObject retn;
+    retn.insert(QStringLiteral("service"), m_serviceName);
+    retn.insert(QStringLiteral("dataType"), m_dataType);
+    retn.insert(QStringLiteral("accountId"), accountId);
+    retn.insert(QStringLiteral("started"), m_started.toString(Qt::ISODate));
+    retn.insert(QStringLiteral("finished"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    retn.insert(QStringLiteral("requests"), metrics.requests);
+    retn.insert(QStringLiteral("errors"), metrics.errors);
+    retn.insert(QStringLiteral("retries"), metrics.retries);
+    retn.insert(QStringLiteral("unfinished"), unfinishedCount(accountId));
+    retn.insert(QStringLiteral("bytesSent"), metrics.bytesSent);
+    retn.insert(QStringLiteral("bytesReceived"), metrics.bytesReceived);
+    retn.insert(QStringLiteral("httpStatus"), httpStatus);
+    retn.insert(QStringLiteral("hosts"), hosts);
+    retn.insert(QStringLiteral("headerLatency"), metrics.headerLatency.toJson());
+    retn.insert(QStringLiteral("totalLatency"), metrics.totalLatency.toJson());
+    if (!m_memoryUsage.isEmpty()) {
+        retn.insert(QStringLiteral("memory"), m_memoryUsage);
+    }
+    return retn;
+}
+
+void NetworkRequestMetrics::report()
+{
+    if (isEmpty()) {
+        return;
+    }
+
+    const QString directory = metricsDirectory();
+    if (!QDir().mkpath(directory)) {
+        qCWarning(lcSocialPlugin) << "unable to create network metrics directory" << directory;
+    }
+
+    // accounts whose requests all remained unfinished are reported too
+    QList<int> accountIds = m_accounts.keys();
+    for (QHash<QNetworkReply*, PendingRequest>::const_iterator it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (!accountIds.contains(it->accountId)) {
+            accountIds.append(it->accountId);
+        }
+    }
+
+    Q_FOREACH (int accountId, accountIds) {
+        const QByteArray json = QJsonDocument(toJson(accountId)).toJson(QJsonDocument::Compact);
+
+        QDBusMessage signal = QDBusMessage::createSignal(MetricsObjectPath, MetricsInterface,
+                                                         QStringLiteral("syncMetrics"));
+        signal.setArguments(QVariantList() << m_serviceName << m_dataType << accountId
+                                           << QString::fromUtf8(json));
+        QDBusConnection::sessionBus().send(signal);
+
+        QFile file(QString::fromLatin1("%1/%2.%3-%4.json")
+                   .arg(directory, m_serviceName, m_dataType).arg(accountId));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(json);
+            file.close();
+        } else {
+            qCWarning(lcSocialPlugin) << "unable to write network metrics to" << file.fileName();
+        }
+    }
+
+    reset();
+}
+
+void NetworkRequestMetrics::reset()
+{
+    m_accounts.clear();
+    m_memoryUsage = QJsonObject();
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_NETWORKREQUESTMETRICS_P_H
+#define SOCIALD_NETWORKREQUESTMETRICS_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+
+class QNetworkReply;
+
+/*
+    Collects per-request network statistics for a sync adaptor.
+
+    Each request is tracked from setupReplyTimeout() until
+    removeReplyTimeout(), recording the time until the response
+    headers arrived, the total time, the bytes transferred in each
+    direction, the HTTP status and the retry count (as stored in the
+    "retryCount" property of the reply).  Qt does not expose DNS or
+    connection timings, so those are folded into the header latency.
+
+    The statistics are aggregated per account into latency histograms
+    and reported when the sync finishes: as a D-Bus signal on the
+    session bus, and as a JSON file in the sync database directory.
+*/
+class NetworkRequestMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    NetworkRequestMetrics(const QString &serviceName, const QString &dataType, QObject *parent = nullptr);
+    ~NetworkRequestMetrics();
+
+    void requestStarted(int accountId, QNetworkReply *reply);
+    void requestFinished(QNetworkReply *reply);
+
+    // the memory usage of the sync, see MemoryUsageMonitor
+    void setMemoryUsage(const QJsonObject &memoryUsage);
+
+    bool isEmpty() const;
+    QJsonObject toJson(int accountId) const;
+    void report();
+    void reset();
+
+    static QString metricsDirectory();
+
+private:
+    int unfinishedCount(int accountId) const;
+
+    class Histogram
+    {
+    public:
+        Histogram();
+        void add(qint64 msecs);
+        QJsonObject toJson() const;
+
+    private:
+        QVector<int> m_buckets;
+        int m_count;
+        qint64 m_sum;
+        qint64 m_max;
+    };
+
+    struct PendingRequest {
+        int accountId;
+        QElapsedTimer timer;
+        qint64 headersReceived;
+        qint64 bytesSent;
+        qint64 bytesReceived;
+    };
+
+    struct AccountMetrics {
+        AccountMetrics() : requests(0), errors(0), retries(0), bytesSent(0), bytesReceived(0) {}
+        int requests;
+        int errors;
+        int retries;
+        qint64 bytesSent;
+        qint64 bytesReceived;
+        QMap<int, int> httpStatus;
+        QMap<QString, int> hosts;
+        Histogram headerLatency;
+        Histogram totalLatency;
+    };
+
+    QString m_serviceName;
+    QString m_dataType;
+    QDateTime m_started;
+    QHash<QNetworkReply*, PendingRequest> m_pending;
+    QMap<int, AccountMetrics> m_accounts;
+    QJsonObject m_memoryUsage;
+};
+
+#endif // SOCIALD_NETWORKREQUESTMETRICS_P_H
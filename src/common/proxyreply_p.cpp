@@ -0,0 +1,184 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "proxyreply_p.h"
+
+#include <QtNetwork/QSslError>
+
+#include <string.h>
+
+ProxyReply::ProxyReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request, QObject *parent)
+    : QNetworkReply(parent)
+    , m_bytesReceived(0)
+{
+    setRequest(request);
+    setOperation(op);
+    setUrl(request.url());
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+ProxyReply::~ProxyReply()
+{
+    if (m_source) {
+        m_source->deleteLater();
+    }
+}
+
+void ProxyReply::forward(QNetworkReply *source)
+{
+    m_source = source;
+
+    connect(source, &QNetworkReply::metaDataChanged, this, [this, source] {
+        sourceMetaDataChanged(source);
+    });
+    connect(source, &QIODevice::readyRead, this, [this, source] {
+        sourceReadyRead(source);
+    });
+    connect(source, &QNetworkReply::uploadProgress, this, &QNetworkReply::uploadProgress);
+    connect(source, &QNetworkReply::sslErrors, this, &QNetworkReply::sslErrors);
+    connect(source, &QNetworkReply::finished, this, [this, source] {
+        sourceFinished(source);
+    });
+
+    emit requestStarted();
+}
+
+void ProxyReply::sourceMetaDataChanged(QNetworkReply *source)
+{
+    // properties set by the network access manager, e.g. for conditional requests.
+    if (source->property("notModified").isValid()) {
+        setProperty("notModified", source->property("notModified"));
+    }
+    const QVariant redirect = source->attribute(QNetworkRequest::RedirectionTargetAttribute);
+    if (redirect.isValid()) {
+        setAttribute(QNetworkRequest::RedirectionTargetAttribute, redirect);
+    }
+    setResponse(source->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                source->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray(),
+                source->rawHeaderPairs());
+}
+
+void ProxyReply::sourceReadyRead(QNetworkReply *source)
+{
+    appendData(source->readAll());
+}
+
+void ProxyReply::sourceFinished(QNetworkReply *source)
+{
+    appendData(source->readAll());
+    finishReply(source->error(), source->errorString());
+}
+
+void ProxyReply::releaseSource()
+{
+    if (m_source) {
+        m_source->disconnect(this);
+        m_source->deleteLater();
+        m_source.clear();
+        emit requestPending();
+    }
+}
+
+QNetworkReply *ProxyReply::source() const
+{
+    return m_source.data();
+}
+
+void ProxyReply::setResponse(int httpStatus, const QByteArray &reasonPhrase,
+                             const QList<QPair<QByteArray, QByteArray> > &headers)
+{
+    if (httpStatus > 0) {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, httpStatus);
+        setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, reasonPhrase);
+    }
+    for (int i = 0; i < headers.size(); ++i) {
+        setRawHeader(headers.at(i).first, headers.at(i).second);
+    }
+    emit metaDataChanged();
+}
+
+void ProxyReply::appendData(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    emit dataReceived(data);
+    m_buffer.append(data);
+    m_bytesReceived += data.size();
+    emit readyRead();
+    emit downloadProgress(m_bytesReceived, header(QNetworkRequest::ContentLengthHeader).isValid()
+                                           ? header(QNetworkRequest::ContentLengthHeader).toLongLong()
+                                           : -1);
+}
+
+void ProxyReply::finishReply(QNetworkReply::NetworkError error, const QString &errorString)
+{
+    if (isFinished()) {
+        return;
+    }
+
+    if (m_source) {
+        m_source->deleteLater();
+        m_source.clear();
+    }
+
+    if (error != QNetworkReply::NoError) {
+        setError(error, errorString);
+        emit QNetworkReply::error(error);
+    }
+    setFinished(true);
+    emit finished();
+}
+
+void ProxyReply::abort()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    if (m_source) {
+        m_source->disconnect(this);
+        m_source->abort();
+    }
+    finishReply(QNetworkReply::OperationCanceledError, QStringLiteral("Operation canceled"));
+}
+
+qint64 ProxyReply::bytesAvailable() const
+{
+    return QNetworkReply::bytesAvailable() + m_buffer.size();
+}
+
+bool ProxyReply::isSequential() const
+{
+    return true;
+}
+
+qint64 ProxyReply::readData(char *data, qint64 maxSize)
+{
+    if (m_buffer.isEmpty()) {
+        return isFinished() ? -1 : 0;
+    }
+
+    const qint64 size = qMin<qint64>(maxSize, m_buffer.size());
+    memcpy(data, m_buffer.constData(), size);
+    m_buffer.remove(0, size);
+    return size;
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_PROXYREPLY_P_H
+#define SOCIALD_PROXYREPLY_P_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QPointer>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+
+/*
+    Reply which is handed out by a network access manager before (or
+    instead of) the real request being made.
+
+    It is either fed explicitly with setResponse(), appendData() and
+    finishReply(), or forwards everything from a real reply once one
+    has been created with forward().  Aborting the proxy aborts the
+    real reply, if there is one.
+*/
+class ProxyReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    ProxyReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request, QObject *parent = 0);
+    ~ProxyReply();
+
+    void forward(QNetworkReply *source);
+    QNetworkReply *source() const;
+
+    void setResponse(int httpStatus, const QByteArray &reasonPhrase,
+                     const QList<QPair<QByteArray, QByteArray> > &headers);
+    void appendData(const QByteArray &data);
+    void finishReply(QNetworkReply::NetworkError error, const QString &errorString);
+
+    void abort() override;
+    qint64 bytesAvailable() const override;
+    bool isSequential() const override;
+
+Q_SIGNALS:
+    // emitted for every chunk of body data, before it is made available to readers.
+    void dataReceived(const QByteArray &data);
+
+    // emitted when a real request is forwarded, and when the reply starts
+    // waiting for another one after its source has been released.
+    void requestStarted();
+    void requestPending();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+    // called for the signals of the forwarded reply.
+    virtual void sourceMetaDataChanged(QNetworkReply *source);
+    virtual void sourceReadyRead(QNetworkReply *source);
+    virtual void sourceFinished(QNetworkReply *source);
+
+    // stops forwarding the current source, and deletes it.
+    void releaseSource();
+
+private:
+    QPointer<QNetworkReply> m_source;
+    QByteArray m_buffer;
+    qint64 m_bytesReceived;
+};
+
+#endif // SOCIALD_PROXYREPLY_P_H
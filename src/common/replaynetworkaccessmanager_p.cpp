@@ -0,0 +1,378 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "replaynetworkaccessmanager_p.h"
+#include "trace.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUrlQuery>
+
+namespace {
+    const char *RecordVariable = "SOCIALD_NETWORK_RECORD";
+    const char *ReplayVariable = "SOCIALD_NETWORK_REPLAY";
+    const char *ReplayLatencyVariable = "SOCIALD_NETWORK_REPLAY_LATENCY";
+    const char *ReplayBandwidthVariable = "SOCIALD_NETWORK_REPLAY_BANDWIDTH";
+
+    const int ReplayChunkInterval = 50; // msec
+
+    // headers which carry credentials or session state.
+    const QList<QByteArray> ScrubbedHeaders = QList<QByteArray>()
+            << QByteArray("authorization")
+            << QByteArray("proxy-authorization")
+            << QByteArray("cookie")
+            << QByteArray("set-cookie");
+
+    // headers which describe the encoding on the wire rather than the
+    // (already decoded) body which is stored in the fixture.
+    const QList<QByteArray> TransportHeaders = QList<QByteArray>()
+            << QByteArray("content-encoding")
+            << QByteArray("transfer-encoding")
+            << QByteArray("content-length");
+
+    // query items which depend on the time of the sync, e.g. the window of
+    // the events requested from the Google Calendar API, and which would
+    // otherwise keep a recording from being replayed on a later day.
+    const QStringList VolatileQueryItems = QStringList()
+            << QStringLiteral("timeMin")
+            << QStringLiteral("timeMax");
+
+    // tokens which are returned in response bodies, e.g. by token refresh endpoints.
+    const QRegularExpression BodyTokenPattern(QStringLiteral(
+            "(\"(?:access_token|refresh_token|id_token|oauth_token|oauth_token_secret)\"\\s*:\\s*\")[^\"]*(\")"));
+
+    const QString ScrubbedValue = QStringLiteral("SCRUBBED");
+
+    struct Recording {
+        QElapsedTimer timer;
+        qint64 headerLatency;
+        QByteArray body;
+    };
+
+    QString operationName(QNetworkAccessManager::Operation op, const QNetworkRequest &req)
+    {
+        switch (op) {
+        case QNetworkAccessManager::HeadOperation: return QStringLiteral("HEAD");
+        case QNetworkAccessManager::GetOperation: return QStringLiteral("GET");
+        case QNetworkAccessManager::PutOperation: return QStringLiteral("PUT");
+        case QNetworkAccessManager::PostOperation: return QStringLiteral("POST");
+        case QNetworkAccessManager::DeleteOperation: return QStringLiteral("DELETE");
+        case QNetworkAccessManager::CustomOperation:
+            return QString::fromLatin1(req.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray());
+        default: return QStringLiteral("UNKNOWN");
+        }
+    }
+
+    QByteArray scrubbedBody(const QByteArray &body, const QByteArray &contentType)
+    {
+        if (!contentType.contains("json") && !contentType.startsWith("text/")) {
+            return body;
+        }
+        QString text = QString::fromUtf8(body);
+        text.replace(BodyTokenPattern, QStringLiteral("\\1") + ScrubbedValue + QStringLiteral("\\2"));
+        return text.toUtf8();
+    }
+}
+
+ReplayNetworkAccessManager::ReplayNetworkAccessManager(const QString &fixtureName, QObject *parent)
+    : SocialdNetworkAccessManager(parent)
+    , m_mode(qEnvironmentVariableIsSet(ReplayVariable) ? Replay : Record)
+    , m_replayLatency(-1)
+    , m_replayBandwidth(0)
+{
+    const QString root = QString::fromLocal8Bit(qgetenv(m_mode == Replay ? ReplayVariable : RecordVariable));
+    m_fixtureDirectory = QString::fromLatin1("%1/%2").arg(root, fixtureName);
+
+    bool ok = false;
+    const int latency = qgetenv(ReplayLatencyVariable).toInt(&ok);
+    if (ok && latency >= 0) {
+        m_replayLatency = latency;
+    }
+    const int bandwidth = qgetenv(ReplayBandwidthVariable).toInt(&ok);
+    if (ok && bandwidth > 0) {
+        m_replayBandwidth = bandwidth;
+    }
+
+    qCInfo(lcSocialPlugin) << (m_mode == Replay ? "replaying" : "recording")
+                           << "network traffic in" << m_fixtureDirectory;
+}
+
+bool ReplayNetworkAccessManager::isConfigured()
+{
+    return qEnvironmentVariableIsSet(RecordVariable) || qEnvironmentVariableIsSet(ReplayVariable);
+}
+
+ReplayNetworkAccessManager::Mode ReplayNetworkAccessManager::mode() const
+{
+    return m_mode;
+}
+
+QString ReplayNetworkAccessManager::fixtureDirectory() const
+{
+    return m_fixtureDirectory;
+}
+
+QNetworkReply *ReplayNetworkAccessManager::createRequest(
+                                 QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData)
+{
+    return m_mode == Replay
+            ? replayRequest(op, req)
+            : recordRequest(op, req, outgoingData);
+}
+
+QString ReplayNetworkAccessManager::fixtureKey(QNetworkAccessManager::Operation op, const QNetworkRequest &req)
+{
+    QUrl url = withoutCredentials(req.url());
+    QUrlQuery query(url);
+    Q_FOREACH (const QString &item, VolatileQueryItems) {
+        query.removeAllQueryItems(item);
+    }
+    url.setQuery(query);
+
+    const QByteArray id = operationName(op, req).toLatin1() + ' ' + url.toEncoded();
+    return QString::fromLatin1(QCryptographicHash::hash(id, QCryptographicHash::Sha1).toHex());
+}
+
+QString ReplayNetworkAccessManager::fixtureFileName(const QString &key, int occurrence) const
+{
+    return QString::fromLatin1("%1/%2-%3.json").arg(m_fixtureDirectory, key).arg(occurrence);
+}
+
+QNetworkReply *ReplayNetworkAccessManager::recordRequest(
+                                 QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData)
+{
+    // the request body is read here, as it cannot be read twice.
+    QBuffer *body = 0;
+    if (outgoingData) {
+        body = new QBuffer;
+        body->setData(outgoingData->readAll());
+        body->open(QIODevice::ReadOnly);
+    }
+
+    QNetworkReply *source = SocialdNetworkAccessManager::createRequest(op, req, body);
+    if (!source) {
+        delete body;
+        return 0;
+    }
+    if (body) {
+        body->setParent(source);
+    }
+
+    const QString key = fixtureKey(op, req);
+    const QString fileName = fixtureFileName(key, m_occurrences[key]++);
+
+    QSharedPointer<Recording> recording(new Recording);
+    recording->headerLatency = -1;
+    recording->timer.start();
+
+    ProxyReply *reply = new ProxyReply(op, req, this);
+    reply->forward(source);
+
+    connect(source, &QNetworkReply::metaDataChanged, this, [recording] {
+        if (recording->headerLatency < 0) {
+            recording->headerLatency = recording->timer.elapsed();
+        }
+    });
+    connect(reply, &ProxyReply::dataReceived, this, [recording] (const QByteArray &data) {
+        recording->body.append(data);
+    });
+    // connected after forward(), so that the remaining data has been received.
+    connect(source, &QNetworkReply::finished, this, [this, op, req, source, recording, fileName] {
+        QJsonObject requestHeaders;
+        Q_FOREACH (const QByteArray &name, req.rawHeaderList()) {
+            if (!ScrubbedHeaders.contains(name.toLower())) {
+                requestHeaders.insert(QString::fromLatin1(name), QString::fromLatin1(req.rawHeader(name)));
+            }
+        }
+
+        QByteArray contentType;
+        QJsonArray headers;
+        Q_FOREACH (const QNetworkReply::RawHeaderPair &header, source->rawHeaderPairs()) {
+            const QByteArray name = header.first.toLower();
+            if (ScrubbedHeaders.contains(name) || TransportHeaders.contains(name)) {
+                continue;
+            }
+            if (name == "content-type") {
+                contentType = header.second.toLower();
+            }
+            headers.append(QJsonArray() << QString::fromLatin1(header.first) << QString::fromLatin1(header.second));
+        }
+
+        const QByteArray body = scrubbedBody(recording->body, contentType);
+        headers.append(QJsonArray() << QStringLiteral("Content-Length") << QString::number(body.size()));
+
+        QJsonObject fixture;
+        fixture.insert(QStringLiteral("method"), operationName(op, req));
+        fixture.insert(QStringLiteral("url"), QString::fromUtf8(withoutCredentials(req.url()).toEncoded()));
+        fixture.insert(QStringLiteral("requestHeaders"), requestHeaders);
+        fixture.insert(QStringLiteral("status"), source->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+        fixture.insert(QStringLiteral("reason"), QString::fromLatin1(
+                source->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray()));
+        fixture.insert(QStringLiteral("headers"), headers);
+        fixture.insert(QStringLiteral("body"), QString::fromLatin1(body.toBase64()));
+        fixture.insert(QStringLiteral("error"), static_cast<int>(source->error()));
+        fixture.insert(QStringLiteral("errorString"), source->error() == QNetworkReply::NoError
+                                                      ? QString() : source->errorString());
+        fixture.insert(QStringLiteral("headerLatency"), recording->headerLatency);
+        fixture.insert(QStringLiteral("totalLatency"), recording->timer.elapsed());
+        writeFixture(fileName, fixture);
+    });
+
+    return reply;
+}
+
+QNetworkReply *ReplayNetworkAccessManager::replayRequest(
+                                 QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req)
+{
+    const QString key = fixtureKey(op, req);
+    const int occurrence = m_occurrences[key]++;
+
+    // if the url was requested more often than during the recording,
+    // keep serving the last recorded response.
+    QFile file;
+    for (int n = occurrence; n >= 0; --n) {
+        file.setFileName(fixtureFileName(key, n));
+        if (file.exists()) {
+            break;
+        }
+    }
+
+    QJsonObject fixture;
+    if (file.open(QIODevice::ReadOnly)) {
+        fixture = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+    }
+
+    if (fixture.isEmpty()) {
+        qCWarning(lcSocialPlugin) << "no recorded response for" << operationName(op, req)
+                                  << withoutCredentials(req.url()).toString();
+        fixture.insert(QStringLiteral("status"), 404);
+        fixture.insert(QStringLiteral("reason"), QStringLiteral("Not Found"));
+        fixture.insert(QStringLiteral("error"), static_cast<int>(QNetworkReply::ContentNotFoundError));
+        fixture.insert(QStringLiteral("errorString"), QStringLiteral("No recorded response"));
+    }
+
+    const int latency = m_replayLatency >= 0
+            ? m_replayLatency
+            : qMax(0, fixture.value(QStringLiteral("headerLatency")).toInt());
+
+    FixtureReply *reply = new FixtureReply(op, req, this);
+    reply->replay(fixture, latency, m_replayBandwidth);
+    return reply;
+}
+
+void ReplayNetworkAccessManager::writeFixture(const QString &fileName, const QJsonObject &fixture)
+{
+    if (!QDir().mkpath(m_fixtureDirectory)) {
+        qCWarning(lcSocialPlugin) << "unable to create fixture directory" << m_fixtureDirectory;
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcSocialPlugin) << "unable to write fixture" << fileName;
+        return;
+    }
+    file.write(QJsonDocument(fixture).toJson(QJsonDocument::Indented));
+    file.close();
+}
+
+FixtureReply::FixtureReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request, QObject *parent)
+    : ProxyReply(op, request, parent)
+    , m_replayOffset(0)
+    , m_replayChunkSize(0)
+    , m_replayError(QNetworkReply::NoError)
+{
+    m_replayTimer.setInterval(ReplayChunkInterval);
+    connect(&m_replayTimer, &QTimer::timeout, this, &FixtureReply::deliverReplayChunk);
+}
+
+FixtureReply::~FixtureReply()
+{
+}
+
+void FixtureReply::replay(const QJsonObject &fixture, int latency, int bytesPerSecond)
+{
+    m_replayBody = QByteArray::fromBase64(fixture.value(QStringLiteral("body")).toString().toLatin1());
+    m_replayError = static_cast<QNetworkReply::NetworkError>(fixture.value(QStringLiteral("error")).toInt());
+    m_replayErrorString = fixture.value(QStringLiteral("errorString")).toString();
+    m_replayChunkSize = bytesPerSecond > 0
+            ? qMax(1, bytesPerSecond * ReplayChunkInterval / 1000)
+            : m_replayBody.size();
+
+    const int httpStatus = fixture.value(QStringLiteral("status")).toInt();
+    const QByteArray reasonPhrase = fixture.value(QStringLiteral("reason")).toString().toLatin1();
+    QList<QPair<QByteArray, QByteArray> > headers;
+    Q_FOREACH (const QJsonValue &header, fixture.value(QStringLiteral("headers")).toArray()) {
+        const QJsonArray pair = header.toArray();
+        headers.append(qMakePair(pair.at(0).toString().toLatin1(), pair.at(1).toString().toLatin1()));
+    }
+
+    // always deliver asynchronously, as the caller connects to the reply after creating it.
+    QTimer::singleShot(latency, this, [this, httpStatus, reasonPhrase, headers] {
+        if (isFinished()) {
+            return;
+        }
+        if (httpStatus == 304) {
+            setProperty("notModified", true);
+        }
+        setResponse(httpStatus, reasonPhrase, headers);
+        if (isFinished()) {
+            return; // aborted by a metaDataChanged() handler
+        }
+        deliverReplayChunk();
+        if (!isFinished()) {
+            m_replayTimer.start();
+        }
+    });
+}
+
+void FixtureReply::deliverReplayChunk()
+{
+    if (m_replayOffset < m_replayBody.size()) {
+        const QByteArray chunk = m_replayBody.mid(m_replayOffset, m_replayChunkSize);
+        m_replayOffset += chunk.size();
+        appendData(chunk);
+    }
+
+    if (m_replayOffset >= m_replayBody.size() && !isFinished()) {
+        m_replayTimer.stop();
+        m_replayBody.clear();
+        finishReply(m_replayError, m_replayErrorString);
+    }
+}
+
+void FixtureReply::abort()
+{
+    m_replayTimer.stop();
+    ProxyReply::abort();
+}
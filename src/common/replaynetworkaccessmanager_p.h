@@ -0,0 +1,127 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_REPLAYNETWORKACCESSMANAGER_P_H
+#define SOCIALD_REPLAYNETWORKACCESSMANAGER_P_H
+
+#include "socialdnetworkaccessmanager_p.h"
+#include "proxyreply_p.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+/*
+    Network access manager which records the traffic of a sync adaptor
+    to a fixture directory, or replays previously recorded traffic
+    without touching the network.
+
+    The mode is chosen with environment variables:
+      SOCIALD_NETWORK_RECORD=<dir>           record every exchange to <dir>
+      SOCIALD_NETWORK_REPLAY=<dir>           serve every request from <dir>
+      SOCIALD_NETWORK_REPLAY_LATENCY=<msec>  fixed latency of replayed
+                                             replies (default: the recorded
+                                             time until the headers arrived)
+      SOCIALD_NETWORK_REPLAY_BANDWIDTH=<n>   replayed body bytes per second
+                                             (default: unlimited)
+
+    Each exchange is written to <dir>/<fixtureName>/<key>-<n>.json, where
+    key is a hash of the method and of the url without credentials or
+    time windows (timeMin and timeMax, which move with the time of the
+    sync), and n counts the requests made to the same url, so that a url
+    which is fetched repeatedly replays its responses in the recorded
+    order.
+    Access tokens, signatures, cookies and authorization headers are
+    scrubbed before anything is written.
+*/
+class ReplayNetworkAccessManager : public SocialdNetworkAccessManager
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        Record,
+        Replay
+    };
+
+    explicit ReplayNetworkAccessManager(const QString &fixtureName, QObject *parent = 0);
+
+    static bool isConfigured();
+
+    Mode mode() const;
+    QString fixtureDirectory() const;
+
+    // the key of a request, and the file of its n'th occurrence, e.g. for
+    // tools which generate fixtures to replay.
+    static QString fixtureKey(QNetworkAccessManager::Operation op, const QNetworkRequest &req);
+    QString fixtureFileName(const QString &key, int occurrence) const;
+
+protected:
+    QNetworkReply *createRequest(QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData = 0) override;
+
+private:
+    QNetworkReply *recordRequest(QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData);
+    QNetworkReply *replayRequest(QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req);
+    void writeFixture(const QString &fileName, const QJsonObject &fixture);
+
+    Mode m_mode;
+    QString m_fixtureDirectory;
+    int m_replayLatency;
+    int m_replayBandwidth;
+    QHash<QString, int> m_occurrences;
+};
+
+/*
+    Reply which replays a recorded response.
+*/
+class FixtureReply : public ProxyReply
+{
+    Q_OBJECT
+
+public:
+    FixtureReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request, QObject *parent = 0);
+    ~FixtureReply();
+
+    // replays the given response after latency msecs, delivering the
+    // body at the given rate (or all at once if bytesPerSecond is <= 0).
+    void replay(const QJsonObject &fixture, int latency, int bytesPerSecond);
+
+    void abort() override;
+
+private Q_SLOTS:
+    void deliverReplayChunk();
+
+private:
+    QTimer m_replayTimer;
+    QByteArray m_replayBody;
+    int m_replayOffset;
+    int m_replayChunkSize;
+    QNetworkReply::NetworkError m_replayError;
+    QString m_replayErrorString;
+};
+
+#endif // SOCIALD_REPLAYNETWORKACCESSMANAGER_P_H
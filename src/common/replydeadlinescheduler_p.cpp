@@ -0,0 +1,436 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "replydeadlinescheduler_p.h"
+#include "hostlatencyestimator_p.h"
+#include "proxyreply_p.h"
+
+#include <QtCore/QList>
+#include <QtNetwork/QNetworkReply>
+
+namespace {
+    // 512 slots of 250 msec cover a little over two minutes, so the
+    // default 60 second timeout never needs more than one revolution.
+    const int TickInterval = 250; // msec
+    const int WheelSize = 512;
+
+    // the shortest time allowed for the response headers to arrive,
+    // however fast the host has been so far.
+    const int MinimumHeaderTimeout = 10000; // msec
+
+    // QNetworkAccessManager sends at most this many requests to a host
+    // at a time, further requests wait in its queue for a connection.
+    const int MaximumConnectionsPerHost = 6;
+
+    // slot of deadlines which are not in the wheel
+    const int ExpiringSlot = -1;
+    const int UnscheduledSlot = -2;
+}
+
+ReplyDeadlineScheduler::ReplyDeadlineScheduler(QObject *parent)
+    : QObject(parent)
+    , m_processedTick(0)
+    , m_immediateTickPending(false)
+    , m_wheel(WheelSize)
+{
+    m_timer.setInterval(TickInterval);
+    m_timer.setTimerType(Qt::CoarseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &ReplyDeadlineScheduler::tick);
+    m_clock.start();
+}
+
+ReplyDeadlineScheduler::~ReplyDeadlineScheduler()
+{
+}
+
+qint64 ReplyDeadlineScheduler::currentTick() const
+{
+    return m_clock.elapsed() / TickInterval;
+}
+
+qint64 ReplyDeadlineScheduler::ticks(int msecs)
+{
+    return qMax<qint64>(1, (msecs + TickInterval - 1) / TickInterval);
+}
+
+void ReplyDeadlineScheduler::arm(int accountId, QNetworkReply *reply, int idleMsecs)
+{
+    if (!reply) {
+        return;
+    }
+
+    disarm(reply);
+
+    const qint64 now = currentTick();
+    if (m_deadlines.isEmpty()) {
+        // nothing in the wheel, so there are no older slots left to process.
+        m_processedTick = now;
+    }
+
+    // the deadline is scheduled once the request has been sent.
+    Deadline deadline;
+    deadline.accountId = accountId;
+    deadline.idleMsecs = idleMsecs;
+    deadline.idleTicks = ticks(idleMsecs);
+    deadline.tick = now;
+    deadline.slot = UnscheduledSlot;
+    deadline.due = now;
+    deadline.phase = Waiting;
+    deadline.sentAt = -1;
+    deadline.measured = false;
+    deadline.host = reply->url().host();
+
+    m_deadlines.insert(reply, deadline);
+    m_accountReplies[accountId].insert(reply);
+
+    watch(reply);
+
+    // a proxy reply may not have sent its request yet.
+    ProxyReply *proxy = qobject_cast<ProxyReply*>(reply);
+    if (!proxy || proxy->source()) {
+        requestSent(reply);
+    }
+
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void ReplyDeadlineScheduler::watch(QNetworkReply *reply)
+{
+    // the adaptor may delete a reply without disarming it first,
+    // which would leave a dangling pointer in the wheel.
+    connect(reply, &QObject::destroyed, this, [this, reply] {
+        QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+        if (it != m_deadlines.end()) {
+            remove(reply, it);
+        }
+    });
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply] {
+        headersReceived(reply);
+    });
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply] {
+        progressed(reply);
+    });
+    connect(reply, &QNetworkReply::uploadProgress, this, [this, reply] (qint64 bytesSent) {
+        if (bytesSent > 0) {
+            sentFromQueue(reply);
+        }
+        progressed(reply);
+    });
+    connect(reply, &QNetworkReply::encrypted, this, [this, reply] {
+        sentFromQueue(reply);
+    });
+
+    ProxyReply *proxy = qobject_cast<ProxyReply*>(reply);
+    if (proxy) {
+        connect(proxy, &ProxyReply::requestStarted, this, [this, reply] {
+            requestSent(reply);
+        });
+        connect(proxy, &ProxyReply::requestPending, this, [this, reply] {
+            requestPending(reply);
+        });
+    }
+}
+
+// Moves the reply to the slot of the given tick.
+void ReplyDeadlineScheduler::place(QNetworkReply *reply, Deadline &deadline, qint64 tick)
+{
+    if (deadline.slot == ExpiringSlot) {
+        return;
+    }
+
+    if (deadline.slot != UnscheduledSlot) {
+        m_wheel[deadline.slot].remove(reply);
+    }
+    deadline.tick = tick;
+    deadline.slot = static_cast<int>(tick % WheelSize);
+    m_wheel[deadline.slot].insert(reply);
+}
+
+void ReplyDeadlineScheduler::setDue(QNetworkReply *reply, Deadline &deadline, qint64 due)
+{
+    deadline.due = due;
+    if (due < deadline.tick || deadline.slot == UnscheduledSlot) {
+        place(reply, deadline, due);
+    }
+}
+
+// Starts the time allowed for the response headers to arrive.
+void ReplyDeadlineScheduler::startHeaderClock(QNetworkReply *reply, Deadline &deadline, bool measured)
+{
+    const int headerTimeout = HostLatencyEstimator::instance()->firstByteTimeout(
+                deadline.host, MinimumHeaderTimeout, deadline.idleMsecs);
+    deadline.phase = AwaitingHeaders;
+    deadline.sentAt = m_clock.elapsed();
+    deadline.measured = measured;
+    m_sendingCount[deadline.host] += 1;
+    setDue(reply, deadline, currentTick() + ticks(headerTimeout));
+}
+
+void ReplyDeadlineScheduler::requestSent(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end() || it->phase != Waiting) {
+        return;
+    }
+
+    if (m_sendingCount.value(it->host) < MaximumConnectionsPerHost) {
+        startHeaderClock(reply, *it, true);
+        return;
+    }
+
+    // the request waits for a connection in the queue of the network
+    // access manager, which the header deadline must not include.
+    // Until a connection is free it only has the idle timeout.
+    it->phase = Queued;
+    m_queued[it->host].append(reply);
+    setDue(reply, *it, currentTick() + it->idleTicks);
+}
+
+// The reply has shown that its request is on the wire.
+void ReplyDeadlineScheduler::sentFromQueue(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end() || it->phase != Queued) {
+        return;
+    }
+
+    m_queued[it->host].removeOne(reply);
+    startHeaderClock(reply, *it, true);
+}
+
+// Takes the reply off its host, and starts the header clock of the
+// queued requests which the freed connection is now sending.
+void ReplyDeadlineScheduler::leaveHost(QNetworkReply *reply, Deadline &deadline)
+{
+    if (deadline.phase == Queued) {
+        m_queued[deadline.host].removeOne(reply);
+    } else if (deadline.phase != Waiting) {
+        m_sendingCount[deadline.host] -= 1;
+    }
+
+    QHash<QString, QList<QNetworkReply*> >::iterator queue = m_queued.find(deadline.host);
+    while (queue != m_queued.end() && !queue->isEmpty()
+           && m_sendingCount.value(deadline.host) < MaximumConnectionsPerHost) {
+        QNetworkReply *next = queue->takeFirst();
+        // the time at which the request left the queue is only approximate,
+        // so it doesn't tell the latency of the host.
+        startHeaderClock(next, m_deadlines[next], false);
+    }
+    if (queue != m_queued.end() && queue->isEmpty()) {
+        m_queued.erase(queue);
+    }
+    if (m_sendingCount.value(deadline.host) <= 0) {
+        m_sendingCount.remove(deadline.host);
+    }
+}
+
+void ReplyDeadlineScheduler::requestPending(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end()) {
+        return;
+    }
+
+    // e.g. backing off before a retry, which may take longer than the timeout.
+    leaveHost(reply, *it);
+    it->phase = Waiting;
+    it->sentAt = -1;
+    if (it->slot >= 0) {
+        m_wheel[it->slot].remove(reply);
+        it->slot = UnscheduledSlot;
+    }
+}
+
+void ReplyDeadlineScheduler::headersReceived(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end()) {
+        return;
+    }
+
+    if (it->phase == Queued) {
+        m_queued[it->host].removeOne(reply);
+        m_sendingCount[it->host] += 1;
+    }
+
+    // uploads are included in the time until the headers arrive,
+    // so only requests without a body tell the latency of the host.
+    if (it->phase == AwaitingHeaders && it->measured
+            && (reply->operation() == QNetworkAccessManager::GetOperation
+                || reply->operation() == QNetworkAccessManager::HeadOperation
+                || reply->operation() == QNetworkAccessManager::DeleteOperation)) {
+        HostLatencyEstimator::instance()->addSample(it->host, m_clock.elapsed() - it->sentAt);
+    }
+
+    it->phase = Transferring;
+    setDue(reply, *it, currentTick() + it->idleTicks);
+}
+
+void ReplyDeadlineScheduler::progressed(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end() || it->phase == Waiting || it->phase == Queued) {
+        return;
+    }
+
+    it->phase = Transferring;
+    setDue(reply, *it, currentTick() + it->idleTicks);
+}
+
+bool ReplyDeadlineScheduler::disarm(QNetworkReply *reply)
+{
+    QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+    if (it == m_deadlines.end()) {
+        return false;
+    }
+
+    remove(reply, it);
+    disconnect(reply, nullptr, this, nullptr);
+    return true;
+}
+
+void ReplyDeadlineScheduler::remove(QNetworkReply *reply, QHash<QNetworkReply*, Deadline>::iterator it)
+{
+    leaveHost(reply, *it);
+    if (it->slot >= 0) {
+        m_wheel[it->slot].remove(reply);
+    } else if (it->slot == ExpiringSlot) {
+        m_due.remove(reply);
+    }
+
+    QHash<int, QSet<QNetworkReply*> >::iterator ait = m_accountReplies.find(it->accountId);
+    if (ait != m_accountReplies.end()) {
+        ait->remove(reply);
+        if (ait->isEmpty()) {
+            m_accountReplies.erase(ait);
+        }
+    }
+
+    m_deadlines.erase(it);
+    if (m_deadlines.isEmpty()) {
+        m_timer.stop();
+    }
+}
+
+bool ReplyDeadlineScheduler::isArmed(QNetworkReply *reply) const
+{
+    return m_deadlines.contains(reply);
+}
+
+int ReplyDeadlineScheduler::count() const
+{
+    return m_deadlines.size();
+}
+
+void ReplyDeadlineScheduler::expireAccount(int accountId)
+{
+    const QSet<QNetworkReply*> replies = m_accountReplies.value(accountId);
+    if (replies.isEmpty()) {
+        return;
+    }
+
+    Q_FOREACH (QNetworkReply *reply, replies) {
+        Deadline &deadline = m_deadlines[reply];
+        if (deadline.slot != ExpiringSlot) {
+            if (deadline.slot >= 0) {
+                m_wheel[deadline.slot].remove(reply);
+            }
+            deadline.slot = ExpiringSlot;
+            m_due.insert(reply);
+        }
+    }
+
+    scheduleImmediateTick();
+}
+
+void ReplyDeadlineScheduler::expireAll()
+{
+    const QList<int> accountIds = m_accountReplies.keys();
+    Q_FOREACH (int accountId, accountIds) {
+        expireAccount(accountId);
+    }
+}
+
+void ReplyDeadlineScheduler::scheduleImmediateTick()
+{
+    // expire the replies asynchronously, as the finished() handlers
+    // of the replies may cause the adaptor to finalize the sync.
+    if (!m_immediateTickPending) {
+        m_immediateTickPending = true;
+        QMetaObject::invokeMethod(this, "tick", Qt::QueuedConnection);
+    }
+}
+
+void ReplyDeadlineScheduler::tick()
+{
+    m_immediateTickPending = false;
+
+    QList<QNetworkReply*> expiredReplies = m_due.values();
+    m_due.clear();
+
+    // walk every slot which has come due since the last tick.  If the
+    // event loop was blocked for more than a whole revolution, every
+    // slot needs to be checked once.
+    QList<QNetworkReply*> movedReplies;
+    const qint64 now = currentTick();
+    const qint64 first = qMax(m_processedTick + 1, now - WheelSize + 1);
+    for (qint64 t = first; t <= now; ++t) {
+        QSet<QNetworkReply*> &slot(m_wheel[static_cast<int>(t % WheelSize)]);
+        QSet<QNetworkReply*>::iterator it = slot.begin();
+        while (it != slot.end()) {
+            Deadline &deadline = m_deadlines[*it];
+            if (deadline.tick > now) {
+                ++it;
+            } else if (deadline.due > now) {
+                // the reply has made progress since it was placed in this slot.
+                deadline.tick = deadline.due;
+                deadline.slot = static_cast<int>(deadline.due % WheelSize);
+                movedReplies.append(*it);
+                it = slot.erase(it);
+            } else {
+                deadline.slot = ExpiringSlot;
+                expiredReplies.append(*it);
+                it = slot.erase(it);
+            }
+        }
+    }
+    m_processedTick = qMax(m_processedTick, now);
+    Q_FOREACH (QNetworkReply *reply, movedReplies) {
+        m_wheel[m_deadlines.value(reply).slot].insert(reply);
+    }
+
+    // the expired() handlers may arm or disarm other replies,
+    // so re-check that each reply is still armed before emitting.
+    Q_FOREACH (QNetworkReply *reply, expiredReplies) {
+        QHash<QNetworkReply*, Deadline>::iterator it = m_deadlines.find(reply);
+        if (it == m_deadlines.end()) {
+            continue;
+        }
+        const int accountId = it->accountId;
+        disarm(reply);
+        emit expired(accountId, reply);
+    }
+
+    if (m_deadlines.isEmpty()) {
+        m_timer.stop();
+    }
+}
@@ -0,0 +1,134 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_REPLYDEADLINESCHEDULER_P_H
+#define SOCIALD_REPLYDEADLINESCHEDULER_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+class QNetworkReply;
+
+/*
+    Tracks the timeout deadline of every outstanding network reply
+    of a sync adaptor using a hashed timer wheel driven by a single
+    QTimer.  Arming and disarming a reply are O(1) operations, and
+    the timer only runs while at least one deadline is armed.
+
+    The timeout given to arm() is an idle timeout: it is restarted
+    whenever data is sent or received, so slow transfers which make
+    progress are not cut off.  Until the response headers arrive,
+    the deadline is instead based on the latency observed for the
+    host (see HostLatencyEstimator), so requests on dead connections
+    fail early.  Replies which are waiting to be sent (e.g. held by
+    the rate limiter or backing off before a retry) have no deadline
+    until their request is sent, as the wait may legitimately be
+    longer than the timeout.  Progress only moves the deadline
+    lazily, it is re-checked when its slot comes due.
+
+    The network access manager only sends a few requests to a host
+    at a time, and queues the rest.  The scheduler follows that queue
+    per host: a queued request only has the idle timeout, and the
+    header deadline starts once the request is on the wire, i.e. when
+    a connection of the host is freed, or the reply reports that it
+    has been encrypted or has uploaded data.  Only requests which
+    were sent straight away provide latency samples to the estimator.
+
+    A reply which is destroyed while armed is disarmed automatically.
+    When a deadline passes, expired() is emitted for the reply.
+    expireAccount() and expireAll() force the deadlines of the
+    affected replies to pass during the next event loop iteration.
+*/
+class ReplyDeadlineScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplyDeadlineScheduler(QObject *parent = nullptr);
+    ~ReplyDeadlineScheduler();
+
+    void arm(int accountId, QNetworkReply *reply, int idleMsecs);
+    bool disarm(QNetworkReply *reply);
+    bool isArmed(QNetworkReply *reply) const;
+    int count() const;
+
+    void expireAccount(int accountId);
+    void expireAll();
+
+Q_SIGNALS:
+    void expired(int accountId, QNetworkReply *reply);
+
+private Q_SLOTS:
+    void tick();
+
+private:
+    enum Phase {
+        Waiting,        // the request has not been sent yet
+        Queued,         // waiting for a connection to the host
+        AwaitingHeaders,
+        Transferring
+    };
+
+    struct Deadline {
+        int accountId;
+        qint64 tick; // the slot position
+        int slot; // ExpiringSlot if forced to expire, UnscheduledSlot while Waiting
+        qint64 due; // the tick at which the reply expires, >= tick
+        int idleTicks;
+        int idleMsecs;
+        Phase phase;
+        qint64 sentAt; // msec
+        bool measured; // whether sentAt is when the request went on the wire
+        QString host;
+    };
+
+    qint64 currentTick() const;
+    static qint64 ticks(int msecs);
+    void scheduleImmediateTick();
+    void place(QNetworkReply *reply, Deadline &deadline, qint64 tick);
+    void setDue(QNetworkReply *reply, Deadline &deadline, qint64 due);
+    void remove(QNetworkReply *reply, QHash<QNetworkReply*, Deadline>::iterator it);
+    void watch(QNetworkReply *reply);
+    void startHeaderClock(QNetworkReply *reply, Deadline &deadline, bool measured);
+    void requestSent(QNetworkReply *reply);
+    void sentFromQueue(QNetworkReply *reply);
+    void leaveHost(QNetworkReply *reply, Deadline &deadline);
+    void requestPending(QNetworkReply *reply);
+    void headersReceived(QNetworkReply *reply);
+    void progressed(QNetworkReply *reply);
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_processedTick;
+    bool m_immediateTickPending;
+    QVector<QSet<QNetworkReply*> > m_wheel;
+    QSet<QNetworkReply*> m_due;
+    QHash<QNetworkReply*, Deadline> m_deadlines;
+    QHash<int, QSet<QNetworkReply*> > m_accountReplies;
+    QHash<QString, int> m_sendingCount; // replies holding a connection, per host
+    QHash<QString, QList<QNetworkReply*> > m_queued;
+};
+
+#endif // SOCIALD_REPLYDEADLINESCHEDULER_P_H
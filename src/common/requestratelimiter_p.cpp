@@ -0,0 +1,131 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "requestratelimiter_p.h"
+
+#include <QtCore/QtMath>
+
+namespace {
+    // the pace of the requests held back by a block to a host without a limit.
+    const double RecoveryRequestsPerSecond = 1.0;
+}
+
+RequestRateLimiter::RequestRateLimiter()
+{
+    m_clock.start();
+}
+
+void RequestRateLimiter::setLimit(const QString &host, double requestsPerSecond, int burst)
+{
+    if (requestsPerSecond <= 0) {
+        removeLimit(host);
+        return;
+    }
+
+    Limit limit;
+    limit.rate = requestsPerSecond / 1000.0;
+    limit.burst = qMax(1, burst);
+    m_limits.insert(host.toLower(), limit);
+}
+
+void RequestRateLimiter::removeLimit(const QString &host)
+{
+    m_limits.remove(host.toLower());
+}
+
+const RequestRateLimiter::Limit *RequestRateLimiter::findLimit(const QString &host) const
+{
+    // check the host itself, then each of its parent domains.
+    QString domain = host.toLower();
+    while (!domain.isEmpty()) {
+        QHash<QString, Limit>::const_iterator it = m_limits.constFind(domain);
+        if (it != m_limits.constEnd()) {
+            return &it.value();
+        }
+        const int dot = domain.indexOf(QLatin1Char('.'));
+        if (dot < 0) {
+            break;
+        }
+        domain = domain.mid(dot + 1);
+    }
+    return 0;
+}
+
+qint64 RequestRateLimiter::reserve(const QString &host)
+{
+    const Limit *limit = findLimit(host);
+    const QString key = host.toLower();
+    QHash<QString, Bucket>::iterator it = m_buckets.find(key);
+    if (!limit && it == m_buckets.end()) {
+        return 0;
+    }
+
+    Limit recovery;
+    recovery.rate = RecoveryRequestsPerSecond / 1000.0;
+    recovery.burst = 1;
+    const Limit &pace(limit ? *limit : recovery);
+
+    const qint64 now = m_clock.elapsed();
+    if (it == m_buckets.end()) {
+        it = m_buckets.insert(key, Bucket());
+    }
+    Bucket &b(*it);
+
+    // the bucket isn't refilled before the end of a block.
+    const qint64 start = qMax(now, b.blockedUntil);
+    if (b.updated < 0) {
+        b.tokens = pace.burst;
+        b.updated = start;
+    } else if (start > b.updated) {
+        b.tokens = qMin<double>(pace.burst, b.tokens + (start - b.updated) * pace.rate);
+        b.updated = start;
+    }
+
+    if (!limit && b.blockedUntil <= now && b.tokens >= pace.burst) {
+        // the held back requests have all been sent, there is nothing else to track.
+        m_buckets.erase(it);
+        return 0;
+    }
+
+    // the token may be borrowed from the future, in which case the
+    // request has to wait until the bucket has refilled.
+    b.tokens -= 1;
+    qint64 wait = b.updated - now;
+    if (b.tokens < 0) {
+        wait += qCeil(-b.tokens / pace.rate);
+    }
+    return wait;
+}
+
+void RequestRateLimiter::block(const QString &host, qint64 msecs)
+{
+    if (msecs <= 0) {
+        return;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    Bucket &b(m_buckets[host.toLower()]);
+    b.blockedUntil = qMax(b.blockedUntil, now + msecs);
+
+    // the requests held back by the block are paced from its end,
+    // starting with a single token.
+    b.tokens = b.updated < 0 ? 1 : qMin<double>(b.tokens, 1);
+    b.updated = qMax(b.updated, b.blockedUntil);
+}
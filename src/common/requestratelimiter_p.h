@@ -0,0 +1,81 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_REQUESTRATELIMITER_P_H
+#define SOCIALD_REQUESTRATELIMITER_P_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+/*
+    Token bucket rate limiter for outgoing requests.
+
+    A limit is configured per host, and applies to the host and all of
+    its subdomains.  Requests are counted in a bucket per host, which
+    holds up to burst tokens and is refilled at the configured rate.
+    The accounts of an adaptor are synced one after another, so there
+    is no need for separate buckets per account.
+
+    reserve() never rejects a request: it takes a token and returns how
+    long the caller has to wait until the token is actually available,
+    so that requests issued in a burst are spread out in order.
+
+    Independently of the configured limits, any host can be blocked for
+    a while, e.g. when the server has asked the client to back off with
+    a 429 response.  The bucket is refilled from the end of the block
+    only, starting with a single token, so the requests which were held
+    back are paced instead of all being sent when the block ends.  Hosts
+    without a limit are paced at a modest recovery rate until the held
+    back requests have been sent.
+*/
+class RequestRateLimiter
+{
+public:
+    RequestRateLimiter();
+
+    void setLimit(const QString &host, double requestsPerSecond, int burst);
+    void removeLimit(const QString &host);
+
+    // returns the number of msecs to wait before sending the request.
+    qint64 reserve(const QString &host);
+    void block(const QString &host, qint64 msecs);
+
+private:
+    struct Limit {
+        double rate;    // tokens per msec
+        int burst;
+    };
+
+    struct Bucket {
+        Bucket() : tokens(0), updated(-1), blockedUntil(0) {}
+        double tokens;      // at the time updated
+        qint64 updated;     // may be in the future while blocked
+        qint64 blockedUntil;
+    };
+
+    const Limit *findLimit(const QString &host) const;
+
+    QElapsedTimer m_clock;
+    QHash<QString, Limit> m_limits;
+    QHash<QString, Bucket> m_buckets;
+};
+
+#endif // SOCIALD_REQUESTRATELIMITER_P_H
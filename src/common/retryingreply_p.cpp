@@ -0,0 +1,155 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "retryingreply_p.h"
+#include "trace.h"
+
+#include <QtCore/QTimer>
+
+#include <random>
+
+namespace {
+    const int InitialBackoff = 1000; // msec
+    const int MaximumBackoff = 16000; // msec
+}
+
+RetryingReply::RetryingReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request,
+                             int maxRetries, QObject *parent)
+    : ProxyReply(op, request, parent)
+    , m_maxRetries(maxRetries)
+    , m_retryCount(0)
+    , m_discarding(false)
+    , m_forwarded(false)
+{
+}
+
+bool RetryingReply::isIdempotent(QNetworkAccessManager::Operation op)
+{
+    return op == QNetworkAccessManager::GetOperation
+            || op == QNetworkAccessManager::HeadOperation
+            || op == QNetworkAccessManager::PutOperation
+            || op == QNetworkAccessManager::DeleteOperation;
+}
+
+int RetryingReply::retryCount() const
+{
+    return m_retryCount;
+}
+
+bool RetryingReply::canRetry() const
+{
+    return !m_forwarded && m_retryCount < m_maxRetries;
+}
+
+bool RetryingReply::isTransientStatus(int httpStatus) const
+{
+    switch (httpStatus) {
+    case 429:
+    case 503:
+        return true;
+    case 500:
+    case 502:
+    case 504:
+        // the server may have applied the request.
+        return operation() == QNetworkAccessManager::GetOperation
+                || operation() == QNetworkAccessManager::HeadOperation;
+    default:
+        return false;
+    }
+}
+
+bool RetryingReply::isTransientError(QNetworkReply::NetworkError error) const
+{
+    switch (error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+        return true;
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        // the connection may have dropped after the request was sent.
+        return operation() == QNetworkAccessManager::GetOperation
+                || operation() == QNetworkAccessManager::HeadOperation;
+    default:
+        return false;
+    }
+}
+
+void RetryingReply::sourceMetaDataChanged(QNetworkReply *source)
+{
+    const int httpStatus = source->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    m_discarding = canRetry() && isTransientStatus(httpStatus);
+    if (!m_discarding) {
+        ProxyReply::sourceMetaDataChanged(source);
+    }
+}
+
+void RetryingReply::sourceReadyRead(QNetworkReply *source)
+{
+    if (m_discarding) {
+        source->readAll();
+        return;
+    }
+
+    const QByteArray data = source->readAll();
+    m_forwarded = m_forwarded || !data.isEmpty();
+    appendData(data);
+}
+
+void RetryingReply::sourceFinished(QNetworkReply *source)
+{
+    if (m_discarding || (canRetry() && isTransientError(source->error()))) {
+        scheduleRetry(source);
+        return;
+    }
+
+    ProxyReply::sourceFinished(source);
+}
+
+// "equal jitter": half of the exponential backoff, plus a random part of
+// the other half, so that clients which failed together don't retry together.
+int RetryingReply::backoff() const
+{
+    static std::minstd_rand generator(std::random_device{}());
+    const int delay = qMin(MaximumBackoff, InitialBackoff << qMin(m_retryCount, 16));
+    std::uniform_int_distribution<int> jitter(0, delay / 2);
+    return delay / 2 + jitter(generator);
+}
+
+void RetryingReply::scheduleRetry(QNetworkReply *source)
+{
+    const int delay = backoff();
+    qCDebug(lcSocialPlugin) << "request to" << url().host() << "failed with status"
+                            << source->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()
+                            << "error" << source->error() << "- retrying in" << delay << "msec";
+
+    releaseSource();
+    m_discarding = false;
+    m_retryCount += 1;
+    setProperty("retryCount", m_retryCount);
+
+    QTimer::singleShot(delay, this, [this] {
+        if (!isFinished()) {
+            emit retryRequested();
+        }
+    });
+}
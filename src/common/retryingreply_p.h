@@ -0,0 +1,74 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_RETRYINGREPLY_P_H
+#define SOCIALD_RETRYINGREPLY_P_H
+
+#include "proxyreply_p.h"
+
+/*
+    Reply which transparently reissues its request after transient
+    failures (429, 5xx, and connection errors), waiting for a capped
+    exponential backoff with jitter between the attempts.
+
+    Only idempotent requests are retried: GET and HEAD after any
+    transient failure, PUT and DELETE only if the server can't have
+    applied the request (429, 503, or no connection).  Once data of a
+    response has been passed on to the reader the request is never
+    retried.  The reply only finishes once, so the callers' bookkeeping
+    is unaffected; the "retryCount" property of the reply is the number
+    of retries which were made.
+
+    The manager which creates the reply sends each attempt when
+    retryRequested() is emitted, and passes the real reply to forward().
+*/
+class RetryingReply : public ProxyReply
+{
+    Q_OBJECT
+
+public:
+    RetryingReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request,
+                  int maxRetries, QObject *parent = 0);
+
+    static bool isIdempotent(QNetworkAccessManager::Operation op);
+    int retryCount() const;
+
+Q_SIGNALS:
+    void retryRequested();
+
+protected:
+    void sourceMetaDataChanged(QNetworkReply *source) override;
+    void sourceReadyRead(QNetworkReply *source) override;
+    void sourceFinished(QNetworkReply *source) override;
+
+private:
+    bool canRetry() const;
+    bool isTransientStatus(int httpStatus) const;
+    bool isTransientError(QNetworkReply::NetworkError error) const;
+    void scheduleRetry(QNetworkReply *source);
+    int backoff() const;
+
+    int m_maxRetries;
+    int m_retryCount;
+    bool m_discarding;
+    bool m_forwarded;
+};
+
+#endif // SOCIALD_RETRYINGREPLY_P_H
@@ -0,0 +1,162 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "sharedslotscheduler_p.h"
+#include "trace.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+    const quint32 StateMagic = 0x534c4f54; // "SLOT"
+    const quint32 StateVersion = 1;
+    const int BootIdSize = 36;
+}
+
+struct SharedSlotScheduler::SharedState
+{
+    quint32 magic;
+    quint32 version;
+    char bootId[BootIdSize];
+    qint64 nextSlot;
+};
+
+SharedSlotScheduler::SharedSlotScheduler(const QString &fileName, int interval)
+    : m_fileName(fileName)
+    , m_interval(interval)
+    , m_fd(-1)
+    , m_state(0)
+    , m_mapFailed(false)
+    , m_localNextSlot(0)
+{
+}
+
+SharedSlotScheduler::~SharedSlotScheduler()
+{
+    if (m_state) {
+        munmap(m_state, sizeof(SharedState));
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+qint64 SharedSlotScheduler::monotonicMsecs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+QByteArray SharedSlotScheduler::bootId()
+{
+    static QByteArray id;
+    if (id.isEmpty()) {
+        QFile file(QStringLiteral("/proc/sys/kernel/random/boot_id"));
+        if (file.open(QIODevice::ReadOnly)) {
+            id = file.readAll().trimmed().left(BootIdSize);
+        }
+        id = id.leftJustified(BootIdSize, '\0', true);
+    }
+    return id;
+}
+
+bool SharedSlotScheduler::map()
+{
+    if (m_state) {
+        return true;
+    }
+    if (m_mapFailed) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    const QByteArray path = QFile::encodeName(m_fileName);
+    // only the sync processes of this user may touch the schedule.
+    m_fd = open(path.constData(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOCTTY | O_NOFOLLOW, 0600);
+    if (m_fd >= 0) {
+        struct stat buf;
+        if (fstat(m_fd, &buf) == 0
+                && ((buf.st_mode & 0077) == 0 || fchmod(m_fd, 0600) == 0)
+                && (buf.st_size >= off_t(sizeof(SharedState)) || ftruncate(m_fd, sizeof(SharedState)) == 0)) {
+            void *addr = mmap(0, sizeof(SharedState), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (addr != MAP_FAILED) {
+                m_state = static_cast<SharedState *>(addr);
+                return true;
+            }
+        }
+    }
+
+    qCWarning(lcSocialPlugin) << "unable to map request slot state" << m_fileName << ":" << strerror(errno)
+                              << "- only coordinating requests within this process";
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_mapFailed = true;
+    return false;
+}
+
+qint64 SharedSlotScheduler::reserve()
+{
+    const QByteArray id = bootId();
+    qint64 now = monotonicMsecs();
+
+    int rv = -1;
+    if (map()) {
+        do {
+            rv = flock(m_fd, LOCK_EX);
+        } while (rv != 0 && errno == EINTR);
+    }
+
+    if (rv != 0) {
+        const qint64 slot = qMax(now, m_localNextSlot);
+        m_localNextSlot = slot + m_interval;
+        return slot - now;
+    }
+
+    // the lock may have taken a while to acquire.
+    now = monotonicMsecs();
+    if (m_state->magic != StateMagic
+            || m_state->version != StateVersion
+            || memcmp(m_state->bootId, id.constData(), BootIdSize) != 0) {
+        // a new file, or one left over from before a reboot.
+        m_state->magic = StateMagic;
+        m_state->version = StateVersion;
+        memcpy(m_state->bootId, id.constData(), BootIdSize);
+        m_state->nextSlot = now;
+    }
+
+    const qint64 slot = qMax(now, m_state->nextSlot);
+    m_state->nextSlot = slot + m_interval;
+
+    flock(m_fd, LOCK_UN);
+    return slot - now;
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_SHAREDSLOTSCHEDULER_P_H
+#define SOCIALD_SHAREDSLOTSCHEDULER_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+
+/*
+    Hands out send slots which are at least interval msecs apart,
+    across all processes which use the same state file.
+
+    The state (the next free slot, on the monotonic clock) lives in a
+    small memory mapped file, and is only accessed while holding an
+    exclusive flock() on it, so reserving a slot is a single atomic
+    read-modify-write without any further syscalls on the file.  The
+    state is reset after a reboot, as the monotonic clock restarts.
+
+    If the state file can not be mapped, the slots are only
+    coordinated within the process.
+*/
+class SharedSlotScheduler
+{
+public:
+    SharedSlotScheduler(const QString &fileName, int interval);
+    ~SharedSlotScheduler();
+
+    // reserves the next free slot, and returns the msecs until it.
+    qint64 reserve();
+
+private:
+    struct SharedState;
+
+    bool map();
+    static qint64 monotonicMsecs();
+    static QByteArray bootId();
+
+    QString m_fileName;
+    int m_interval;
+    int m_fd;
+    SharedState *m_state;
+    bool m_mapFailed;
+    qint64 m_localNextSlot;
+};
+
+#endif // SOCIALD_SHAREDSLOTSCHEDULER_P_H
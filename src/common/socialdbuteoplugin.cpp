@@ -21,6 +21,9 @@
 
 #include "socialdbuteoplugin.h"
 #include "socialnetworksyncadaptor.h"
+#include "synccheckpointstore_p.h"
+#include "accesstokenbroker_p.h"
+#include "syncprofileindex_p.h"
 #include "trace.h"
 
 #include <QCoreApplication>
@@ -38,6 +41,12 @@
 
 namespace {
     const QString SyncProfileTemplatesKey = QStringLiteral("sync_profile_templates");
+    const QString SyncAccountsInProcessKey = QStringLiteral("sync_accounts_in_process");
+    const QString MeteredTransferBudgetKey = QStringLiteral("metered_transfer_budget"); // KiB
+
+    // Buteo has no way to report a progress percentage, so it is signalled separately.
+    const QString ProgressObjectPath = QStringLiteral("/sociald/progress");
+    const QString ProgressInterface = QStringLiteral("org.sailfishos.sociald.Progress");
 
     QString SyncProfileIdKey(const QString &templateProfileName)
     {
@@ -120,11 +129,15 @@ SocialdButeoPlugin::SocialdButeoPlugin(const QString& pluginName,
     , m_socialServiceName(socialServiceName)
     , m_dataTypeName(dataTypeName)
     , m_profileAccountId(0)
+    , m_syncingAccountsInProcess(false)
+    , m_accountSyncFailed(false)
+    , m_syncStatusChanged(false)
 {
 }
 
 SocialdButeoPlugin::~SocialdButeoPlugin()
 {
+    qDeleteAll(m_pendingAccountProfiles);
 }
 
 bool SocialdButeoPlugin::init()
@@ -134,6 +147,13 @@ bool SocialdButeoPlugin::init()
     if (m_socialNetworkSyncAdaptor) {
         connect(m_socialNetworkSyncAdaptor, &SocialNetworkSyncAdaptor::statusChanged,
                 this, &SocialdButeoPlugin::syncStatusChanged);
+        connect(m_socialNetworkSyncAdaptor, &SocialNetworkSyncAdaptor::progressChanged,
+                this, [this] (int percent) {
+            QDBusMessage signal = QDBusMessage::createSignal(ProgressObjectPath, ProgressInterface,
+                                                             QStringLiteral("syncProgress"));
+            signal.setArguments(QVariantList() << getProfileName() << percent);
+            QDBusConnection::sessionBus().send(signal);
+        });
         return true;
     }
 
@@ -155,20 +175,34 @@ bool SocialdButeoPlugin::startSync()
         QList<Buteo::SyncProfile*> perAccountProfiles = ensurePerAccountSyncProfilesExist();
         m_socialNetworkSyncAdaptor->setAccountSyncProfile(NULL);
 
-        // we need to trigger sync with each profile separately,
-        // or (due to scheduling/etc) another plugin instance might
-        // be created to sync that profile at the same time, and
-        // we don't handle concurrency.
-        foreach (Buteo::SyncProfile *perAccountProfile, perAccountProfiles) {
-            QDBusMessage message = QDBusMessage::createMethodCall(
-                    "com.meego.msyncd", "/synchronizer", "com.meego.msyncd", "startSync");
-            message.setArguments(QVariantList() << perAccountProfile->name());
-            QDBusConnection::sessionBus().asyncCall(message);
+        if (profile().boolKey(SyncAccountsInProcessKey, false)) {
+            // sync every account from this process, one after another,
+            // once the purge sync below has finished.
+            qDeleteAll(m_pendingAccountProfiles);
+            m_pendingAccountProfiles.clear();
+            Q_FOREACH (Buteo::SyncProfile *perAccountProfile, perAccountProfiles) {
+                if (perAccountProfile->isEnabled()) {
+                    m_pendingAccountProfiles.append(perAccountProfile);
+                } else {
+                    delete perAccountProfile;
+                }
+            }
+            m_syncingAccountsInProcess = !m_pendingAccountProfiles.isEmpty();
+            m_accountSyncFailed = false;
+        } else {
+            triggerAccountSyncs(perAccountProfiles);
+            qDeleteAll(perAccountProfiles);
         }
     } else {
         m_socialNetworkSyncAdaptor->setAccountSyncProfile(profile().clone());
     }
 
+    bool ok = false;
+    const qint64 meteredBudget = profile().key(MeteredTransferBudgetKey).toLongLong(&ok);
+    if (ok && m_socialNetworkSyncAdaptor) {
+        m_socialNetworkSyncAdaptor->setMeteredTransferBudget(meteredBudget * 1024);
+    }
+
     // now perform sync.  Note that for the template profile case, this will
     // result in a purge operation occurring (checking for removed accounts and
     // purging any synced data associated with those accounts).
@@ -185,9 +219,55 @@ bool SocialdButeoPlugin::startSync()
     } else {
         qCDebug(lcSocialPlugin) << "no enabled" << m_socialServiceName << "sync adaptor for" << m_dataTypeName;
     }
+    m_syncingAccountsInProcess = false;
+    qDeleteAll(m_pendingAccountProfiles);
+    m_pendingAccountProfiles.clear();
     return false;
 }
 
+// Triggers the sync of each per-account profile via msyncd.
+// msyncd has no call which takes a list of profiles, so the calls are
+// all queued without waiting for the replies, and msyncd queues the
+// syncs itself.  Disabled profiles would be rejected by msyncd anyway.
+void SocialdButeoPlugin::triggerAccountSyncs(const QList<Buteo::SyncProfile*> &perAccountProfiles)
+{
+    // we need to trigger sync with each profile separately,
+    // or (due to scheduling/etc) another plugin instance might
+    // be created to sync that profile at the same time, and
+    // we don't handle concurrency.
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    Q_FOREACH (Buteo::SyncProfile *perAccountProfile, perAccountProfiles) {
+        if (!perAccountProfile->isEnabled()) {
+            continue;
+        }
+        QDBusMessage message = QDBusMessage::createMethodCall(
+                "com.meego.msyncd", "/synchronizer", "com.meego.msyncd", "startSync");
+        message.setArguments(QVariantList() << perAccountProfile->name());
+        bus.asyncCall(message);
+    }
+}
+
+void SocialdButeoPlugin::syncNextAccount()
+{
+    if (m_pendingAccountProfiles.isEmpty() || !m_socialNetworkSyncAdaptor) {
+        return;
+    }
+
+    Buteo::SyncProfile *accountProfile = m_pendingAccountProfiles.takeFirst();
+    const int accountId = accountProfile->key(Buteo::KEY_ACCOUNT_ID).toInt();
+    qCDebug(lcSocialPlugin) << "performing in-process sync of" << m_dataTypeName << "from" << m_socialServiceName
+                            << "for account" << accountId;
+    m_socialNetworkSyncAdaptor->setAccountSyncProfile(accountProfile);
+    m_syncStatusChanged = false;
+    m_socialNetworkSyncAdaptor->sync(m_dataTypeName, accountId);
+    if (!m_syncStatusChanged) {
+        // the sync ended before it started, e.g. with the same error as the
+        // previous account, so no status change will move the chain along.
+        qCInfo(lcSocialPlugin) << "sync of account" << accountId << "ended without starting";
+        syncStatusChanged();
+    }
+}
+
 void SocialdButeoPlugin::abortSync(Sync::SyncStatus status)
 {
     // note: it seems buteo automatically calls abortSync on network connectivity loss...
@@ -206,6 +286,8 @@ bool SocialdButeoPlugin::cleanUp()
     if (m_socialNetworkSyncAdaptor && m_profileAccountId > 0) {
         m_socialNetworkSyncAdaptor->purgeDataForOldAccount(m_profileAccountId,
                                                            SocialNetworkSyncAdaptor::CleanUpPurge);
+        SyncCheckpointStore::removeAccount(m_socialServiceName, m_dataTypeName, m_profileAccountId);
+        AccessTokenBroker::removeAccount(m_profileAccountId);
     }
 
     return true;
@@ -224,26 +306,44 @@ void SocialdButeoPlugin::connectivityStateChanged(Sync::ConnectivityType type, b
     if (type == Sync::CONNECTIVITY_INTERNET && state == false) {
         // we lost connectivity during sync.
         abortSync(Sync::SYNC_CONNECTION_ERROR);
+    } else if (type == Sync::CONNECTIVITY_INTERNET && m_socialNetworkSyncAdaptor) {
+        // the link may have changed between metered and unmetered,
+        // which changes the transfers the sync may still make.
+        m_socialNetworkSyncAdaptor->networkLinkChanged();
     }
 }
 
 void SocialdButeoPlugin::syncStatusChanged()
 {
+    bool succeeded = false;
+    m_syncStatusChanged = true;
     if (m_socialNetworkSyncAdaptor) {
         SocialNetworkSyncAdaptor::Status syncStatus = m_socialNetworkSyncAdaptor->status();
         // Busy change comes when sync starts -> let's ignore that.
-        if (syncStatus == SocialNetworkSyncAdaptor::Inactive) {
-            updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
-                                             Buteo::SyncResults::SYNC_RESULT_SUCCESS,
-                                             Buteo::SyncResults::NO_ERROR));
-            emit success(getProfileName(), QString("%1 update succeeded").arg(getProfileName()));
-        } else if (syncStatus != SocialNetworkSyncAdaptor::Busy) {
-            updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
-                                             Buteo::SyncResults::SYNC_RESULT_FAILED,
-                                             Buteo::SyncResults::ABORTED));
-            emit error(getProfileName(), QString("%1 update failed").arg(getProfileName()),
-                       Buteo::SyncResults::ABORTED);
+        if (syncStatus == SocialNetworkSyncAdaptor::Busy) {
+            return;
         }
+        succeeded = syncStatus == SocialNetworkSyncAdaptor::Inactive;
+
+        if (m_syncingAccountsInProcess) {
+            m_accountSyncFailed |= !succeeded;
+            if (!m_pendingAccountProfiles.isEmpty() && !m_socialNetworkSyncAdaptor->syncAborted()) {
+                // the adaptor may still be finishing up the previous sync.
+                QMetaObject::invokeMethod(this, "syncNextAccount", Qt::QueuedConnection);
+                return;
+            }
+            succeeded = !m_accountSyncFailed && !m_socialNetworkSyncAdaptor->syncAborted();
+            m_syncingAccountsInProcess = false;
+            qDeleteAll(m_pendingAccountProfiles);
+            m_pendingAccountProfiles.clear();
+        }
+    }
+
+    if (succeeded) {
+        updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
+                                         Buteo::SyncResults::SYNC_RESULT_SUCCESS,
+                                         Buteo::SyncResults::NO_ERROR));
+        emit success(getProfileName(), QString("%1 update succeeded").arg(getProfileName()));
     } else {
         updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
                                          Buteo::SyncResults::SYNC_RESULT_FAILED,
@@ -260,18 +360,17 @@ void SocialdButeoPlugin::updateResults(const Buteo::SyncResults &results)
 
 // This function is called when the non-per-account profile is triggered.
 // The implementation does:
-// - get all profiles from the ProfileManager
 // - get all accounts from the AccountManager
-// - build a mapping of profile -> account for the current data type. (should be one-to-one for the datatype).
-// - any account which doesn't have a profile, print an error.
-// - check the enabled status of the account -> ensure that the enabled status is reflected in the profile.
+// - look up the profile of each account for the current data type in the
+//   per-account profile index (should be one-to-one for the datatype).
+// - any account which doesn't have a profile, print an error and create it.
 // It then returns a list of the appropriate (per account for this data-type) sync profiles.
 // The caller takes ownership of the list.
 QList<Buteo::SyncProfile*> SocialdButeoPlugin::ensurePerAccountSyncProfilesExist()
 {
     Accounts::Manager am;
     Accounts::AccountIdList accountIds = am.accountList();
-    QList<Buteo::SyncProfile*> syncProfiles = m_profileManager.allSyncProfiles();
+    SyncProfileIndex profileIndex(&m_profileManager, profile().name(), profile().clientProfile()->name());
     QMap<Accounts::Account*, Buteo::SyncProfile*> perAccountProfiles;
 
     Accounts::Service dataTypeSyncService = am.service(m_socialNetworkSyncAdaptor->syncServiceName());
@@ -291,19 +390,11 @@ QList<Buteo::SyncProfile*> SocialdButeoPlugin::ensurePerAccountSyncProfilesExist
         }
 
         // for the current account, find the associated sync profile.
-        bool foundProfile = false;
-        for (int j = 0; j < syncProfiles.size(); ++j) {
-            if (syncProfiles[j]->key(Buteo::KEY_ACCOUNT_ID).toInt() == QString::number(currAccount->id()).toInt()
-                    && syncProfiles[j]->clientProfile() != NULL
-                    && syncProfiles[j]->clientProfile()->name() == profile().clientProfile()->name()) {
-                // we have found the sync profile for this datatype for this account.
-                foundProfile = true;
-                perAccountProfiles.insert(currAccount, syncProfiles.takeAt(j));
-                break;
-            }
-        }
-
-        if (!foundProfile) {
+        Buteo::SyncProfile *accountProfile = profileIndex.syncProfile(currAccount->id());
+        if (accountProfile) {
+            // we have found the sync profile for this datatype for this account.
+            perAccountProfiles.insert(currAccount, accountProfile);
+        } else {
             // it should have been generated for the account when the account was added.
             qCInfo(lcSocialPlugin) << "no per-account" << profile().name()
                                    << "sync profile exists for account:" << currAccount->id();
@@ -320,6 +411,7 @@ QList<Buteo::SyncProfile*> SocialdButeoPlugin::ensurePerAccountSyncProfilesExist
                 schedule.setScheduleEnabled(true);
                 newProfile->setSyncSchedule(schedule);
                 m_profileManager.updateProfile(*newProfile);
+                profileIndex.insert(currAccount->id(), profileName);
                 // and return the profile in the map.
                 perAccountProfiles.insert(currAccount, newProfile);
             }
@@ -327,7 +419,6 @@ QList<Buteo::SyncProfile*> SocialdButeoPlugin::ensurePerAccountSyncProfilesExist
     }
 
     // Every account now has the appropriate sync profile.
-    qDeleteAll(syncProfiles); // these are for the wrong data type, ignore them.
     QList<Buteo::SyncProfile *> retn;
     foreach (Accounts::Account *acc, perAccountProfiles.keys()) {
         retn.append(perAccountProfiles[acc]);
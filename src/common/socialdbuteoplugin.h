@@ -58,18 +58,24 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void syncStatusChanged();
+    void syncNextAccount();
 
 protected:
     QList<Buteo::SyncProfile*> ensurePerAccountSyncProfilesExist();
 
 private:
     void updateResults(const Buteo::SyncResults &results);
+    void triggerAccountSyncs(const QList<Buteo::SyncProfile*> &perAccountProfiles);
     Buteo::SyncResults m_syncResults;
     Buteo::ProfileManager m_profileManager;
     SocialNetworkSyncAdaptor *m_socialNetworkSyncAdaptor;
     QString m_socialServiceName;
     QString m_dataTypeName;
     int m_profileAccountId;
+    QList<Buteo::SyncProfile*> m_pendingAccountProfiles;
+    bool m_syncingAccountsInProcess;
+    bool m_accountSyncFailed;
+    bool m_syncStatusChanged;
 };
 
 #endif // SOCIALDBUTEOPLUGIN_H
@@ -20,18 +20,477 @@
  ****************************************************************************/
 
 #include "socialdnetworkaccessmanager_p.h"
+#include "proxyreply_p.h"
+#include "retryingreply_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
 
-/* The default implementation is just a normal QNetworkAccessManager */
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QNetworkReply>
+#include <QSettings>
+#include <QSslConfiguration>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <functional>
+
+namespace {
+    // query items which carry credentials, and which must not be part of the validator key.
+    const QStringList CredentialQueryItems = QStringList()
+            << QStringLiteral("access_token")
+            << QStringLiteral("key")
+            << QStringLiteral("client_secret")
+            << QStringLiteral("sig")
+            << QStringLiteral("oauth_token")
+            << QStringLiteral("oauth_signature")
+            << QStringLiteral("oauth_nonce")
+            << QStringLiteral("oauth_timestamp");
+
+    const QString EtagKey = QStringLiteral("etag");
+    const QString LastModifiedKey = QStringLiteral("lastModified");
+
+    // how long to back off after a rate limit response without a Retry-After header,
+    // and the longest back off which is honoured.
+    const qint64 DefaultRateLimitBackoff = 5000; // msec
+    const qint64 MaximumRateLimitBackoff = 15 * 60 * 1000; // msec
+
+    SocialdNetworkAccessManager *sharedManager = 0;
+    int sharedManagerReferences = 0;
+
+    // Retry-After is either a number of seconds or an HTTP date.
+    qint64 retryAfter(const QByteArray &value)
+    {
+        bool ok = false;
+        const qint64 seconds = value.trimmed().toLongLong(&ok);
+        if (ok) {
+            return seconds * 1000;
+        }
+
+        QDateTime date = QLocale::c().toDateTime(QString::fromLatin1(value.trimmed()),
+                                                 QStringLiteral("ddd, dd MMM yyyy HH:mm:ss 'GMT'"));
+        if (!date.isValid()) {
+            return -1;
+        }
+        date.setTimeSpec(Qt::UTC);
+        return QDateTime::currentDateTimeUtc().msecsTo(date);
+    }
+}
+
+/* The default implementation is just a normal QNetworkAccessManager,
+   with support for opt-in conditional requests, rate limiting and retries. */
 
 SocialdNetworkAccessManager::SocialdNetworkAccessManager(QObject *parent)
     : QNetworkAccessManager(parent)
 {
 }
 
+SocialdNetworkAccessManager *SocialdNetworkAccessManager::sharedInstance()
+{
+    if (!sharedManager) {
+        sharedManager = new SocialdNetworkAccessManager;
+    }
+    sharedManagerReferences += 1;
+    return sharedManager;
+}
+
+bool SocialdNetworkAccessManager::releaseSharedInstance(QNetworkAccessManager *manager)
+{
+    if (!manager || manager != sharedManager) {
+        return false;
+    }
+
+    // not kept until exit: the plugin library may be unloaded before that.
+    sharedManagerReferences -= 1;
+    if (sharedManagerReferences == 0) {
+        delete sharedManager;
+        sharedManager = 0;
+    }
+    return true;
+}
+
+void SocialdNetworkAccessManager::setRateLimit(const QString &host, double requestsPerSecond, int burst)
+{
+    m_rateLimiter.setLimit(host, requestsPerSecond, burst);
+}
+
+void SocialdNetworkAccessManager::setRetryLimit(const QString &host, int maxRetries)
+{
+    if (maxRetries > 0) {
+        m_retryLimits.insert(host.toLower(), maxRetries);
+    } else {
+        m_retryLimits.remove(host.toLower());
+    }
+}
+
+int SocialdNetworkAccessManager::retryLimit(QNetworkAccessManager::Operation op, const QNetworkRequest &req) const
+{
+    if (!RetryingReply::isIdempotent(op)) {
+        return 0;
+    }
+
+    const QVariant attribute = req.attribute(RetryLimitAttribute);
+    if (attribute.isValid()) {
+        return attribute.toInt();
+    }
+
+    // check the host itself, then each of its parent domains.
+    QString host = req.url().host().toLower();
+    while (!host.isEmpty()) {
+        QHash<QString, int>::const_iterator it = m_retryLimits.constFind(host);
+        if (it != m_retryLimits.constEnd()) {
+            return it.value();
+        }
+        const int dot = host.indexOf(QLatin1Char('.'));
+        host = dot < 0 ? QString() : host.mid(dot + 1);
+    }
+    return 0;
+}
+
 QNetworkReply *SocialdNetworkAccessManager::createRequest(
                                  QNetworkAccessManager::Operation op,
                                  const QNetworkRequest &req,
                                  QIODevice *outgoingData)
 {
-    return QNetworkAccessManager::createRequest(op, req, outgoingData);
+    const int maxRetries = retryLimit(op, req);
+    if (maxRetries > 0) {
+        return createRetryingRequest(op, req, outgoingData, maxRetries);
+    }
+
+    const QString host = req.url().host();
+    const qint64 delay = requestDelay(op, req);
+    if (delay <= 0) {
+        QNetworkReply *reply = startRequest(op, req, outgoingData);
+        watchRateLimits(reply, host);
+        return reply;
+    }
+
+    qCDebug(lcSocialPlugin) << "delaying request to" << host << "by" << delay << "msec";
+
+    // the caller may not keep the request body alive until the request is sent.
+    QBuffer *body = 0;
+    ProxyReply *reply = new ProxyReply(op, req, this);
+    if (outgoingData) {
+        body = new QBuffer(reply);
+        body->setData(outgoingData->readAll());
+        body->open(QIODevice::ReadOnly);
+    }
+
+    QTimer::singleShot(delay, reply, [this, op, req, host, body, reply] {
+        if (reply->isFinished()) {
+            return; // aborted while waiting
+        }
+        QNetworkReply *source = startRequest(op, req, body);
+        if (body) {
+            body->setParent(source);
+        }
+        watchRateLimits(source, host);
+        reply->forward(source);
+    });
+    return reply;
+}
+
+QNetworkReply *SocialdNetworkAccessManager::createRetryingRequest(
+                                 QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData,
+                                 int maxRetries)
+{
+    const QString host = req.url().host();
+    RetryingReply *reply = new RetryingReply(op, req, maxRetries, this);
+
+    // every attempt needs the whole request body.
+    const bool hasBody = outgoingData != 0;
+    const QByteArray body = hasBody ? outgoingData->readAll() : QByteArray();
+
+    const std::function<void()> send = [this, op, req, host, hasBody, body, reply] {
+        QBuffer *buffer = 0;
+        if (hasBody) {
+            buffer = new QBuffer;
+            buffer->setData(body);
+            buffer->open(QIODevice::ReadOnly);
+        }
+        QNetworkReply *source = startRequest(op, req, buffer);
+        if (buffer) {
+            buffer->setParent(source);
+        }
+        watchRateLimits(source, host);
+        reply->forward(source);
+    };
+
+    // each attempt is paced like any other request, which also honours
+    // the Retry-After of rate limit responses.
+    const std::function<void()> attempt = [this, op, req, reply, send] {
+        const qint64 delay = requestDelay(op, req);
+        if (delay <= 0) {
+            send();
+            return;
+        }
+        QTimer::singleShot(delay, reply, [reply, send] {
+            if (!reply->isFinished()) {
+                send();
+            }
+        });
+    };
+
+    connect(reply, &RetryingReply::retryRequested, this, attempt);
+    attempt();
+    return reply;
+}
+
+qint64 SocialdNetworkAccessManager::requestDelay(QNetworkAccessManager::Operation op, const QNetworkRequest &req)
+{
+    Q_UNUSED(op)
+    return m_rateLimiter.reserve(req.url().host());
+}
+
+QNetworkReply *SocialdNetworkAccessManager::startRequest(
+                                 QNetworkAccessManager::Operation op,
+                                 const QNetworkRequest &req,
+                                 QIODevice *outgoingData)
+{
+    QNetworkRequest request(req);
+    prepareConnection(&request);
+
+    const QString scope = req.attribute(ValidatorScopeAttribute).toString();
+    if (op != QNetworkAccessManager::GetOperation || scope.isEmpty()) {
+        QNetworkReply *reply = QNetworkAccessManager::createRequest(op, request, outgoingData);
+        watchSessionTicket(reply);
+        return reply;
+    }
+
+    prepareConditionalRequest(&request, scope);
+    QNetworkReply *reply = QNetworkAccessManager::createRequest(op, request, outgoingData);
+    if (reply) {
+        watchValidators(reply, scope, validatorKey(req.url()));
+        watchSessionTicket(reply);
+    }
+    return reply;
+}
+
+// Allows HTTP/2 where Qt supports it (5.8 and later; negotiated via ALPN,
+// so servers without support fall back to HTTP/1.1), which multiplexes all
+// requests to a host over one connection.  With older Qt versions requests
+// use HTTP/1.1, over at most six keep-alive connections per host and manager.
+//
+// New connections to a host resume the TLS session of an earlier one: the
+// session ticket issued by the host is kept, and offered in the handshake.
+void SocialdNetworkAccessManager::prepareConnection(QNetworkRequest *request)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    const QNetworkRequest::Attribute http2Allowed = QNetworkRequest::Http2AllowedAttribute;
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    const QNetworkRequest::Attribute http2Allowed = QNetworkRequest::HTTP2AllowedAttribute;
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    if (!request->attribute(http2Allowed).isValid()) {
+        request->setAttribute(http2Allowed, true);
+    }
+#endif
+    if (request->url().scheme() == QLatin1String("https")) {
+        // the session ticket is only made available with persistence enabled.
+        QSslConfiguration sslConfiguration = request->sslConfiguration();
+        sslConfiguration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+        const QByteArray ticket = m_sessionTickets.value(sessionKey(request->url()));
+        if (!ticket.isEmpty() && sslConfiguration.sessionTicket().isEmpty()) {
+            sslConfiguration.setSessionTicket(ticket);
+        }
+        request->setSslConfiguration(sslConfiguration);
+    }
+}
+
+QString SocialdNetworkAccessManager::sessionKey(const QUrl &url)
+{
+    return url.host().toLower() + QLatin1Char(':') + QString::number(url.port(443));
+}
+
+void SocialdNetworkAccessManager::watchSessionTicket(QNetworkReply *reply)
+{
+    if (!reply || reply->url().scheme() != QLatin1String("https")) {
+        return;
+    }
+
+    const QString key = sessionKey(reply->url());
+    connect(reply, &QNetworkReply::encrypted, this, [this, reply, key] {
+        const QByteArray ticket = reply->sslConfiguration().sessionTicket();
+        if (!ticket.isEmpty()) {
+            m_sessionTickets.insert(key, ticket);
+        }
+    });
+}
+
+void SocialdNetworkAccessManager::watchRateLimits(QNetworkReply *reply, const QString &host)
+{
+    if (!reply) {
+        return;
+    }
+
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply, host] {
+        const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        const bool hasRetryAfter = reply->hasRawHeader("Retry-After");
+        qint64 backoff = -1;
+
+        if (httpStatus == 429 || ((httpStatus == 403 || httpStatus == 503) && hasRetryAfter)) {
+            backoff = hasRetryAfter ? retryAfter(reply->rawHeader("Retry-After")) : -1;
+            if (backoff < 0) {
+                backoff = DefaultRateLimitBackoff;
+            }
+        } else if (reply->rawHeader("X-Rate-Limit-Remaining") == "0"
+                   || reply->rawHeader("X-RateLimit-Remaining") == "0") {
+            // the quota of the current window has been used up (e.g. Twitter).
+            QByteArray reset = reply->rawHeader("X-Rate-Limit-Reset");
+            if (reset.isEmpty()) {
+                reset = reply->rawHeader("X-RateLimit-Reset");
+            }
+            bool ok = false;
+            const qint64 resetTime = reset.toLongLong(&ok);
+            if (ok) {
+                backoff = resetTime * 1000 - QDateTime::currentMSecsSinceEpoch();
+            }
+        }
+
+        if (backoff > 0) {
+            backoff = qMin(backoff, MaximumRateLimitBackoff);
+            qCInfo(lcSocialPlugin) << "rate limited by" << host << "with status" << httpStatus
+                                   << "- delaying further requests by" << backoff << "msec";
+            m_rateLimiter.block(host, backoff);
+        }
+    });
+}
+
+// Returns the url with any credentials (access tokens, signatures etc) removed.
+QUrl SocialdNetworkAccessManager::withoutCredentials(const QUrl &url)
+{
+    QUrl stripped(url);
+    QUrlQuery query(stripped);
+    Q_FOREACH (const QString &item, CredentialQueryItems) {
+        query.removeAllQueryItems(item);
+    }
+    stripped.setQuery(query);
+    stripped.setUserInfo(QString());
+    stripped.setFragment(QString());
+    return stripped;
+}
+
+QString SocialdNetworkAccessManager::validatorKey(const QUrl &url)
+{
+    // QSettings treats slashes in keys as group separators, so hash the url.
+    return QString::fromLatin1(QCryptographicHash::hash(withoutCredentials(url).toEncoded(),
+                                                        QCryptographicHash::Sha1).toHex());
+}
+
+QString SocialdNetworkAccessManager::validatorFileName(const QString &scope)
+{
+    return QString::fromLatin1("%1/%2/validators/%3.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR))
+            .arg(scope);
+}
+
+QHash<QString, SocialdNetworkAccessManager::Validators> &SocialdNetworkAccessManager::storedValidators(const QString &scope)
+{
+    QHash<QString, QHash<QString, Validators> >::iterator it = m_storedValidators.find(scope);
+    if (it != m_storedValidators.end()) {
+        return *it;
+    }
+
+    QHash<QString, Validators> &validators(m_storedValidators[scope]);
+    QSettings settings(validatorFileName(scope), QSettings::IniFormat);
+    Q_FOREACH (const QString &key, settings.childGroups()) {
+        settings.beginGroup(key);
+        Validators v;
+        v.etag = settings.value(EtagKey).toByteArray();
+        v.lastModified = settings.value(LastModifiedKey).toByteArray();
+        settings.endGroup();
+        validators.insert(key, v);
+    }
+    return validators;
+}
+
+void SocialdNetworkAccessManager::prepareConditionalRequest(QNetworkRequest *request, const QString &scope)
+{
+    const QHash<QString, Validators> &validators(storedValidators(scope));
+    QHash<QString, Validators>::const_iterator it = validators.constFind(validatorKey(request->url()));
+    if (it == validators.constEnd()) {
+        return;
+    }
+
+    if (!it->etag.isEmpty()) {
+        request->setRawHeader("If-None-Match", it->etag);
+    }
+    if (!it->lastModified.isEmpty()) {
+        request->setRawHeader("If-Modified-Since", it->lastModified);
+    }
+}
+
+void SocialdNetworkAccessManager::watchValidators(QNetworkReply *reply, const QString &scope, const QString &key)
+{
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply, scope, key] {
+        const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (httpStatus == 304) {
+            qCDebug(lcSocialPlugin) << "server reports unchanged data for" << scope << "request";
+            reply->setProperty("notModified", QVariant::fromValue<bool>(true));
+        } else if (httpStatus == 200) {
+            Validators v;
+            v.etag = reply->rawHeader("ETag");
+            v.lastModified = reply->rawHeader("Last-Modified");
+            if (!v.etag.isEmpty() || !v.lastModified.isEmpty()) {
+                m_pendingValidators[scope].insert(key, v);
+            } else {
+                // the resource no longer supports validation; forget the old validators.
+                m_pendingValidators[scope].insert(key, Validators());
+            }
+        }
+    });
+}
+
+// Stores the validators received during this sync for the given scope.
+// Should be called once the data received in the replies has been saved.
+void SocialdNetworkAccessManager::commitValidators(const QString &scope)
+{
+    const QHash<QString, Validators> pending = m_pendingValidators.take(scope);
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    QHash<QString, Validators> &validators(storedValidators(scope));
+    const QString fileName = validatorFileName(scope);
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSettings settings(fileName, QSettings::IniFormat);
+    for (QHash<QString, Validators>::const_iterator it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        if (it->etag.isEmpty() && it->lastModified.isEmpty()) {
+            validators.remove(it.key());
+            settings.remove(it.key());
+            continue;
+        }
+        validators.insert(it.key(), it.value());
+        settings.beginGroup(it.key());
+        settings.setValue(EtagKey, it->etag);
+        settings.setValue(LastModifiedKey, it->lastModified);
+        settings.endGroup();
+    }
+    settings.sync();
+}
+
+// Forgets the validators received during this sync for the given scope,
+// e.g. because the sync was aborted before the data was saved.
+void SocialdNetworkAccessManager::discardValidators(const QString &scope)
+{
+    m_pendingValidators.remove(scope);
+}
+
+// Removes all stored validators for the given scope, e.g. because the
+// data synced with them has been purged.
+void SocialdNetworkAccessManager::clearValidators(const QString &scope)
+{
+    m_pendingValidators.remove(scope);
+    m_storedValidators.remove(scope);
+    QFile::remove(validatorFileName(scope));
 }
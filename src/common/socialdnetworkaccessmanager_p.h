@@ -22,7 +22,14 @@
 #ifndef SOCIALD_QNAMFACTORY_P_H
 #define SOCIALD_QNAMFACTORY_P_H
 
+#include "requestratelimiter_p.h"
+
 #include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QUrl>
 
 class SocialdNetworkAccessManager : public QNetworkAccessManager
 {
@@ -31,10 +38,82 @@ class SocialdNetworkAccessManager : public QNetworkAccessManager
 public:
     SocialdNetworkAccessManager(QObject *parent = 0);
 
+    // The manager shared by all adaptors of the process which don't need a
+    // specialised one, so that they reuse each other's connections.  Each call
+    // adds a reference; the manager must be released with releaseSharedInstance()
+    // instead of being deleted.  Returns false if the manager isn't the shared one.
+    static SocialdNetworkAccessManager *sharedInstance();
+    static bool releaseSharedInstance(QNetworkAccessManager *manager);
+
+    // Conditional requests.  A GET request which has the ValidatorScopeAttribute
+    // set (to a QString which identifies the account and data type) is sent with
+    // If-None-Match / If-Modified-Since headers if validators have been stored for
+    // its url.  If the server responds with 304, the reply has the "notModified"
+    // property set to true.  Validators received in 200 responses are kept pending
+    // until the adaptor has successfully handled the data, and calls commitValidators().
+    static const QNetworkRequest::Attribute ValidatorScopeAttribute = QNetworkRequest::Attribute(QNetworkRequest::User + 1);
+
+    void commitValidators(const QString &scope);
+    void discardValidators(const QString &scope);
+    void clearValidators(const QString &scope);
+
+    static QUrl withoutCredentials(const QUrl &url);
+
+    // Rate limiting.  Requests to a host (or any of its subdomains) for which a
+    // limit has been set are paced by a token bucket per host, see RequestRateLimiter.
+    // Requests which exceed the limit are delayed, not rejected: the returned reply
+    // only starts the real request once a token is available.  Rate limit responses
+    // (429, or 403 / 503 with Retry-After) and exhausted X-Rate-Limit-Remaining
+    // quotas delay further requests to the host for any host, limited or not, and
+    // the requests held back are paced once the delay ends.
+    void setRateLimit(const QString &host, double requestsPerSecond, int burst);
+
+    // Retries.  Idempotent requests to a host (or any of its subdomains) for which
+    // a retry limit has been set, or which have the RetryLimitAttribute set, are
+    // retried after transient failures, see RetryingReply.  The attribute overrides
+    // the limit of the host; 0 disables retries for the request.
+    static const QNetworkRequest::Attribute RetryLimitAttribute = QNetworkRequest::Attribute(QNetworkRequest::User + 3);
+
+    void setRetryLimit(const QString &host, int maxRetries);
+
 protected:
     QNetworkReply *createRequest(QNetworkAccessManager::Operation op,
                                  const QNetworkRequest &req,
                                  QIODevice *outgoingData = 0) override;
+
+    // returns the number of msecs the request has to wait before it is sent.
+    virtual qint64 requestDelay(QNetworkAccessManager::Operation op, const QNetworkRequest &req);
+
+private:
+    struct Validators {
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    QNetworkReply *startRequest(QNetworkAccessManager::Operation op,
+                                const QNetworkRequest &req,
+                                QIODevice *outgoingData);
+    QNetworkReply *createRetryingRequest(QNetworkAccessManager::Operation op,
+                                         const QNetworkRequest &req,
+                                         QIODevice *outgoingData,
+                                         int maxRetries);
+    int retryLimit(QNetworkAccessManager::Operation op, const QNetworkRequest &req) const;
+    void watchRateLimits(QNetworkReply *reply, const QString &host);
+    void prepareConnection(QNetworkRequest *request);
+    static QString sessionKey(const QUrl &url);
+    void watchSessionTicket(QNetworkReply *reply);
+
+    static QString validatorKey(const QUrl &url);
+    static QString validatorFileName(const QString &scope);
+    QHash<QString, Validators> &storedValidators(const QString &scope);
+    void prepareConditionalRequest(QNetworkRequest *request, const QString &scope);
+    void watchValidators(QNetworkReply *reply, const QString &scope, const QString &key);
+
+    QHash<QString, QHash<QString, Validators> > m_storedValidators;
+    QHash<QString, QHash<QString, Validators> > m_pendingValidators;
+    RequestRateLimiter m_rateLimiter;
+    QHash<QString, int> m_retryLimits;
+    QHash<QString, QByteArray> m_sessionTickets; // per host and port
 };
 
 #endif
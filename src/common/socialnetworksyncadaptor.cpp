@@ -21,6 +21,18 @@
 
 #include "socialnetworksyncadaptor.h"
 #include "socialdnetworkaccessmanager_p.h"
+#include "replaynetworkaccessmanager_p.h"
+#include "replydeadlinescheduler_p.h"
+#include "hostlatencyestimator_p.h"
+#include "networkrequestmetrics_p.h"
+#include "flightrecorder_p.h"
+#include "networkcostpolicy_p.h"
+#include "memoryusagemonitor_p.h"
+#include "imagecachepurger_p.h"
+#include "synccheckpointstore_p.h"
+#include "accesstokenbroker_p.h"
+#include "synctasktracker_p.h"
+#include "jsonstreamreader_p.h"
 #include "trace.h"
 
 #include <QtCore/QJsonDocument>
@@ -45,6 +57,9 @@
 #include <socialcache/socialnetworksyncdatabase.h>
 
 namespace {
+    // sync timestamp updates are coalesced for this long before being written.
+    const int SyncTimestampFlushDelay = 2000; // msec
+
     QStringList validDataTypesInitialiser()
     {
         return QStringList()
@@ -61,6 +76,18 @@ namespace {
                 << QStringLiteral("BackupQuery")
                 << QStringLiteral("BackupRestore");
     }
+
+    const char *statusName(SocialNetworkSyncAdaptor::Status status)
+    {
+        switch (status) {
+        case SocialNetworkSyncAdaptor::Initializing: return "Initializing";
+        case SocialNetworkSyncAdaptor::Inactive:     return "Inactive";
+        case SocialNetworkSyncAdaptor::Busy:         return "Busy";
+        case SocialNetworkSyncAdaptor::Error:        return "Error";
+        case SocialNetworkSyncAdaptor::Invalid:      return "Invalid";
+        }
+        return "Unknown";
+    }
 }
 
 SocialNetworkSyncAdaptor::SocialNetworkSyncAdaptor(const QString &serviceName,
@@ -70,21 +97,58 @@ SocialNetworkSyncAdaptor::SocialNetworkSyncAdaptor(const QString &serviceName,
     : QObject(parent)
     , m_dataType(dataType)
     , m_accountManager(new Accounts::Manager(this))
-    , m_networkAccessManager(qnam != 0 ? qnam : new SocialdNetworkAccessManager)
+    , m_networkAccessManager(qnam != 0 ? qnam : defaultNetworkAccessManager(serviceName, dataType))
     , m_accountSyncProfile(NULL)
     , m_syncDb(new SocialNetworkSyncDatabase())
+    , m_syncTimestampTimer(new QTimer(this))
     , m_status(SocialNetworkSyncAdaptor::Invalid)
     , m_enabled(false)
     , m_syncAborted(false)
     , m_serviceName(serviceName)
+    , m_tasks(new SyncTaskTracker(this))
+    , m_replyDeadlines(new ReplyDeadlineScheduler(this))
+    , m_networkMetrics(new NetworkRequestMetrics(serviceName, dataTypeName(dataType), this))
+    , m_costPolicy(new NetworkCostPolicy(serviceName, dataTypeName(dataType)))
+    , m_memoryUsage(new MemoryUsageMonitor(this))
+    , m_imagePurger(nullptr)
+{
+    connect(m_replyDeadlines, &ReplyDeadlineScheduler::expired,
+            this, &SocialNetworkSyncAdaptor::timeoutReply);
+    connect(m_tasks, &SyncTaskTracker::progressChanged,
+            this, &SocialNetworkSyncAdaptor::progressChanged);
+    connect(m_tasks, &SyncTaskTracker::stalled,
+            this, &SocialNetworkSyncAdaptor::tasksStalled);
+
+    m_syncTimestampTimer->setSingleShot(true);
+    m_syncTimestampTimer->setInterval(SyncTimestampFlushDelay);
+    connect(m_syncTimestampTimer, &QTimer::timeout,
+            this, &SocialNetworkSyncAdaptor::syncTimestampTimerTimeout);
+
+    FlightRecorder::instance()->installCrashHandler(m_serviceName, dataTypeName(m_dataType));
+}
+
+// Returns the network access manager for an adaptor which doesn't need a
+// specialised one: the process-wide shared manager, or one which records or
+// replays the network traffic if requested in the environment (see
+// ReplayNetworkAccessManager).
+QNetworkAccessManager *SocialNetworkSyncAdaptor::defaultNetworkAccessManager(const QString &serviceName,
+                                                                              SocialNetworkSyncAdaptor::DataType dataType)
 {
+    if (ReplayNetworkAccessManager::isConfigured()) {
+        return new ReplayNetworkAccessManager(QStringLiteral("%1.%2").arg(serviceName, dataTypeName(dataType)));
+    }
+    return SocialdNetworkAccessManager::sharedInstance();
 }
 
 SocialNetworkSyncAdaptor::~SocialNetworkSyncAdaptor()
 {
-    delete m_networkAccessManager;
+    flushSyncTimestamps(true);
+    if (!SocialdNetworkAccessManager::releaseSharedInstance(m_networkAccessManager)) {
+        delete m_networkAccessManager;
+    }
     delete m_accountSyncProfile;
     delete m_syncDb;
+    delete m_costPolicy;
 }
 
 // The SocialNetworkSyncAdaptor takes ownership of the sync profiles.
@@ -121,11 +185,32 @@ void SocialNetworkSyncAdaptor::sync(const QString &dataType, int accountId)
     qCWarning(lcSocialPlugin) << "sync() must be overridden by derived types";
 }
 
+void SocialNetworkSyncAdaptor::setMeteredTransferBudget(qint64 bytes)
+{
+    m_costPolicy->setMeteredBudget(bytes);
+}
+
+void SocialNetworkSyncAdaptor::networkLinkChanged()
+{
+    if (m_status == SocialNetworkSyncAdaptor::Busy) {
+        m_costPolicy->updateLink();
+    }
+}
+
+// Returns the number of bulk transfers which were deferred by the last sync
+// because of the network link.  They are retried by the next sync.
+int SocialNetworkSyncAdaptor::deferredTransferCount() const
+{
+    return m_costPolicy->deferredCount();
+}
+
 void SocialNetworkSyncAdaptor::abortSync(Sync::SyncStatus status)
 {
     qCInfo(lcSocialPlugin) << "forcing timeout of outstanding replies due to abort:" << status;
     m_syncAborted = true;
+    FlightRecorder::instance()->recordEvent(-1, "abort");
     triggerReplyTimeouts();
+    FlightRecorder::instance()->dump(m_serviceName, dataTypeName(m_dataType), "abort");
 }
 
 /*!
@@ -195,24 +280,122 @@ QDateTime SocialNetworkSyncAdaptor::lastSyncTimestamp(const QString &serviceName
                                                       const QString &dataType,
                                                       int accountId) const
 {
+    // updates which have not been written yet take precedence.
+    QList<PendingSyncTimestamp> queued = m_writingSyncTimestamps;
+    Q_FOREACH (const PendingSyncTimestamp &entry, m_pendingSyncTimestamps) {
+        mergeSyncTimestamp(&queued, entry);
+    }
+    Q_FOREACH (const PendingSyncTimestamp &entry, queued) {
+        if (entry.accountId == accountId && entry.serviceName == serviceName && entry.dataType == dataType) {
+            return entry.timestamp;
+        }
+    }
+
     return m_syncDb->lastSyncTimestamp(serviceName, dataType, accountId);
 }
 
 /*!
     \internal
-    Updates the last sync timestamp for the given service, account and data type to the given \a timestamp.
+    Queues an update of the last sync timestamp for the given service, account and data type
+    to the given \a timestamp.  Queued updates are coalesced and written in a single transaction
+    after a short delay, or by flushSyncTimestamps() when the sync finishes.
+    Returns false if the timestamp could not be queued.
 */
 bool SocialNetworkSyncAdaptor::updateLastSyncTimestamp(const QString &serviceName,
                                                        const QString &dataType,
                                                        int accountId,
                                                        const QDateTime &timestamp)
 {
-    // Workaround
-    // TODO: do better, with a queue
-    m_syncDb->addSyncTimestamp(serviceName, dataType, accountId, timestamp);
+    if (!timestamp.isValid()) {
+        return false;
+    }
+
+    PendingSyncTimestamp entry;
+    entry.serviceName = serviceName;
+    entry.dataType = dataType;
+    entry.accountId = accountId;
+    entry.timestamp = timestamp;
+    mergeSyncTimestamp(&m_pendingSyncTimestamps, entry);
+
+    if (!m_syncTimestampTimer->isActive()) {
+        m_syncTimestampTimer->start();
+    }
+    return true;
+}
+
+void SocialNetworkSyncAdaptor::mergeSyncTimestamp(QList<PendingSyncTimestamp> *list,
+                                                  const PendingSyncTimestamp &entry)
+{
+    for (int i = 0; i < list->size(); ++i) {
+        PendingSyncTimestamp &existing((*list)[i]);
+        if (existing.accountId == entry.accountId
+                && existing.serviceName == entry.serviceName
+                && existing.dataType == entry.dataType) {
+            existing.timestamp = entry.timestamp;
+            return;
+        }
+    }
+    list->append(entry);
+}
+
+void SocialNetworkSyncAdaptor::syncTimestampTimerTimeout()
+{
+    flushSyncTimestamps(false);
+}
+
+/*!
+    \internal
+    Writes all queued sync timestamp updates to the database in a single transaction.
+    The write is performed by the database worker thread; if \a waitForWrite is false
+    this function returns immediately, otherwise it blocks until the write has completed.
+    Returns false if a write has failed.  Timestamps whose write failed are requeued.
+*/
+bool SocialNetworkSyncAdaptor::flushSyncTimestamps(bool waitForWrite)
+{
+    m_syncTimestampTimer->stop();
+
+    if (!m_writingSyncTimestamps.isEmpty()) {
+        if (!waitForWrite && m_syncDb->writeStatus() == AbstractSocialCacheDatabase::Executing) {
+            // the previous write is still in progress, try again later.
+            m_syncTimestampTimer->start();
+            return true;
+        }
+
+        m_syncDb->wait();
+        if (m_syncDb->writeStatus() == AbstractSocialCacheDatabase::Error) {
+            qCWarning(lcSocialPlugin) << "failed to write" << m_writingSyncTimestamps.size()
+                                      << "sync timestamps, requeuing";
+            Q_FOREACH (const PendingSyncTimestamp &entry, m_pendingSyncTimestamps) {
+                mergeSyncTimestamp(&m_writingSyncTimestamps, entry);
+            }
+            m_pendingSyncTimestamps = m_writingSyncTimestamps;
+        }
+        m_writingSyncTimestamps.clear();
+    }
+
+    if (m_pendingSyncTimestamps.isEmpty()) {
+        return true;
+    }
+
+    m_writingSyncTimestamps = m_pendingSyncTimestamps;
+    m_pendingSyncTimestamps.clear();
+    Q_FOREACH (const PendingSyncTimestamp &entry, m_writingSyncTimestamps) {
+        m_syncDb->addSyncTimestamp(entry.serviceName, entry.dataType, entry.accountId, entry.timestamp);
+    }
     m_syncDb->commit();
+
+    if (!waitForWrite) {
+        return true;
+    }
+
     m_syncDb->wait();
-    return m_syncDb->writeStatus() == AbstractSocialCacheDatabase::Finished;
+    const bool success = m_syncDb->writeStatus() == AbstractSocialCacheDatabase::Finished;
+    if (!success) {
+        qCWarning(lcSocialPlugin) << "failed to write" << m_writingSyncTimestamps.size() << "sync timestamps";
+        m_pendingSyncTimestamps = m_writingSyncTimestamps;
+    }
+    m_writingSyncTimestamps.clear();
+    return success;
 }
 
 /*!
@@ -222,7 +405,15 @@ bool SocialNetworkSyncAdaptor::updateLastSyncTimestamp(const QString &serviceNam
 */
 QList<int> SocialNetworkSyncAdaptor::syncedAccounts(const QString &dataType)
 {
-    return m_syncDb->syncedAccounts(m_serviceName, dataType);
+    QList<int> retn = m_syncDb->syncedAccounts(m_serviceName, dataType);
+    QList<PendingSyncTimestamp> queued = m_writingSyncTimestamps + m_pendingSyncTimestamps;
+    Q_FOREACH (const PendingSyncTimestamp &entry, queued) {
+        if (entry.serviceName == m_serviceName && entry.dataType == dataType
+                && !retn.contains(entry.accountId)) {
+            retn.append(entry.accountId);
+        }
+    }
+    return retn;
 }
 
 /*!
@@ -233,6 +424,34 @@ void SocialNetworkSyncAdaptor::setStatus(Status status)
 {
     if (m_status != status) {
         m_status = status;
+        FlightRecorder::instance()->recordStatus(-1, status, statusName(status));
+        if (status == SocialNetworkSyncAdaptor::Error) {
+            FlightRecorder::instance()->dump(m_serviceName, dataTypeName(m_dataType), "error");
+        }
+        if (status == SocialNetworkSyncAdaptor::Busy) {
+            // expired images can wait, don't compete with the new sync.
+            if (m_imagePurger) {
+                m_imagePurger->interrupt();
+            }
+            m_costPolicy->begin();
+            m_memoryUsage->begin();
+            // nothing of the previous run can finish them anymore.
+            m_tasks->leakRunningTasks();
+        } else {
+            // the sync run has ended, one way or another.
+            m_costPolicy->end(status == SocialNetworkSyncAdaptor::Inactive);
+            if (m_memoryUsage->isRunning()) {
+                m_memoryUsage->end();
+                m_networkMetrics->setMemoryUsage(m_memoryUsage->toJson());
+            }
+            m_networkMetrics->report();
+            HostLatencyEstimator::instance()->save();
+            Q_FOREACH (const SyncTaskTracker::Task &task, m_tasks->runningTasks()) {
+                qCWarning(lcSocialPlugin) << "task" << SyncTaskTracker::describe(task) << "of account" << task.accountId
+                                          << "is still open at the end of the sync";
+            }
+            m_tasks->reset();
+        }
         emit statusChanged();
     }
 }
@@ -264,77 +483,143 @@ void SocialNetworkSyncAdaptor::setInitialActive(bool enabled)
 void SocialNetworkSyncAdaptor::setFinishedInactive()
 {
     finalCleanup();
+    // a failed timestamp write must not leave the adaptor in Error,
+    // as startSync() would then refuse every later sync.  The failed
+    // timestamps stay queued, and are written by the timer or the
+    // next flush instead.
+    if (!flushSyncTimestamps(true) && !flushSyncTimestamps(true)) {
+        qCWarning(lcSocialPlugin) << "unable to write the sync timestamps of" << m_serviceName
+                                  << SocialNetworkSyncAdaptor::dataTypeName(m_dataType) << ", retrying later";
+        m_syncTimestampTimer->start();
+    }
     qCInfo(lcSocialPlugin) << "Finished" << m_serviceName << SocialNetworkSyncAdaptor::dataTypeName(m_dataType)
                            << "sync at:" << QDateTime::currentDateTime().toString(Qt::ISODate);
     setStatus(SocialNetworkSyncAdaptor::Inactive);
 }
 
-void SocialNetworkSyncAdaptor::incrementSemaphore(int accountId)
+void SocialNetworkSyncAdaptor::incrementSemaphore(int accountId, const QString &task)
 {
-    int semaphoreValue = m_accountSyncSemaphores.value(accountId);
-    semaphoreValue += 1;
-    m_accountSyncSemaphores.insert(accountId, semaphoreValue);
-    qCDebug(lcSocialPlugin) << "incremented busy semaphore for account" << accountId << "to:" << semaphoreValue;
+    if (m_tasks->runningCount(accountId) == 0) {
+        m_memoryUsage->beginPhase(accountId, QStringLiteral("download"));
+    }
+    m_tasks->start(accountId, task);
+    qCDebug(lcSocialPlugin) << "incremented busy semaphore for account" << accountId
+                            << "to:" << m_tasks->runningCount(accountId);
 }
 
-void SocialNetworkSyncAdaptor::decrementSemaphore(int accountId)
+void SocialNetworkSyncAdaptor::decrementSemaphore(int accountId, const QString &task)
 {
-    if (!m_accountSyncSemaphores.contains(accountId)) {
-        qCWarning(lcSocialPlugin) << "no such semaphore for account" << accountId;
+    // unnamed tasks are ended in the order of the old counting semaphore.
+    const int taskId = task.isEmpty() ? m_tasks->finishLatest(accountId)
+                                      : m_tasks->finishNamed(accountId, task);
+    if (taskId == 0) {
+        // e.g. the task was already ended as leaked, don't end an unrelated one.
+        qCWarning(lcSocialPlugin) << "no running task" << task << "to decrement for account" << accountId;
         return;
     }
 
-    int semaphoreValue = m_accountSyncSemaphores.value(accountId);
-    semaphoreValue -= 1;
-    qCDebug(lcSocialPlugin) << "decremented busy semaphore for account" << accountId << "to:" << semaphoreValue;
-    if (semaphoreValue < 0) {
-        qCWarning(lcSocialPlugin) << "busy semaphore is negative for account" << accountId;
+    qCDebug(lcSocialPlugin) << "decremented busy semaphore for account" << accountId
+                            << "to:" << m_tasks->runningCount(accountId);
+    accountTaskEnded(accountId);
+}
+
+void SocialNetworkSyncAdaptor::beginExternalWait(int accountId, const QString &task)
+{
+    if (m_tasks->runningCount(accountId) == 0) {
+        m_memoryUsage->beginPhase(accountId, QStringLiteral("download"));
+    }
+    m_tasks->start(accountId, task, 0, true);
+    qCDebug(lcSocialPlugin) << "waiting for" << task << "of account" << accountId;
+}
+
+/*!
+    \internal
+    Starts a named task of the given account, as a subtask of parentTask
+    if given.  The account is busy until all its tasks have finished, as
+    for incrementSemaphore().  Returns the id of the task.
+*/
+int SocialNetworkSyncAdaptor::startTask(int accountId, const QString &name, int parentTask)
+{
+    if (m_tasks->runningCount(accountId) == 0) {
+        m_memoryUsage->beginPhase(accountId, QStringLiteral("download"));
+    }
+    const int taskId = m_tasks->start(accountId, name, parentTask);
+    qCDebug(lcSocialPlugin) << "started task" << name << taskId << "for account" << accountId;
+    return taskId;
+}
+
+void SocialNetworkSyncAdaptor::finishTask(int taskId, bool failed)
+{
+    const int accountId = m_tasks->accountOf(taskId);
+    if (!m_tasks->finish(taskId, failed ? SyncTaskTracker::Failed : SyncTaskTracker::Finished)) {
+        qCWarning(lcSocialPlugin) << "task" << taskId << "is not running";
         return;
     }
-    m_accountSyncSemaphores.insert(accountId, semaphoreValue);
 
-    if (semaphoreValue == 0) {
-        finalize(accountId);
+    qCDebug(lcSocialPlugin) << "finished task" << taskId << "for account" << accountId;
+    accountTaskEnded(accountId);
+}
 
-        // With the newer implementation, in finalize we can raise semaphores,
-        // so if after calling finalize, the semaphore count is not the same anymore,
-        // we shouldn't update the sync timestamp
-        if (m_accountSyncSemaphores.value(accountId) > 0) {
-            return;
-        }
+void SocialNetworkSyncAdaptor::accountTaskEnded(int accountId)
+{
+    if (m_tasks->runningCount(accountId) > 0) {
+        return;
+    }
 
-        // finished all outstanding sync requests for this account.
-        // update the sync time in the global sociald database.
-        updateLastSyncTimestamp(m_serviceName,
-                                SocialNetworkSyncAdaptor::dataTypeName(m_dataType), accountId,
-                                QDateTime::currentDateTime().toTimeSpec(Qt::UTC));
-
-        // if all outstanding requests for all accounts have finished,
-        // then update our status to Inactive / ready to handle more sync requests.
-        bool allAreZero = true;
-        QList<int> semaphores = m_accountSyncSemaphores.values();
-        foreach (int sv, semaphores) {
-            if (sv != 0) {
-                allAreZero = false;
-                break;
-            }
-        }
+    // the remote data accumulated by the download is usually processed in finalize.
+    m_memoryUsage->endPhase(accountId, QStringLiteral("download"));
+    m_memoryUsage->beginPhase(accountId, QStringLiteral("finalize"));
+    finalize(accountId);
+    m_memoryUsage->endPhase(accountId, QStringLiteral("finalize"));
 
-        if (allAreZero) {
-            setFinishedInactive(); // Finished!
-        }
+    // With the newer implementation, in finalize we can raise semaphores,
+    // so if after calling finalize, the semaphore count is not the same anymore,
+    // we shouldn't update the sync timestamp
+    if (m_tasks->runningCount(accountId) > 0) {
+        return;
+    }
+
+    // finished all outstanding sync requests for this account.
+    // update the sync time in the global sociald database.
+    updateLastSyncTimestamp(m_serviceName,
+                            SocialNetworkSyncAdaptor::dataTypeName(m_dataType), accountId,
+                            QDateTime::currentDateTime().toTimeSpec(Qt::UTC));
+
+    // if all outstanding requests for all accounts have finished,
+    // then update our status to Inactive / ready to handle more sync requests.
+    if (!m_tasks->hasRunningTasks()) {
+        setFinishedInactive(); // Finished!
     }
 }
 
-void SocialNetworkSyncAdaptor::timeoutReply()
+void SocialNetworkSyncAdaptor::tasksStalled()
 {
-    QTimer *timer = qobject_cast<QTimer*>(sender());
-    QNetworkReply *reply = timer->property("networkReply").value<QNetworkReply*>();
-    int accountId = timer->property("accountId").toInt();
+    // running tasks can still be finished by a reply or its timeout.
+    if (m_replyDeadlines->count() > 0) {
+        return;
+    }
+
+    // otherwise nothing is left which could finish them, except for
+    // the external waits, which are ended by the other process.
+    QList<int> accountIds;
+    Q_FOREACH (const SyncTaskTracker::Task &task, m_tasks->runningTasks()) {
+        if (!task.external && !accountIds.contains(task.accountId)) {
+            accountIds.append(task.accountId);
+        }
+    }
+    Q_FOREACH (int accountId, accountIds) {
+        m_tasks->leakStalledTasks(accountId);
+        if (m_status == SocialNetworkSyncAdaptor::Busy) {
+            accountTaskEnded(accountId);
+        }
+    }
+}
 
+void SocialNetworkSyncAdaptor::timeoutReply(int accountId, QNetworkReply *reply)
+{
     qCWarning(lcSocialPlugin) << "network request timed out while performing sync with account" << accountId;
+    FlightRecorder::instance()->recordEvent(accountId, "timeout");
 
-    m_networkReplyTimeouts[accountId].remove(reply);
     reply->setProperty("isError", QVariant::fromValue<bool>(true));
     reply->finished(); // invoke finished, so that the error handling there decrements the semaphore etc.
     reply->disconnect();
@@ -343,43 +628,159 @@ void SocialNetworkSyncAdaptor::timeoutReply()
 void SocialNetworkSyncAdaptor::setupReplyTimeout(int accountId, QNetworkReply *reply, int msecs)
 {
     // this function should be called whenever a new network request is performed.
-    QTimer *timer = new QTimer(this);
-    timer->setSingleShot(true);
-    timer->setInterval(msecs);
-    timer->setProperty("accountId", accountId);
-    timer->setProperty("networkReply", QVariant::fromValue<QNetworkReply*>(reply));
-    connect(timer, &QTimer::timeout, this, &SocialNetworkSyncAdaptor::timeoutReply);
-    timer->start();
-    m_networkReplyTimeouts[accountId].insert(reply, timer);
+    m_replyDeadlines->arm(accountId, reply, msecs);
+    m_networkMetrics->requestStarted(accountId, reply);
 }
 
 void SocialNetworkSyncAdaptor::removeReplyTimeout(int accountId, QNetworkReply *reply)
 {
     // this function should be called by the finished() handler for the reply.
-    QTimer *timer = m_networkReplyTimeouts[accountId].value(reply);
-    if (!reply) {
-        return;
-    }
-
-    delete timer;
-    m_networkReplyTimeouts[accountId].remove(reply);
+    Q_UNUSED(accountId)
+    m_replyDeadlines->disarm(reply);
+    m_networkMetrics->requestFinished(reply);
 }
 
 void SocialNetworkSyncAdaptor::triggerReplyTimeouts()
 {
     // if we've lost network connectivity, we should immediately timeout all replies.
-    Q_FOREACH (int accountId, m_networkReplyTimeouts.keys()) {
-        Q_FOREACH (QTimer *timer, m_networkReplyTimeouts[accountId]) {
-            timer->stop();
-            timer->setInterval(1);
-            timer->start();
-        }
+    m_replyDeadlines->expireAll();
+}
+
+/*!
+    \internal
+    Returns the scope of the conditional request validators of this adaptor
+    for the given account.  Requests which set this scope as their
+    SocialdNetworkAccessManager::ValidatorScopeAttribute are sent as
+    conditional requests, and replies to them have the "notModified"
+    property set if the server reports that the data has not changed.
+*/
+QString SocialNetworkSyncAdaptor::validatorScope(int accountId) const
+{
+    return QStringLiteral("%1-%2-%3").arg(m_serviceName, dataTypeName(m_dataType)).arg(accountId);
+}
+
+/*!
+    \internal
+    Stores the validators received for the given account during this sync.
+    Should only be called once the data of the replies has been saved.
+*/
+void SocialNetworkSyncAdaptor::commitValidators(int accountId)
+{
+    SocialdNetworkAccessManager *qnam = qobject_cast<SocialdNetworkAccessManager*>(m_networkAccessManager);
+    if (qnam) {
+        qnam->commitValidators(validatorScope(accountId));
+    }
+}
+
+void SocialNetworkSyncAdaptor::discardValidators(int accountId)
+{
+    SocialdNetworkAccessManager *qnam = qobject_cast<SocialdNetworkAccessManager*>(m_networkAccessManager);
+    if (qnam) {
+        qnam->discardValidators(validatorScope(accountId));
+    }
+}
+
+void SocialNetworkSyncAdaptor::clearValidators(int accountId)
+{
+    SocialdNetworkAccessManager *qnam = qobject_cast<SocialdNetworkAccessManager*>(m_networkAccessManager);
+    if (qnam) {
+        qnam->clearValidators(validatorScope(accountId));
     }
 }
 
+/*!
+    \internal
+    Paces the requests of this adaptor to the given host (and its
+    subdomains) to the given rate, allowing bursts of up to burst
+    requests.  Requests over the limit are delayed, not rejected.
+*/
+void SocialNetworkSyncAdaptor::setRequestRateLimit(const QString &host, double requestsPerSecond, int burst)
+{
+    SocialdNetworkAccessManager *qnam = qobject_cast<SocialdNetworkAccessManager*>(m_networkAccessManager);
+    if (qnam) {
+        qnam->setRateLimit(host, requestsPerSecond, burst);
+    }
+}
+
+/*!
+    \internal
+    Retries the idempotent requests of this adaptor to the given host
+    (and its subdomains) up to maxRetries times after transient failures.
+    The reply only finishes once, with the result of the last attempt.
+*/
+void SocialNetworkSyncAdaptor::setRequestRetryLimit(const QString &host, int maxRetries)
+{
+    SocialdNetworkAccessManager *qnam = qobject_cast<SocialdNetworkAccessManager*>(m_networkAccessManager);
+    if (qnam) {
+        qnam->setRetryLimit(host, maxRetries);
+    }
+}
+
+/*!
+    \internal
+    Returns whether a bulk transfer of about expectedBytes, such as an
+    avatar download, may be started on the current network link.  On
+    metered or weak links such transfers are limited to a per-sync
+    budget, see NetworkCostPolicy; deferred transfers should be left
+    for the next sync.
+*/
+bool SocialNetworkSyncAdaptor::allowBulkTransfer(qint64 expectedBytes)
+{
+    return m_costPolicy->allowBulkTransfer(expectedBytes);
+}
+
+/*!
+    \internal
+    Returns the checkpoint saved for the stream of the given account by an
+    interrupted sync, or an empty object, and removes it.  The checkpoint
+    should be saved again if the resumed download is interrupted too.
+*/
+QJsonObject SocialNetworkSyncAdaptor::takeCheckpoint(int accountId, const QString &stream)
+{
+    return SyncCheckpointStore(m_serviceName, dataTypeName(m_dataType), accountId).take(stream);
+}
+
+void SocialNetworkSyncAdaptor::saveCheckpoint(int accountId, const QString &stream, const QJsonObject &checkpoint)
+{
+    qCInfo(lcSocialPlugin) << "saving sync checkpoint" << stream << "for account" << accountId;
+    SyncCheckpointStore(m_serviceName, dataTypeName(m_dataType), accountId).save(stream, checkpoint);
+}
+
+QString SocialNetworkSyncAdaptor::accessTokenScope(const QString &mechanism, const QVariantMap &sessionParameters)
+{
+    return AccessTokenBroker::scope(mechanism, sessionParameters);
+}
+
+QString SocialNetworkSyncAdaptor::cachedAccessToken(int accountId, const QString &scope) const
+{
+    return AccessTokenBroker::instance()->token(accountId, scope);
+}
+
+void SocialNetworkSyncAdaptor::cacheAccessToken(int accountId, const QString &scope, const QVariantMap &signonResponse)
+{
+    AccessTokenBroker::instance()->insert(accountId, scope,
+                                          signonResponse.value(QStringLiteral("AccessToken")).toString(),
+                                          signonResponse.value(QStringLiteral("ExpiresIn")).toInt());
+}
+
+// Must be called when the server rejects a token, e.g. with HTTP 401.
+void SocialNetworkSyncAdaptor::invalidateAccessTokens(int accountId)
+{
+    AccessTokenBroker::instance()->invalidate(accountId);
+}
+
+/*!
+    \internal
+    Parses the whole of \a replyData as a JSON object.  Handlers of replies
+    which may contain large arrays should instead use a JsonStreamReader
+    attached to the reply, to parse the array elements as they arrive.
+*/
 QJsonObject SocialNetworkSyncAdaptor::parseJsonObjectReplyData(const QByteArray &replyData, bool *ok)
 {
-    QJsonDocument jsonDocument = QJsonDocument::fromJson(replyData);
+    JsonStreamReader reader;
+    reader.addData(replyData);
+    reader.finish();
+    QJsonDocument jsonDocument = reader.envelope();
     *ok = !jsonDocument.isEmpty();
     if (*ok && jsonDocument.isObject()) {
         return jsonDocument.object();
@@ -390,7 +791,10 @@ QJsonObject SocialNetworkSyncAdaptor::parseJsonObjectReplyData(const QByteArray
 
 QJsonArray SocialNetworkSyncAdaptor::parseJsonArrayReplyData(const QByteArray &replyData, bool *ok)
 {
-    QJsonDocument jsonDocument = QJsonDocument::fromJson(replyData);
+    JsonStreamReader reader;
+    reader.addData(replyData);
+    reader.finish();
+    QJsonDocument jsonDocument = reader.envelope();
     *ok = !jsonDocument.isEmpty();
     if (*ok && jsonDocument.isArray()) {
         return jsonDocument.array();
@@ -435,36 +839,53 @@ QString SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::DataTyp
     return QString();
 }
 
+/*!
+    \internal
+    Removes the cached images of the given account, e.g. of a removed account.
+    The files and database entries are removed in the background, see
+    ImageCachePurger; the purge is completed before the adaptor is destroyed.
+*/
 void SocialNetworkSyncAdaptor::purgeCachedImages(SocialImagesDatabase *database,
                                                  int accountId)
 {
     database->queryImages(accountId);
     database->wait();
 
-    QList<SocialImage::ConstPtr> images = database->images();
-    foreach (SocialImage::ConstPtr image, images) {
-        qCDebug(lcSocialPlugin) << "Purge cached image " << image->imageFile() << " for account " << image->accountId();
-        QFile::remove(image->imageFile());
-    }
-
-    database->removeImages(images);
-    database->commit();
-    database->wait();
+    const QList<SocialImage::ConstPtr> images = database->images();
+    qCDebug(lcSocialPlugin) << "purging" << images.size() << "cached images for account" << accountId;
+    imagePurger()->purge(images, false);
 }
 
+/*!
+    \internal
+    Removes the expired cached images of the given account in the background.
+    The purge is interrupted if another sync is started by this adaptor,
+    which leaves the remaining images to be purged later.
+*/
 void SocialNetworkSyncAdaptor::purgeExpiredImages(SocialImagesDatabase *database,
                                                   int accountId)
 {
     database->queryExpired(accountId);
     database->wait();
 
-    QList<SocialImage::ConstPtr> images = database->images();
-    foreach (SocialImage::ConstPtr image, images) {
-        qCDebug(lcSocialPlugin) << "Purge expired image " << image->imageFile() << " for account " << image->accountId();
-        QFile::remove(image->imageFile());
+    const QList<SocialImage::ConstPtr> images = database->images();
+    qCDebug(lcSocialPlugin) << "purging" << images.size() << "expired images for account" << accountId;
+    imagePurger()->purge(images, true);
+
+    // the budget is shared by the images of every account, evict the least recently used.
+    // The purger lists the cached images itself, off the event loop.
+    QList<int> accountIds;
+    Q_FOREACH (Accounts::AccountId id, m_accountManager->accountList()) {
+        accountIds.append(id);
     }
+    imagePurger()->evict(accountIds, ImageCachePurger::budget());
+}
 
-    database->removeImages(images);
-    database->commit();
-    database->wait();
+ImageCachePurger *SocialNetworkSyncAdaptor::imagePurger()
+{
+    // created on demand, it has its own connection to the image cache database.
+    if (!m_imagePurger) {
+        m_imagePurger = new ImageCachePurger(this);
+    }
+    return m_imagePurger;
 }
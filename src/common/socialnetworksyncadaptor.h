@@ -29,6 +29,7 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QMap>
 #include <QtCore/QList>
+#include <QtCore/QVariantMap>
 
 #include "buteosyncfw_p.h"
 
@@ -37,6 +38,12 @@ class QTimer;
 class QNetworkReply;
 class SocialNetworkSyncDatabase;
 class SocialImagesDatabase;
+class ReplyDeadlineScheduler;
+class NetworkRequestMetrics;
+class SyncTaskTracker;
+class NetworkCostPolicy;
+class MemoryUsageMonitor;
+class ImageCachePurger;
 
 namespace Accounts {
     class Account;
@@ -79,6 +86,7 @@ public:
     };
     static QStringList validDataTypes();
     static QString dataTypeName(DataType t);
+    static QNetworkAccessManager *defaultNetworkAccessManager(const QString &serviceName, DataType dataType);
 
 public:
     SocialNetworkSyncAdaptor(const QString &serviceName, SocialNetworkSyncAdaptor::DataType dataType,
@@ -96,9 +104,18 @@ public:
     virtual void purgeDataForOldAccount(int accountId, PurgeMode mode = SyncPurge) = 0;
     virtual void abortSync(Sync::SyncStatus status);
 
+    // metered network policy, see NetworkCostPolicy
+    void setMeteredTransferBudget(qint64 bytes);
+    void networkLinkChanged();
+    int deferredTransferCount() const;
+
+    // whether the sync has been aborted (perhaps due to network connection loss)
+    bool syncAborted() const;
+
 Q_SIGNALS:
     void statusChanged();
     void enabledChanged();
+    void progressChanged(int percent);
 
 protected:
     virtual bool checkAccount(Accounts::Account *account);
@@ -108,23 +125,53 @@ protected:
                                 int accountId) const;
     bool updateLastSyncTimestamp(const QString &serviceName, const QString &dataType,
                                  int accountId, const QDateTime &timestamp);
+    bool flushSyncTimestamps(bool waitForWrite);
     QList<int> syncedAccounts(const QString &dataType);
     void setStatus(Status status);
     void setInitialActive(bool enabled);
     void setFinishedInactive();
 
-    // whether the sync has been aborted (perhaps due to network connection loss)
-    bool syncAborted() const;
-
-    // Semaphore system
-    void incrementSemaphore(int accountId);
-    void decrementSemaphore(int accountId);
-
-    // network reply timeouts
+    // Semaphore system, see SyncTaskTracker.  The semaphore of an account
+    // is the number of its running tasks, decrementing ends the earliest
+    // running task of the given name.
+    void incrementSemaphore(int accountId, const QString &task = QString());
+    void decrementSemaphore(int accountId, const QString &task = QString());
+    // increments the semaphore for a wait on another process, which may take
+    // longer than any network request and is not ended as a stalled task.
+    void beginExternalWait(int accountId, const QString &task);
+    int startTask(int accountId, const QString &name, int parentTask = 0);
+    void finishTask(int taskId, bool failed = false);
+
+    // network reply timeouts, msecs without any progress (see ReplyDeadlineScheduler)
     void setupReplyTimeout(int accountId, QNetworkReply *reply, int msecs = 60000);
     void removeReplyTimeout(int accountId, QNetworkReply *reply);
     void triggerReplyTimeouts();
 
+    // conditional requests, see SocialdNetworkAccessManager::ValidatorScopeAttribute
+    QString validatorScope(int accountId) const;
+    void commitValidators(int accountId);
+    void discardValidators(int accountId);
+    void clearValidators(int accountId);
+
+    // request pacing, see SocialdNetworkAccessManager::setRateLimit()
+    void setRequestRateLimit(const QString &host, double requestsPerSecond, int burst);
+
+    // retries after transient failures, see SocialdNetworkAccessManager::setRetryLimit()
+    void setRequestRetryLimit(const QString &host, int maxRetries);
+
+    // whether a bulk transfer (e.g. an avatar) may use the current network link
+    bool allowBulkTransfer(qint64 expectedBytes);
+
+    // resumable paged downloads, see SyncCheckpointStore
+    QJsonObject takeCheckpoint(int accountId, const QString &stream);
+    void saveCheckpoint(int accountId, const QString &stream, const QJsonObject &checkpoint);
+
+    // access tokens shared by the data types of an account, see AccessTokenBroker
+    static QString accessTokenScope(const QString &mechanism, const QVariantMap &sessionParameters);
+    QString cachedAccessToken(int accountId, const QString &scope) const;
+    void cacheAccessToken(int accountId, const QString &scope, const QVariantMap &signonResponse);
+    void invalidateAccessTokens(int accountId);
+
     // Parsing methods
     static QJsonObject parseJsonObjectReplyData(const QByteArray &replyData, bool *ok);
     static QJsonArray parseJsonArrayReplyData(const QByteArray &replyData, bool *ok);
@@ -139,16 +186,38 @@ protected:
     Buteo::SyncProfile *m_accountSyncProfile;
 
 protected Q_SLOTS:
-    virtual void timeoutReply();
+    virtual void timeoutReply(int accountId, QNetworkReply *reply);
+
+private Q_SLOTS:
+    void syncTimestampTimerTimeout();
+    void tasksStalled();
 
 private:
+    void accountTaskEnded(int accountId);
+    ImageCachePurger *imagePurger();
+
+    struct PendingSyncTimestamp {
+        QString serviceName;
+        QString dataType;
+        int accountId;
+        QDateTime timestamp;
+    };
+    static void mergeSyncTimestamp(QList<PendingSyncTimestamp> *list, const PendingSyncTimestamp &entry);
+
     SocialNetworkSyncDatabase *m_syncDb;
+    QTimer *m_syncTimestampTimer;
+    QList<PendingSyncTimestamp> m_pendingSyncTimestamps;
+    QList<PendingSyncTimestamp> m_writingSyncTimestamps;
     SocialNetworkSyncAdaptor::Status m_status;
     bool m_enabled;
     bool m_syncAborted;
     QString m_serviceName;
-    QMap<int, int> m_accountSyncSemaphores;
-    QMap<int, QMap<QNetworkReply*, QTimer *> > m_networkReplyTimeouts;
+    SyncTaskTracker *m_tasks;
+    ReplyDeadlineScheduler *m_replyDeadlines;
+    NetworkRequestMetrics *m_networkMetrics;
+    NetworkCostPolicy *m_costPolicy;
+    MemoryUsageMonitor *m_memoryUsage;
+    ImageCachePurger *m_imagePurger;
 };
 
 #endif // SOCIALNETWORKSYNCADAPTOR_H
@@ -0,0 +1,112 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#include "synccheckpointstore_p.h"
+#include "buteosyncfw_p.h"
+#include "trace.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+
+namespace {
+    const qint64 MaximumCheckpointAge = 3 * 24 * 60 * 60 * 1000LL; // msec
+
+    const QString SavedKey = QStringLiteral("saved");
+    const QString DataKey = QStringLiteral("data");
+}
+
+SyncCheckpointStore::SyncCheckpointStore(const QString &serviceName, const QString &dataType, int accountId)
+    : m_fileName(fileName(serviceName, dataType, accountId))
+{
+}
+
+QString SyncCheckpointStore::fileName(const QString &serviceName, const QString &dataType, int accountId)
+{
+    return QString::fromLatin1("%1/%2/checkpoints/%3.%4-%5.json")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR))
+            .arg(serviceName, dataType)
+            .arg(accountId);
+}
+
+void SyncCheckpointStore::removeAccount(const QString &serviceName, const QString &dataType, int accountId)
+{
+    QFile::remove(fileName(serviceName, dataType, accountId));
+}
+
+QJsonObject SyncCheckpointStore::read() const
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void SyncCheckpointStore::write(const QJsonObject &checkpoints)
+{
+    if (checkpoints.isEmpty()) {
+        QFile::remove(m_fileName);
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(checkpoints).toJson(QJsonDocument::Compact)) < 0
+            || !file.commit()) {
+        qCWarning(lcSocialPlugin) << "unable to write sync checkpoints to" << m_fileName;
+    }
+}
+
+QJsonObject SyncCheckpointStore::take(const QString &stream)
+{
+    QJsonObject checkpoints = read();
+    if (!checkpoints.contains(stream)) {
+        return QJsonObject();
+    }
+
+    const QJsonObject checkpoint = checkpoints.take(stream).toObject();
+    write(checkpoints);
+
+    const qint64 age = QDateTime::currentMSecsSinceEpoch() - qint64(checkpoint.value(SavedKey).toDouble());
+    if (age < 0 || age > MaximumCheckpointAge) {
+        qCDebug(lcSocialPlugin) << "discarding expired sync checkpoint" << stream;
+        return QJsonObject();
+    }
+
+    return checkpoint.value(DataKey).toObject();
+}
+
+void SyncCheckpointStore::save(const QString &stream, const QJsonObject &checkpoint)
+{
+    QJsonObject entry;
+    entry.insert(SavedKey, double(QDateTime::currentMSecsSinceEpoch()));
+    entry.insert(DataKey, checkpoint);
+
+    QJsonObject checkpoints = read();
+    checkpoints.insert(stream, entry);
+    write(checkpoints);
+}
@@ -0,0 +1,59 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+
+#ifndef SOCIALD_SYNCCHECKPOINTSTORE_P_H
+#define SOCIALD_SYNCCHECKPOINTSTORE_P_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+/*
+    Stores the paging progress of interrupted downloads, so that the
+    next sync can resume where the previous one stopped instead of
+    starting over from the first page.
+
+    A checkpoint is a JSON object (typically the token of the next page
+    to request and the data accumulated from the previous pages) stored
+    for a stream, e.g. the events of one calendar.  The checkpoints of
+    an account and data type are kept in one file in the sync database
+    directory, and expire after a few days, as the page tokens do.
+*/
+class SyncCheckpointStore
+{
+public:
+    SyncCheckpointStore(const QString &serviceName, const QString &dataType, int accountId);
+
+    // Returns the checkpoint of the stream, or an empty object if there is
+    // none, and removes it from the store.
+    QJsonObject take(const QString &stream);
+    void save(const QString &stream, const QJsonObject &checkpoint);
+
+    static void removeAccount(const QString &serviceName, const QString &dataType, int accountId);
+
+private:
+    static QString fileName(const QString &serviceName, const QString &dataType, int accountId);
+    QJsonObject read() const;
+    void write(const QJsonObject &checkpoints);
+
+    QString m_fileName;
+};
+
+#endif // SOCIALD_SYNCCHECKPOINTSTORE_P_H
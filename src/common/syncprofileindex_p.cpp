@@ -0,0 +1,175 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "syncprofileindex_p.h"
+#include "trace.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSettings>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringList>
+
+namespace {
+    const QString StampKey = QStringLiteral("stamp");
+    const QString AccountsGroup = QStringLiteral("accounts");
+}
+
+SyncProfileIndex::SyncProfileIndex(Buteo::ProfileManager *profileManager,
+                                   const QString &templateProfileName,
+                                   const QString &clientProfileName)
+    : m_profileManager(profileManager)
+    , m_templateProfileName(templateProfileName)
+    , m_clientProfileName(clientProfileName)
+    , m_stamp(-1)
+    , m_loaded(false)
+    , m_fullScanDone(false)
+{
+}
+
+QString SyncProfileIndex::indexFileName()
+{
+    return QString::fromLatin1("%1/%2/syncprofileindex.ini")
+            .arg(PRIVILEGED_DATA_DIR)
+            .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
+}
+
+// The per-account profiles are stored by msyncd in ~/.cache/msyncd/sync.
+qint64 SyncProfileIndex::profileDirectoryStamp()
+{
+    const QFileInfo info(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                         + QStringLiteral("/msyncd/sync"));
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+bool SyncProfileIndex::isValid(const Buteo::SyncProfile *profile, int accountId) const
+{
+    return profile
+            && profile->key(Buteo::KEY_ACCOUNT_ID).toInt() == accountId
+            && profile->clientProfile() != NULL
+            && profile->clientProfile()->name() == m_clientProfileName;
+}
+
+Buteo::SyncProfile *SyncProfileIndex::syncProfile(int accountId)
+{
+    ensureLoaded();
+
+    for (;;) {
+        const QString profileName = m_profiles.value(accountId);
+        if (!profileName.isEmpty()) {
+            Buteo::SyncProfile *profile = m_profileManager->syncProfile(profileName);
+            if (isValid(profile, accountId)) {
+                return profile;
+            }
+            delete profile;
+        }
+
+        if (m_fullScanDone) {
+            return 0;
+        }
+
+        // the profile may have been named differently, check every profile once.
+        rebuild(true);
+    }
+}
+
+void SyncProfileIndex::insert(int accountId, const QString &profileName)
+{
+    ensureLoaded();
+    m_profiles.insert(accountId, profileName);
+    save();
+}
+
+void SyncProfileIndex::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    const qint64 stamp = profileDirectoryStamp();
+    QSettings settings(indexFileName(), QSettings::IniFormat);
+    settings.beginGroup(m_clientProfileName);
+    if (stamp > 0 && settings.value(StampKey, -1).toLongLong() == stamp) {
+        settings.beginGroup(AccountsGroup);
+        Q_FOREACH (const QString &key, settings.childKeys()) {
+            m_profiles.insert(key.toInt(), settings.value(key).toString());
+        }
+        settings.endGroup();
+        m_stamp = stamp;
+        return;
+    }
+    settings.endGroup();
+
+    rebuild(false);
+}
+
+void SyncProfileIndex::rebuild(bool fullScan)
+{
+    m_profiles.clear();
+
+    if (fullScan) {
+        qCDebug(lcSocialPlugin) << "scanning all sync profiles for" << m_clientProfileName << "profiles";
+        QList<Buteo::SyncProfile*> syncProfiles = m_profileManager->allSyncProfiles();
+        Q_FOREACH (Buteo::SyncProfile *profile, syncProfiles) {
+            const int accountId = profile->key(Buteo::KEY_ACCOUNT_ID).toInt();
+            if (accountId > 0 && !m_profiles.contains(accountId) && isValid(profile, accountId)) {
+                m_profiles.insert(accountId, profile->name());
+            }
+        }
+        qDeleteAll(syncProfiles);
+        m_fullScanDone = true;
+    } else {
+        // per-account profiles are created as <template>-<accountId>, so they can be
+        // found without loading any profile.  They are validated when loaded.
+        const QString prefix = m_templateProfileName + QLatin1Char('-');
+        Q_FOREACH (const QString &profileName, m_profileManager->profileNames(Buteo::Profile::TYPE_SYNC)) {
+            if (!profileName.startsWith(prefix)) {
+                continue;
+            }
+            bool ok = false;
+            const int accountId = profileName.mid(prefix.size()).toInt(&ok);
+            if (ok && accountId > 0) {
+                m_profiles.insert(accountId, profileName);
+            }
+        }
+    }
+
+    save();
+}
+
+void SyncProfileIndex::save()
+{
+    m_stamp = profileDirectoryStamp();
+
+    QDir().mkpath(QFileInfo(indexFileName()).absolutePath());
+    QSettings settings(indexFileName(), QSettings::IniFormat);
+    settings.remove(m_clientProfileName);
+    settings.beginGroup(m_clientProfileName);
+    settings.setValue(StampKey, m_stamp);
+    settings.beginGroup(AccountsGroup);
+    for (QHash<int, QString>::const_iterator it = m_profiles.constBegin(); it != m_profiles.constEnd(); ++it) {
+        settings.setValue(QString::number(it.key()), it.value());
+    }
+    settings.endGroup();
+    settings.endGroup();
+    settings.sync();
+}
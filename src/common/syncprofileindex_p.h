@@ -0,0 +1,71 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_SYNCPROFILEINDEX_P_H
+#define SOCIALD_SYNCPROFILEINDEX_P_H
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "buteosyncfw_p.h"
+
+/*
+    Index of the per-account sync profiles of one client plugin,
+    mapping account ids to profile names.
+
+    Building the index only loads the profiles which are named after
+    the template profile (<template>-<accountId>), and only falls back
+    to loading every sync profile if an account can't be resolved that
+    way.  The index is stored in the sync database directory, and is
+    reused until the modification time of the msyncd profile directory
+    changes (i.e. until a profile is added, removed or renamed).
+*/
+class SyncProfileIndex
+{
+public:
+    SyncProfileIndex(Buteo::ProfileManager *profileManager,
+                     const QString &templateProfileName,
+                     const QString &clientProfileName);
+
+    // Returns the per-account profile of the account, or 0 if there is none.
+    // The caller takes ownership of the profile.
+    Buteo::SyncProfile *syncProfile(int accountId);
+
+    void insert(int accountId, const QString &profileName);
+
+private:
+    bool isValid(const Buteo::SyncProfile *profile, int accountId) const;
+    void ensureLoaded();
+    void rebuild(bool fullScan);
+    void save();
+
+    static QString indexFileName();
+    static qint64 profileDirectoryStamp();
+
+    Buteo::ProfileManager *m_profileManager;
+    QString m_templateProfileName;
+    QString m_clientProfileName;
+    QHash<int, QString> m_profiles;
+    qint64 m_stamp;
+    bool m_loaded;
+    bool m_fullScanDone;
+};
+
+#endif // SOCIALD_SYNCPROFILEINDEX_P_H
@@ -0,0 +1,245 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "synctasktracker_p.h"
+#include "trace.h"
+
+#include <QtCore/QDateTime>
+
+namespace {
+    // how long tasks may be running without any task starting or ending
+    // before they are suspected of having been leaked.
+    const int StallTimeout = 3 * 60 * 1000; // msec
+}
+
+SyncTaskTracker::SyncTaskTracker(QObject *parent)
+    : QObject(parent)
+    , m_nextId(1)
+    , m_started(0)
+    , m_ended(0)
+    , m_progress(0)
+{
+    // keeps firing for as long as the tasks make no progress.
+    m_stallTimer.setInterval(StallTimeout);
+    connect(&m_stallTimer, &QTimer::timeout, this, &SyncTaskTracker::stalled);
+}
+
+SyncTaskTracker::~SyncTaskTracker()
+{
+}
+
+int SyncTaskTracker::start(int accountId, const QString &name, int parentId, bool external)
+{
+    Task task;
+    task.id = m_nextId++;
+    task.accountId = accountId;
+    task.parentId = m_tasks.contains(parentId) ? parentId : 0;
+    task.name = name;
+    task.state = Running;
+    task.external = external;
+    task.started = QDateTime::currentMSecsSinceEpoch();
+    task.ended = 0;
+
+    m_tasks.insert(task.id, task);
+    m_running[accountId].append(task.id);
+    m_started += 1;
+    touch();
+    updateProgress();
+    return task.id;
+}
+
+bool SyncTaskTracker::finish(int taskId, State state)
+{
+    QHash<int, Task>::iterator it = m_tasks.find(taskId);
+    if (it == m_tasks.end() || it->state != Running) {
+        return false;
+    }
+
+    it->state = state == Running ? Finished : state;
+    it->ended = QDateTime::currentMSecsSinceEpoch();
+
+    QHash<int, QList<int> >::iterator rit = m_running.find(it->accountId);
+    if (rit != m_running.end()) {
+        rit->removeOne(taskId);
+        if (rit->isEmpty()) {
+            m_running.erase(rit);
+        }
+    }
+
+    Q_FOREACH (const Task &child, runningTasks(it->accountId)) {
+        if (child.parentId == taskId) {
+            qCWarning(lcSocialPlugin) << "task" << describe(*it) << "ended before its subtask" << describe(child);
+        }
+    }
+
+    m_ended += 1;
+    touch();
+    updateProgress();
+    return true;
+}
+
+// Finishes the most recently started running task of the account, for
+// callers which don't keep track of their tasks.  Returns 0 if the
+// account has no running tasks.
+int SyncTaskTracker::finishLatest(int accountId)
+{
+    const QList<int> running = m_running.value(accountId);
+    if (running.isEmpty()) {
+        return 0;
+    }
+
+    const int taskId = running.last();
+    finish(taskId);
+    return taskId;
+}
+
+// Finishes the earliest started running task of the account with the
+// given name, as tasks of the same name are usually answered in the
+// order they were requested.  Returns 0 if there is no such task.
+int SyncTaskTracker::finishNamed(int accountId, const QString &name)
+{
+    Q_FOREACH (int taskId, m_running.value(accountId)) {
+        if (m_tasks.value(taskId).name == name) {
+            finish(taskId);
+            return taskId;
+        }
+    }
+    return 0;
+}
+
+int SyncTaskTracker::accountOf(int taskId) const
+{
+    QHash<int, Task>::const_iterator it = m_tasks.constFind(taskId);
+    return it == m_tasks.constEnd() ? -1 : it->accountId;
+}
+
+int SyncTaskTracker::runningCount(int accountId) const
+{
+    return m_running.value(accountId).size();
+}
+
+bool SyncTaskTracker::hasRunningTasks() const
+{
+    return !m_running.isEmpty();
+}
+
+QList<SyncTaskTracker::Task> SyncTaskTracker::runningTasks(int accountId) const
+{
+    QList<Task> retn;
+    for (QHash<int, QList<int> >::const_iterator it = m_running.constBegin(); it != m_running.constEnd(); ++it) {
+        if (accountId >= 0 && it.key() != accountId) {
+            continue;
+        }
+        Q_FOREACH (int taskId, it.value()) {
+            retn.append(m_tasks.value(taskId));
+        }
+    }
+    return retn;
+}
+
+QList<SyncTaskTracker::Task> SyncTaskTracker::leakRunningTasks(int accountId)
+{
+    const QList<Task> leaked = runningTasks(accountId);
+    Q_FOREACH (const Task &task, leaked) {
+        qCWarning(lcSocialPlugin) << "leaked task" << describe(task) << "of account" << task.accountId;
+        finish(task.id, Leaked);
+    }
+    return leaked;
+}
+
+// Ends the running tasks which could have stalled, i.e. all but the external ones.
+QList<SyncTaskTracker::Task> SyncTaskTracker::leakStalledTasks(int accountId)
+{
+    QList<Task> leaked;
+    Q_FOREACH (const Task &task, runningTasks(accountId)) {
+        if (!task.external) {
+            qCWarning(lcSocialPlugin) << "leaked task" << describe(task) << "of account" << task.accountId;
+            finish(task.id, Leaked);
+            leaked.append(task);
+        }
+    }
+    return leaked;
+}
+
+int SyncTaskTracker::progress() const
+{
+    return m_progress;
+}
+
+void SyncTaskTracker::updateProgress()
+{
+    int percent = 100;
+    if (hasRunningTasks()) {
+        percent = m_started > 0 ? qMin(99, m_ended * 100 / m_started) : 0;
+    }
+    if (percent > m_progress) {
+        m_progress = percent;
+        emit progressChanged(m_progress);
+    }
+}
+
+// Forgets the tasks which have ended, and starts a new sync run.
+void SyncTaskTracker::reset()
+{
+    QHash<int, Task>::iterator it = m_tasks.begin();
+    while (it != m_tasks.end()) {
+        if (it->state == Running) {
+            ++it;
+        } else {
+            it = m_tasks.erase(it);
+        }
+    }
+    m_started = m_tasks.size();
+    m_ended = 0;
+    m_progress = 0;
+    if (!hasStallableTasks()) {
+        m_stallTimer.stop();
+    }
+}
+
+QString SyncTaskTracker::describe(const Task &task)
+{
+    QString retn = QStringLiteral("%1 (%2)").arg(task.name.isEmpty() ? QStringLiteral("unnamed") : task.name)
+                                            .arg(task.id);
+    const qint64 end = task.state == Running ? QDateTime::currentMSecsSinceEpoch() : task.ended;
+    retn += QStringLiteral(" after %1 msec").arg(end - task.started);
+    return retn;
+}
+
+bool SyncTaskTracker::hasStallableTasks() const
+{
+    for (QHash<int, QList<int> >::const_iterator it = m_running.constBegin(); it != m_running.constEnd(); ++it) {
+        Q_FOREACH (int taskId, it.value()) {
+            if (!m_tasks.value(taskId).external) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void SyncTaskTracker::touch()
+{
+    if (hasStallableTasks()) {
+        m_stallTimer.start();
+    } else {
+        m_stallTimer.stop();
+    }
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_SYNCTASKTRACKER_P_H
+#define SOCIALD_SYNCTASKTRACKER_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+/*
+    Tracks the outstanding asynchronous work of a sync adaptor as
+    named tasks per account, each with an optional parent task, a
+    state, and start and end times.
+
+    An account is busy while it has running tasks.  The progress of
+    the sync run is the share of the started tasks which have ended;
+    as tasks are discovered while syncing, it is kept from going
+    backwards until the run is reset.
+
+    If tasks are running but none has started or ended for a while,
+    stalled() is emitted, so that the owner can check whether the
+    tasks have been leaked (i.e. will never be finished) and end them
+    with leakStalledTasks().  External tasks, which wait for another
+    process (e.g. the backup service) for as long as it takes, are
+    never considered stalled.
+*/
+class SyncTaskTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Running,
+        Finished,
+        Failed,
+        Leaked
+    };
+
+    struct Task {
+        int id;
+        int accountId;
+        int parentId;
+        QString name;
+        State state;
+        bool external;
+        qint64 started; // msecs since the epoch
+        qint64 ended;
+    };
+
+    explicit SyncTaskTracker(QObject *parent = nullptr);
+    ~SyncTaskTracker();
+
+    int start(int accountId, const QString &name, int parentId = 0, bool external = false);
+    bool finish(int taskId, State state = Finished);
+    int finishLatest(int accountId);
+    int finishNamed(int accountId, const QString &name);
+
+    int accountOf(int taskId) const;
+    int runningCount(int accountId) const;
+    bool hasRunningTasks() const;
+    QList<Task> runningTasks(int accountId = -1) const;
+    QList<Task> leakRunningTasks(int accountId = -1);
+    QList<Task> leakStalledTasks(int accountId = -1);
+
+    int progress() const;
+    void reset();
+
+    static QString describe(const Task &task);
+
+Q_SIGNALS:
+    void progressChanged(int percent);
+    void stalled();
+
+private:
+    void touch();
+    bool hasStallableTasks() const;
+    void updateProgress();
+
+    QHash<int, Task> m_tasks;
+    QHash<int, QList<int> > m_running; // per account, in start order
+    QTimer m_stallTimer;
+    int m_nextId;
+    int m_started;
+    int m_ended;
+    int m_progress;
+};
+
+#endif // SOCIALD_SYNCTASKTRACKER_P_H
@@ -22,3 +22,17 @@
 
 Q_LOGGING_CATEGORY(lcSocialPlugin, "buteo.plugin.social", QtWarningMsg)
 Q_LOGGING_CATEGORY(lcSocialPluginTrace, "buteo.plugin.social.trace", QtWarningMsg)
+
+#include <QStringList>
+
+void traceDumpLines(const QString &text)
+{
+    Q_FOREACH (QString line, text.split(QLatin1Char('\n'), QString::SkipEmptyParts)) {
+        qCDebug(lcSocialPluginTrace) << line.replace(QLatin1Char('\r'), QLatin1Char(' '));
+    }
+}
+
+void traceDumpLines(const QByteArray &utf8)
+{
+    traceDumpLines(QString::fromUtf8(utf8));
+}
@@ -23,8 +23,24 @@
 #define TRACE_H
 
 #include <QLoggingCategory>
+#include <QByteArray>
+#include <QString>
 
 Q_DECLARE_LOGGING_CATEGORY(lcSocialPlugin)
 Q_DECLARE_LOGGING_CATEGORY(lcSocialPluginTrace)
 
+// Logs text (a QString, or UTF-8 in a QByteArray) line by line to
+// lcSocialPluginTrace, as the log can't handle newlines.  The payload
+// is only evaluated if tracing is enabled, so it may be an expression
+// which converts or serializes a whole reply.
+#define SOCIALD_TRACE_DUMP(payload) \
+    do { \
+        if (lcSocialPluginTrace().isDebugEnabled()) { \
+            traceDumpLines(payload); \
+        } \
+    } while (0)
+
+void traceDumpLines(const QString &text);
+void traceDumpLines(const QByteArray &utf8);
+
 #endif // TRACE_H
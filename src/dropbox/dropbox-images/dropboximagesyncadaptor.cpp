@@ -46,6 +46,8 @@
 // with appropriate data.
 
 namespace {
+    const QString CameraRollCheckpoint = QStringLiteral("camera-roll");
+
     bool filenameHasImageExtension(const QString &filename) {
         return (filename.endsWith(".jpg", Qt::CaseInsensitive)
                 || filename.endsWith(".jpeg", Qt::CaseInsensitive)
@@ -168,7 +170,7 @@ void DropboxImageSyncAdaptor::queryCameraRollCursor(int accountId, const QString
                 this, SLOT(cameraRollCursorFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("cameraRollCursor"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from Dropbox account with id" << accountId;
@@ -202,7 +204,7 @@ void DropboxImageSyncAdaptor::cameraRollCursorFinishedHandler()
             qCDebug(lcSocialPlugin) << line;
         }
         clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("cameraRollCursor"));
         return;
     }
 
@@ -214,13 +216,24 @@ void DropboxImageSyncAdaptor::cameraRollCursorFinishedHandler()
     if (!dbAlbum.isNull() && dbAlbum->hash() == cursor) {
         qCDebug(lcSocialPlugin) << "album with id" << albumId << "by user" << userId
                                 << "from Dropbox account with id" << accountId << "doesn't need sync";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("cameraRollCursor"));
         return;
     }
 
-    // some changes have occurred, we need to sync.
-    queryCameraRoll(accountId, accessToken, albumId, cursor, QString());
-    decrementSemaphore(accountId);
+    // some changes have occurred, we need to sync.  If an earlier sync was
+    // interrupted while listing the same state of the folder, resume it.
+    const QJsonObject checkpoint = takeCheckpoint(accountId, CameraRollCheckpoint);
+    QString continuationCursor;
+    if (checkpoint.value(QLatin1String("cursor")).toString() == cursor) {
+        continuationCursor = checkpoint.value(QLatin1String("continuationCursor")).toString();
+    }
+    if (!continuationCursor.isEmpty()) {
+        m_retrievedObjects = checkpoint.value(QLatin1String("entries")).toArray();
+        qCInfo(lcSocialPlugin) << "resuming camera roll listing for Dropbox account with id" << accountId
+                               << "after" << m_retrievedObjects.size() << "entries";
+    }
+    queryCameraRoll(accountId, accessToken, albumId, cursor, continuationCursor);
+    decrementSemaphore(accountId, QStringLiteral("cameraRollCursor"));
 }
 
 void DropboxImageSyncAdaptor::queryCameraRoll(int accountId, const QString &accessToken, const QString &albumId,
@@ -259,6 +272,7 @@ void DropboxImageSyncAdaptor::queryCameraRoll(int accountId, const QString &acce
         reply->setProperty("accessToken", accessToken);
         reply->setProperty("albumId", albumId);
         reply->setProperty("cursor", cursor);
+        reply->setProperty("continuationCursor", continuationCursor);
         connect(reply, SIGNAL(error(QNetworkReply::NetworkError)),
                 this, SLOT(errorHandler(QNetworkReply::NetworkError)));
         connect(reply, SIGNAL(sslErrors(QList<QSslError>)),
@@ -267,7 +281,7 @@ void DropboxImageSyncAdaptor::queryCameraRoll(int accountId, const QString &acce
                 this, SLOT(cameraRollFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("cameraRoll"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from Dropbox account with id" << accountId;
@@ -283,6 +297,7 @@ void DropboxImageSyncAdaptor::cameraRollFinishedHandler()
     QString accessToken = reply->property("accessToken").toString();
     QString albumId = reply->property("albumId").toString();
     QString cursor = reply->property("cursor").toString();
+    QString requestedCursor = reply->property("continuationCursor").toString();
     QByteArray replyData = reply->readAll();
     disconnect(reply);
     reply->deleteLater();
@@ -301,8 +316,16 @@ void DropboxImageSyncAdaptor::cameraRollFinishedHandler()
         Q_FOREACH (const QString &line, errorResponse.split('\n')) {
             qCDebug(lcSocialPlugin) << line;
         }
+        if (!requestedCursor.isEmpty()) {
+            // the previous pages were received, the next sync can continue from this one.
+            QJsonObject checkpoint;
+            checkpoint.insert(QLatin1String("cursor"), cursor);
+            checkpoint.insert(QLatin1String("continuationCursor"), requestedCursor);
+            checkpoint.insert(QLatin1String("entries"), m_retrievedObjects);
+            saveCheckpoint(accountId, CameraRollCheckpoint, checkpoint);
+        }
         clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("cameraRoll"));
         return;
     }
 
@@ -392,7 +415,7 @@ void DropboxImageSyncAdaptor::cameraRollFinishedHandler()
         checkRemovedImages(albumId);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("cameraRoll"));
 }
 
 bool DropboxImageSyncAdaptor::haveAlreadyCachedImage(const QString &imageId, const QString &imageUrl)
@@ -444,7 +467,7 @@ void DropboxImageSyncAdaptor::possiblyAddNewUser(const QString &userId, int acco
                 this, SLOT(sslErrorsHandler(QList<QSslError>)));
         connect(reply, SIGNAL(finished()), this, SLOT(userFinishedHandler()));
 
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("user"));
         setupReplyTimeout(accountId, reply);
     }
 }
@@ -473,7 +496,7 @@ void DropboxImageSyncAdaptor::userFinishedHandler()
     }
 
     m_db.addUser(QString::number(accountId), QDateTime::currentDateTime(), display_name);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("user"));
 }
 
 bool DropboxImageSyncAdaptor::initRemovalDetectionLists(int accountId)
@@ -113,8 +113,8 @@ void DropboxBackupOperationSyncAdaptor::beginSync(int accountId, const QString &
 
         // Save the file path, then wait for org.sailfish.backup service to finish creating the
         // backup before continuing in cloudBackupStatusChanged().
-        // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        // creating the backup can take longer than any request, don't treat it as stalled.
+        beginExternalWait(accountId, QStringLiteral("backup"));
         m_localFileInfo = QFileInfo(createBackupReply.value());
         break;
     }
@@ -188,22 +188,22 @@ void DropboxBackupOperationSyncAdaptor::cloudBackupStatusChanged(int accountId,
             qCWarning(lcSocialPlugin) << "Backup finished, but cannot find the backup file:"
                                       << m_localFileInfo.absoluteFilePath();
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(m_accountId);
+            decrementSemaphore(m_accountId, QStringLiteral("backup"));
             return;
         }
 
         beginSyncOperation(m_accountId, m_accessToken);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Canceled")) {
         qCWarning(lcSocialPlugin) << "Cloud backup was canceled";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Error")) {
         qCWarning(lcSocialPlugin) << "Failed to create backup file:" << m_localFileInfo.absoluteFilePath();
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
     }
 }
 
@@ -215,7 +215,7 @@ void DropboxBackupOperationSyncAdaptor::cloudBackupError(int accountId, const QS
 
     qCWarning(lcSocialPlugin) << "Cloud backup error was:" << error << errorString;
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("backup"));
 }
 
 void DropboxBackupOperationSyncAdaptor::cloudRestoreStatusChanged(int accountId, const QString &status)
@@ -230,12 +230,12 @@ void DropboxBackupOperationSyncAdaptor::cloudRestoreStatusChanged(int accountId,
     if (status == QLatin1String("Canceled")) {
         qCWarning(lcSocialPlugin) << "Cloud backup restore was canceled";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Error")) {
         qCWarning(lcSocialPlugin) << "Cloud backup restore failed";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
     }
 }
 
@@ -303,7 +303,7 @@ void DropboxBackupOperationSyncAdaptor::requestList(int accountId,
                 this, SLOT(remotePathFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("list"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from Dropbox account with id" << accountId;
@@ -360,7 +360,7 @@ void DropboxBackupOperationSyncAdaptor::remotePathFinishedHandler()
         } else {
             qCWarning(lcSocialPlugin) << errorMessage;
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("list"));
             return;
         }
     }
@@ -430,7 +430,7 @@ void DropboxBackupOperationSyncAdaptor::remotePathFinishedHandler()
             if (!fileFound) {
                 qCWarning(lcSocialPlugin) << "Cannot find requested file on remote server:" << remoteFile;
                 setStatus(SocialNetworkSyncAdaptor::Error);
-                decrementSemaphore(accountId);
+                decrementSemaphore(accountId, QStringLiteral("list"));
                 return;
             }
         }
@@ -439,11 +439,11 @@ void DropboxBackupOperationSyncAdaptor::remotePathFinishedHandler()
     default:
         qCWarning(lcSocialPlugin) << "Unrecognized sync operation: " << operation();
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("list"));
         return;
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("list"));
 }
 
 void DropboxBackupOperationSyncAdaptor::requestData(int accountId,
@@ -484,7 +484,7 @@ void DropboxBackupOperationSyncAdaptor::requestData(int accountId,
                 this, SLOT(remoteFileFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("download"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to create download request:" << remotePath << remoteFile
@@ -509,7 +509,7 @@ void DropboxBackupOperationSyncAdaptor::remoteFileFinishedHandler()
                                   << accountId;
         debugDumpResponse(data);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("download"));
         return;
     }
 
@@ -530,12 +530,12 @@ void DropboxBackupOperationSyncAdaptor::remoteFileFinishedHandler()
         if (!file.open(QIODevice::WriteOnly)) {
             qCWarning(lcSocialPlugin) << "could not open" << file.fileName() << "locally for writing!";
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("download"));
         } else if (!file.write(data)) {
             qCWarning(lcSocialPlugin) << "could not write data to" << file.fileName() << "locally from" << remotePath
                                       << remoteFile << "for Dropbox account:" << accountId;
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("download"));
         } else {
             qCDebug(lcSocialPlugin) << "successfully wrote" << data.size() << "bytes to:" << file.fileName()
                                     << "from:" << remoteFile;
@@ -543,7 +543,7 @@ void DropboxBackupOperationSyncAdaptor::remoteFileFinishedHandler()
         file.close();
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("download"));
 }
 
 void DropboxBackupOperationSyncAdaptor::uploadData(int accountId, const QString &accessToken, const QString &localPath,
@@ -636,7 +636,7 @@ void DropboxBackupOperationSyncAdaptor::uploadData(int accountId, const QString
         }
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("upload"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to create upload request:"
@@ -664,7 +664,7 @@ void DropboxBackupOperationSyncAdaptor::createRemotePathFinishedHandler()
             qCWarning(lcSocialPlugin) << "remote path creation failed:" << httpCode << QString::fromUtf8(data);
             debugDumpResponse(data);
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("upload"));
             return;
         } else {
             qCDebug(lcSocialPlugin) << "remote path creation had conflict: already exists:"
@@ -681,7 +681,7 @@ void DropboxBackupOperationSyncAdaptor::createRemotePathFinishedHandler()
         uploadData(accountId, accessToken, localPath, remotePath, localFile);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("upload"));
 }
 
 void DropboxBackupOperationSyncAdaptor::createRemoteFileFinishedHandler()
@@ -705,13 +705,13 @@ void DropboxBackupOperationSyncAdaptor::createRemoteFileFinishedHandler()
                                   << ":" << parsed.value("error_summary").toString();
         debugDumpResponse(data);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("upload"));
         return;
     }
 
     qCDebug(lcSocialPlugin) << "successfully uploaded backup of file:" << localPath << localFile << "to:" << remotePath
                             << "for Dropbox account:" << accountId;
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("upload"));
 }
 
 void DropboxBackupOperationSyncAdaptor::downloadProgressHandler(qint64 bytesReceived, qint64 bytesTotal)
@@ -20,17 +20,16 @@
  ****************************************************************************/
 
 #include "dropboxdatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "trace.h"
 
+#include <QtCore/QTimer>
 #include <QtCore/QVariantMap>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
 
-//libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
-
 // libaccounts-qt5
 #include <Accounts/Manager>
 #include <Accounts/Account>
@@ -43,7 +42,7 @@
 #include <SignOn/SessionData>
 
 DropboxDataTypeSyncAdaptor::DropboxDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
-    : SocialNetworkSyncAdaptor("dropbox", dataType, 0, parent), m_triedLoading(false)
+    : SocialNetworkSyncAdaptor("dropbox", dataType, 0, parent)
 {
 }
 
@@ -87,7 +86,7 @@ void DropboxDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
@@ -101,6 +100,8 @@ void DropboxDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     if (err == QNetworkReply::AuthenticationRequiredError) {
+        // the token may have been revoked, don't share it with the other data types.
+        invalidateAccessTokens(reply->property("accountId").toInt());
         qCInfo(lcSocialPlugin) << "sociald:Dropbox: would normally set CredentialsNeedUpdate for account"
                                << reply->property("accountId").toInt()
                                << "but could be spurious. Http code:" << httpCode;
@@ -143,47 +144,12 @@ QString DropboxDataTypeSyncAdaptor::content() const
 
 QString DropboxDataTypeSyncAdaptor::clientId()
 {
-    if (!m_triedLoading) {
-        loadClientIdAndSecret();
-    }
-    return m_clientId;
+    return KeyProviderCache::storedKey("dropbox", "dropbox-sync", "client_id");
 }
 
 QString DropboxDataTypeSyncAdaptor::clientSecret()
 {
-    if (!m_triedLoading) {
-        loadClientIdAndSecret();
-    }
-    return m_clientSecret;
-}
-
-void DropboxDataTypeSyncAdaptor::loadClientIdAndSecret()
-{
-    m_triedLoading = true;
-    char *cClientId = NULL;
-    char *cClientSecret = NULL;
-
-    int cSuccess = SailfishKeyProvider_storedKey("dropbox", "dropbox-sync", "client_id", &cClientId);
-    if (cClientId == NULL) {
-        return;
-    } else if (cSuccess != 0) {
-        free(cClientId);
-        return;
-    }
-
-    m_clientId = QLatin1String(cClientId);
-    free(cClientId);
-
-    cSuccess = SailfishKeyProvider_storedKey("dropbox", "dropbox-sync", "client_secret", &cClientSecret);
-    if (cClientSecret == NULL) {
-        return;
-    } else if (cSuccess != 0) {
-        free(cClientSecret);
-        return;
-    }
-
-    m_clientSecret = QLatin1String(cClientSecret);
-    free(cClientSecret);
+    return KeyProviderCache::storedKey("dropbox", "dropbox-sync", "client_secret");
 }
 
 void DropboxDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
@@ -204,37 +170,47 @@ void DropboxDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     // Fetch consumer key and secret from keyprovider
     int accountId = account->id();
     if (!checkAccount(account) || clientId().isEmpty() || clientSecret().isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    // grab out a valid identity for the sync service.
     Accounts::Service srv(m_accountManager->service(syncServiceName()));
     account->selectService(srv);
+    Accounts::AccountService accSrv(account, srv);
+    QString method = accSrv.authData().method();
+    QString mechanism = accSrv.authData().mechanism();
+    QVariantMap signonSessionData = accSrv.authData().parameters();
+    signonSessionData.insert("ClientId", clientId());
+    signonSessionData.insert("ClientSecret", clientSecret());
+    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
+
+    // another data type of the account may have signed in recently.
+    const QString tokenScope = accessTokenScope(mechanism, signonSessionData);
+    const QString cachedToken = cachedAccessToken(accountId, tokenScope);
+    if (!cachedToken.isEmpty()) {
+        QTimer::singleShot(0, account, [this, account, cachedToken] {
+            signedIn(account, cachedToken);
+        });
+        return;
+    }
+
+    // grab out a valid identity for the sync service.
     SignOn::Identity *identity = account->credentialsId() > 0
             ? SignOn::Identity::existingIdentity(account->credentialsId()) : 0;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "account" << accountId << "has no valid credentials; cannot sign in";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    Accounts::AccountService accSrv(account, srv);
-    QString method = accSrv.authData().method();
-    QString mechanism = accSrv.authData().mechanism();
     SignOn::AuthSession *session = identity->createSession(method);
     if (!session) {
         qCWarning(lcSocialPlugin) << "could not create signon session for account" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    QVariantMap signonSessionData = accSrv.authData().parameters();
-    signonSessionData.insert("ClientId", clientId());
-    signonSessionData.insert("ClientSecret", clientSecret());
-    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
-
     connect(session, &SignOn::AuthSession::response,
             this, &DropboxDataTypeSyncAdaptor::signOnResponse,
             Qt::UniqueConnection);
@@ -243,6 +219,7 @@ void DropboxDataTypeSyncAdaptor::signIn(Accounts::Account *account)
             Qt::UniqueConnection);
 
     session->setProperty("account", QVariant::fromValue<Accounts::Account*>(account));
+    session->setProperty("tokenScope", tokenScope);
     session->setProperty("identity", QVariant::fromValue<SignOn::Identity*>(identity));
     session->process(SignOn::SessionData(signonSessionData), mechanism);
 }
@@ -269,7 +246,7 @@ void DropboxDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void DropboxDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -290,6 +267,19 @@ void DropboxDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &respo
         qCInfo(lcSocialPlugin) << "signon response for account with id" << accountId << "contained no access token";
     }
 
+    cacheAccessToken(accountId, session->property("tokenScope").toString(), data);
+
+    session->disconnect(this);
+    identity->destroySession(session);
+    identity->deleteLater();
+
+    signedIn(account, accessToken);
+}
+
+void DropboxDataTypeSyncAdaptor::signedIn(Accounts::Account *account, const QString &accessToken)
+{
+    int accountId = account->id();
+
     m_api = account->value(QStringLiteral("hosts/ApiHost")).toString();
     if (m_api.isEmpty()) {
         m_api = QStringLiteral("https://api.dropboxapi.com");
@@ -299,14 +289,11 @@ void DropboxDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &respo
         m_content = QStringLiteral("https://content.dropboxapi.com");
     }
 
-    session->disconnect(this);
-    identity->destroySession(session);
-    identity->deleteLater();
     account->deleteLater();
 
     if (!accessToken.isEmpty()) {
         beginSync(accountId, accessToken); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
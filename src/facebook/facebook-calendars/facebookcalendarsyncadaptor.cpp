@@ -255,7 +255,7 @@ void FacebookCalendarSyncAdaptor::requestEvents(int accountId,
 
         if (batchRequest.isEmpty()) {
             // we're requesting data.  Increment the semaphore so that we know we're still busy.
-            incrementSemaphore(accountId);
+            incrementSemaphore(accountId, QStringLiteral("events"));
         }
         setupReplyTimeout(accountId, reply);
     } else {
@@ -277,9 +277,7 @@ void FacebookCalendarSyncAdaptor::finishedHandler()
     removeReplyTimeout(accountId, reply);
 
     qCDebug(lcSocialPluginTrace) << "request finished, got response:";
-    Q_FOREACH (const QString &line, QString::fromUtf8(replyData).split('\n', QString::SkipEmptyParts)) {
-        qCDebug(lcSocialPluginTrace) << line;
-    }
+    SOCIALD_TRACE_DUMP(replyData);
 
     QStringList ongoingRequests;
     QJsonArray array;
@@ -380,13 +378,13 @@ void FacebookCalendarSyncAdaptor::finishedHandler()
         } else {
             qCDebug(lcSocialPlugin) << "finished all requests, about to perform database update";
             processParsedEvents(accountId);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("events"));
         }
     } else {
         // Error occurred during request.
         qCWarning(lcSocialPlugin) << "unable to parse calendar data from request with account"
                           << accountId << ", got:" << QString::fromLatin1(replyData.constData());
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("events"));
     }
 }
 
@@ -20,6 +20,8 @@
  ****************************************************************************/
 
 #include "facebookimagesyncadaptor.h"
+#include "jsonstreamreader_p.h"
+#include "socialdnetworkaccessmanager_p.h"
 #include "trace.h"
 
 #include <QtCore/QPair>
@@ -28,6 +30,8 @@
 #include <QtCore/QVariantMap>
 #include <QtCore/QByteArray>
 #include <QtCore/QUrlQuery>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
@@ -37,6 +41,25 @@
 
 #include <MDConfItem>
 
+namespace {
+    // the photo listing of an album is resumed from the page at which
+    // it was interrupted, see SocialNetworkSyncAdaptor::saveCheckpoint().
+    QString photosCheckpoint(const QString &fbAlbumId)
+    {
+        return QStringLiteral("photos-") + fbAlbumId;
+    }
+
+    QString withAccessToken(const QString &url, const QString &accessToken)
+    {
+        QUrl retn(url);
+        QUrlQuery query(retn);
+        query.removeAllQueryItems(QStringLiteral("access_token"));
+        query.addQueryItem(QStringLiteral("access_token"), accessToken);
+        retn.setQuery(query);
+        return retn.toString();
+    }
+}
+
 // Update the following version if database schema changes e.g. new
 // fields are added to the existing tables.
 // It will make old tables dropped and creates new ones.
@@ -88,6 +111,7 @@ void FacebookImageSyncAdaptor::purgeDataForOldAccount(int oldId, SocialNetworkSy
     m_db.purgeAccount(oldId);
     m_db.commit();
     m_db.wait();
+    clearValidators(oldId);
 }
 
 void FacebookImageSyncAdaptor::beginSync(int accountId, const QString &accessToken)
@@ -101,10 +125,17 @@ void FacebookImageSyncAdaptor::beginSync(int accountId, const QString &accessTok
 
 void FacebookImageSyncAdaptor::finalize(int accountId)
 {
-    Q_UNUSED(accountId)
-
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, won't commit database changes";
+        discardValidators(accountId);
+    } else if (m_failedPageAccounts.remove(accountId)) {
+        // keep the photos of the pages which were read, but the listing
+        // must be fetched in full again, and nothing can be known removed.
+        qCInfo(lcSocialPlugin) << "some pages of Facebook account with id" << accountId
+                               << "couldn't be read, won't remove albums or photos";
+        m_db.commit();
+        m_db.wait();
+        discardValidators(accountId);
     } else {
         // Remove albums
         m_db.removeAlbums(m_cachedAlbums.keys());
@@ -114,6 +145,9 @@ void FacebookImageSyncAdaptor::finalize(int accountId)
 
         m_db.commit();
         m_db.wait();
+
+        // the album listing has been saved, so it can be validated in the next sync.
+        commitValidators(accountId);
     }
 }
 
@@ -125,7 +159,8 @@ void FacebookImageSyncAdaptor::requestData(int accountId,
 {
     if (syncAborted()) {
         qCDebug(lcSocialPlugin) << "skipping data request due to sync abort";
-        clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
+        saveAlbumCheckpoint(accountId, fbAlbumId, continuationUrl);
+        pageFailed(accountId);
         return;
     }
 
@@ -161,7 +196,17 @@ void FacebookImageSyncAdaptor::requestData(int accountId,
         url.setQuery(query);
     }
 
-    QNetworkReply *reply = m_networkAccessManager->get(QNetworkRequest(url));
+    QNetworkRequest request(url);
+    if (fbAlbumId.isEmpty() && continuationUrl.isEmpty()) {
+        // the album listing rarely changes, so let the server tell us if it hasn't.
+        // If we have no albums cached, we need the full listing regardless.
+        if (m_cachedAlbums.isEmpty()) {
+            clearValidators(accountId);
+        }
+        request.setAttribute(SocialdNetworkAccessManager::ValidatorScopeAttribute, validatorScope(accountId));
+    }
+
+    QNetworkReply *reply = m_networkAccessManager->get(request);
     if (reply) {
         reply->setProperty("accountId", accountId);
         reply->setProperty("accessToken", accessToken);
@@ -173,15 +218,19 @@ void FacebookImageSyncAdaptor::requestData(int accountId,
         if (fbAlbumId.isEmpty()) {
             connect(reply, SIGNAL(finished()), this, SLOT(albumsFinishedHandler()));
         } else {
+            // photo pages can contain up to 2000 photos, so handle them as they arrive.
+            JsonStreamReader *reader = JsonStreamReader::attach(reply, QStringList() << QStringLiteral("data"), false);
+            connect(reader, &JsonStreamReader::itemsAvailable, this, &FacebookImageSyncAdaptor::imagesAvailableHandler);
             connect(reply, SIGNAL(finished()), this, SLOT(imagesFinishedHandler()));
         }
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, fbAlbumId.isEmpty() ? QStringLiteral("albums") : QStringLiteral("images"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from Facebook account with id" << accountId;
-        clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
+        saveAlbumCheckpoint(accountId, fbAlbumId, continuationUrl);
+        pageFailed(accountId);
     }
 }
 
@@ -189,6 +238,7 @@ void FacebookImageSyncAdaptor::albumsFinishedHandler()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     bool isError = reply->property("isError").toBool();
+    bool notModified = reply->property("notModified").toBool();
     int accountId = reply->property("accountId").toInt();
     QString accessToken = reply->property("accessToken").toString();
     QString fbUserId = reply->property("fbUserId").toString();
@@ -199,19 +249,26 @@ void FacebookImageSyncAdaptor::albumsFinishedHandler()
     reply->deleteLater();
     removeReplyTimeout(accountId, reply);
 
+    if (!isError && notModified) {
+        qCDebug(lcSocialPlugin) << "albums of Facebook account with id" << accountId << "have not changed";
+        clearRemovalDetectionLists(); // nothing has been removed either.
+        decrementSemaphore(accountId, QStringLiteral("albums"));
+        return;
+    }
+
     bool ok = false;
     QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
     if (isError || !ok || !parsed.contains(QLatin1String("data"))) {
         qCWarning(lcSocialPlugin) << "unable to read albums response for Facebook account with id" << accountId;
-        clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
-        decrementSemaphore(accountId);
+        pageFailed(accountId);
+        decrementSemaphore(accountId, QStringLiteral("albums"));
         return;
     }
 
     QJsonArray data = parsed.value(QLatin1String("data")).toArray();
     if (data.size() == 0) {
         qCDebug(lcSocialPlugin) << "Facebook account with id" << accountId << "has no albums";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("albums"));
         return;
     }
 
@@ -247,10 +304,13 @@ void FacebookImageSyncAdaptor::albumsFinishedHandler()
         QDateTime createdTime = QDateTime::fromString(createdTimeStr, Qt::ISODate);
         QDateTime updatedTime = QDateTime::fromString(updatedTimeStr, Qt::ISODate);
 
+        // An album whose photos were interrupted in an earlier sync is synced
+        // regardless, as the album itself has already been saved then.
+        const QJsonObject checkpoint = takeCheckpoint(accountId, photosCheckpoint(fbAlbumId));
         const FacebookAlbum::ConstPtr &dbAlbum = m_cachedAlbums.value(fbAlbumId);
         m_cachedAlbums.remove(fbAlbumId);  // Removal detection
-        if (!dbAlbum.isNull() && (dbAlbum->updatedTime() >= updatedTime
-                                  && dbAlbum->imageCount() == imageCount)) {
+        if (checkpoint.isEmpty() && !dbAlbum.isNull() && (dbAlbum->updatedTime() >= updatedTime
+                                                          && dbAlbum->imageCount() == imageCount)) {
             qCDebug(lcSocialPlugin) << "album with id" << albumId << "by user" << userId
                                     << "from Facebook account with id" << accountId << "doesn't need sync";
             continue;
@@ -262,9 +322,26 @@ void FacebookImageSyncAdaptor::albumsFinishedHandler()
 
         // We then save the album
         m_db.addAlbum(albumId, userId, createdTime, updatedTime, albumName, imageCount);
+        m_albumUpdatedTimes.insert(fbAlbumId, updatedTimeStr);
+
+        // if the album hasn't changed since, continue from the interrupted page.
+        QString resumeUrl;
+        if (checkpoint.value(QLatin1String("updatedTime")).toString() == updatedTimeStr) {
+            resumeUrl = checkpoint.value(QLatin1String("next")).toString();
+        }
+        if (!resumeUrl.isEmpty()) {
+            QSet<QString> &serverImageIds(m_serverImageIds[fbAlbumId]);
+            Q_FOREACH (const QJsonValue &imageId, checkpoint.value(QLatin1String("imageIds")).toArray()) {
+                serverImageIds.insert(imageId.toString());
+            }
+            qCInfo(lcSocialPlugin) << "resuming photos of album" << fbAlbumId << "for Facebook account with id"
+                                   << accountId << "after" << serverImageIds.size() << "photos";
+            resumeUrl = withAccessToken(resumeUrl, accessToken);
+        }
+
         // TODO: After successfully added an album, we should begin a new query to get the image
         // information (based on cover image id).
-        requestData(accountId, accessToken, QString(), fbUserId, fbAlbumId);
+        requestData(accountId, accessToken, resumeUrl, fbUserId, fbAlbumId);
     }
 
     // Perform a continuation request if required.
@@ -278,7 +355,20 @@ void FacebookImageSyncAdaptor::albumsFinishedHandler()
     }
 
     // Finally, reduce our semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("albums"));
+}
+
+void FacebookImageSyncAdaptor::imagesAvailableHandler()
+{
+    JsonStreamReader *reader = qobject_cast<JsonStreamReader*>(sender());
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(reader->parent());
+    if (reply->property("isError").toBool()) {
+        // the finished() handler will deal with the error.
+        return;
+    }
+
+    // the page may still fail, so the photos are saved by the finished() handler.
+    readPhotos(reader, &m_streamedPhotos[reply]);
 }
 
 void FacebookImageSyncAdaptor::imagesFinishedHandler()
@@ -290,116 +380,139 @@ void FacebookImageSyncAdaptor::imagesFinishedHandler()
     QString fbUserId = reply->property("fbUserId").toString();
     QString fbAlbumId = reply->property("fbAlbumId").toString();
     QString continuationUrl = reply->property("continuationUrl").toString();
-    QByteArray replyData = reply->readAll();
+    JsonStreamReader *reader = JsonStreamReader::fromReply(reply);
+    reader->addData(reply->readAll());
+    bool ok = reader->finish();
+    QList<Photo> photos = m_streamedPhotos.take(reply);
     disconnect(reply);
     reply->deleteLater();
     removeReplyTimeout(accountId, reply);
 
-    bool ok = false;
-    QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
+    QJsonObject parsed = reader->envelope().object();
     if (isError || !ok || !parsed.contains(QLatin1String("data"))) {
         qCWarning(lcSocialPlugin) << "unable to read photos response for Facebook account with id" << accountId;
-        qCDebug(lcSocialPlugin) << replyData;
-        clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
-        decrementSemaphore(accountId);
+        saveAlbumCheckpoint(accountId, fbAlbumId, continuationUrl);
+        pageFailed(accountId);
+        decrementSemaphore(accountId, QStringLiteral("images"));
         return;
     }
 
-    QJsonArray data = parsed.value(QLatin1String("data")).toArray();
-    if (data.size() == 0) {
+    // read the photos which haven't been handled yet, and save the page.
+    readPhotos(reader, &photos);
+    savePhotos(photos, fbAlbumId, fbUserId);
+    if (reader->itemCount() == 0) {
         qCDebug(lcSocialPlugin) << "album with id" << fbAlbumId << "from Facebook account with id" << accountId << "has no photos";
-        checkRemovedImages(fbAlbumId);
-        decrementSemaphore(accountId);
+        checkRemovedImages(accountId, fbAlbumId);
+        decrementSemaphore(accountId, QStringLiteral("images"));
         return;
     }
 
-    // read the photos information
-    foreach (const QJsonValue &photoValue, data) {
-        QJsonObject imageObject = photoValue.toObject();
-        if (imageObject.isEmpty()) {
-            continue;
-        }
+    // perform a continuation request if required.
+    QJsonObject paging = parsed.value(QLatin1String("paging")).toObject();
+    QString nextUrl = paging.value(QLatin1String("next")).toString();
+    if (!nextUrl.isEmpty() && nextUrl != continuationUrl) {
+        qCDebug(lcSocialPlugin) << "performing continuation request for more photos for Facebook account with id" << accountId << ":" << nextUrl;
+        requestData(accountId, accessToken, nextUrl, fbUserId, fbAlbumId);
+    } else {
+        // this was the laste page, check removed images
+        checkRemovedImages(accountId, fbAlbumId);
+    }
 
-        QString photoId = imageObject.value(QLatin1String("id")).toString();
-        QString thumbnailUrl = imageObject.value(QLatin1String("picture")).toString();
-        QString imageSrcUrl = imageObject.value(QLatin1String("source")).toString();
-        QString createdTimeStr = imageObject.value(QLatin1String("created_time")).toString();
-        QString updatedTimeStr = imageObject.value(QLatin1String("updated_time")).toString();
-        QString photoName = imageObject.value(QLatin1String("name")).toString();
-        int imageWidth = 0;
-        int imageHeight = 0;
-        if (photoId.isEmpty()) {
-            qCWarning(lcSocialPlugin) << "Unable to parse photo id from data:" << photoValue.toObject().toVariantMap();
-            continue;
-        }
+    // we're finished this request.  Decrement our busy semaphore.
+    decrementSemaphore(accountId, QStringLiteral("images"));
+}
 
-        // Find optimal thumbnail and image source urls based on dimensions.
-        QList<ImageSource> imageSources;
-        QJsonArray images = imageObject.value(QLatin1String("images")).toArray();
-        foreach (const QJsonValue &imageValue, images) {
-            QJsonObject image = imageValue.toObject();
-            imageSources << ImageSource(static_cast<int>(image.value(QLatin1String("width")).toDouble()),
-                                        static_cast<int>(image.value(QLatin1String("height")).toDouble()),
-                                        image.value(QLatin1String("source")).toString());
+void FacebookImageSyncAdaptor::readPhotos(JsonStreamReader *reader, QList<Photo> *photos)
+{
+    while (reader->readNext()) {
+        QJsonObject imageObject = reader->item().toObject();
+        if (!imageObject.isEmpty()) {
+            readPhoto(imageObject, photos);
         }
+    }
+}
 
-        bool foundOptimalThumbnail = false, foundOptimalImage = false;
-        std::sort(imageSources.begin(), imageSources.end());
-        Q_FOREACH (const ImageSource &img, imageSources) {
-            if (!foundOptimalThumbnail && qMin(img.width, img.height) >= m_optimalThumbnailWidth) {
-                foundOptimalThumbnail = true;
-                thumbnailUrl = img.sourceUrl;
-            }
-            if (!foundOptimalImage && qMin(img.width, img.height) >= m_optimalImageWidth) {
-                foundOptimalImage = true;
-                imageWidth = img.width;
-                imageHeight = img.height;
-                imageSrcUrl = img.sourceUrl;
-            }
-        }
-        if (!foundOptimalThumbnail && imageSources.size()) {
-            // just choose the largest one.
-            thumbnailUrl = imageSources.last().sourceUrl;
+void FacebookImageSyncAdaptor::readPhoto(const QJsonObject &imageObject, QList<Photo> *photos)
+{
+    QString photoId = imageObject.value(QLatin1String("id")).toString();
+    QString thumbnailUrl = imageObject.value(QLatin1String("picture")).toString();
+    QString imageSrcUrl = imageObject.value(QLatin1String("source")).toString();
+    QString createdTimeStr = imageObject.value(QLatin1String("created_time")).toString();
+    QString updatedTimeStr = imageObject.value(QLatin1String("updated_time")).toString();
+    QString photoName = imageObject.value(QLatin1String("name")).toString();
+    int imageWidth = 0;
+    int imageHeight = 0;
+    if (photoId.isEmpty()) {
+        qCWarning(lcSocialPlugin) << "Unable to parse photo id from data:" << imageObject.toVariantMap();
+        return;
+    }
+
+    // Find optimal thumbnail and image source urls based on dimensions.
+    QList<ImageSource> imageSources;
+    QJsonArray images = imageObject.value(QLatin1String("images")).toArray();
+    foreach (const QJsonValue &imageValue, images) {
+        QJsonObject image = imageValue.toObject();
+        imageSources << ImageSource(static_cast<int>(image.value(QLatin1String("width")).toDouble()),
+                                    static_cast<int>(image.value(QLatin1String("height")).toDouble()),
+                                    image.value(QLatin1String("source")).toString());
+    }
+
+    bool foundOptimalThumbnail = false, foundOptimalImage = false;
+    std::sort(imageSources.begin(), imageSources.end());
+    Q_FOREACH (const ImageSource &img, imageSources) {
+        if (!foundOptimalThumbnail && qMin(img.width, img.height) >= m_optimalThumbnailWidth) {
+            foundOptimalThumbnail = true;
+            thumbnailUrl = img.sourceUrl;
         }
-        if (!foundOptimalImage && imageSources.size()) {
-            // just choose the largest one.
-            imageSrcUrl = imageSources.last().sourceUrl;
-            imageWidth = imageSources.last().width;
-            imageHeight = imageSources.last().height;
+        if (!foundOptimalImage && qMin(img.width, img.height) >= m_optimalImageWidth) {
+            foundOptimalImage = true;
+            imageWidth = img.width;
+            imageHeight = img.height;
+            imageSrcUrl = img.sourceUrl;
         }
+    }
+    if (!foundOptimalThumbnail && imageSources.size()) {
+        // just choose the largest one.
+        thumbnailUrl = imageSources.last().sourceUrl;
+    }
+    if (!foundOptimalImage && imageSources.size()) {
+        // just choose the largest one.
+        imageSrcUrl = imageSources.last().sourceUrl;
+        imageWidth = imageSources.last().width;
+        imageHeight = imageSources.last().height;
+    }
 
-        QDateTime createdTime = QDateTime::fromString(createdTimeStr, Qt::ISODate);
-        QDateTime updatedTime = QDateTime::fromString(updatedTimeStr, Qt::ISODate);
-        if (!m_serverImageIds[fbAlbumId].contains(photoId)) {
-            m_serverImageIds[fbAlbumId].insert(photoId);
-        }
+    Photo photo;
+    photo.id = photoId;
+    photo.createdTime = QDateTime::fromString(createdTimeStr, Qt::ISODate);
+    photo.updatedTime = QDateTime::fromString(updatedTimeStr, Qt::ISODate);
+    photo.name = photoName;
+    photo.width = imageWidth;
+    photo.height = imageHeight;
+    photo.thumbnailUrl = thumbnailUrl;
+    photo.imageUrl = imageSrcUrl;
+    photos->append(photo);
+}
+
+void FacebookImageSyncAdaptor::savePhotos(const QList<Photo> &photos, const QString &fbAlbumId, const QString &fbUserId)
+{
+    QSet<QString> &serverImageIds(m_serverImageIds[fbAlbumId]);
+    Q_FOREACH (const Photo &photo, photos) {
+        serverImageIds.insert(photo.id);
 
         // check if we need to sync, and write to the database.
-        if (!imageSrcUrl.isEmpty()) {
-            if (haveAlreadyCachedImage(photoId, imageSrcUrl)) {
-                qCDebug(lcSocialPlugin) << "have previously cached photo" << photoId << ":" << imageSrcUrl;
+        if (!photo.imageUrl.isEmpty()) {
+            if (haveAlreadyCachedImage(photo.id, photo.imageUrl)) {
+                qCDebug(lcSocialPlugin) << "have previously cached photo" << photo.id << ":" << photo.imageUrl;
             } else {
-                qCDebug(lcSocialPlugin) << "caching new photo" << photoId << ":" << imageSrcUrl << "->" << imageWidth << "x" << imageHeight;
-                m_db.addImage(photoId, fbAlbumId, fbUserId, createdTime, updatedTime,
-                              photoName, imageWidth, imageHeight, thumbnailUrl, imageSrcUrl);
+                qCDebug(lcSocialPlugin) << "caching new photo" << photo.id << ":" << photo.imageUrl << "->" << photo.width << "x" << photo.height;
+                m_db.addImage(photo.id, fbAlbumId, fbUserId, photo.createdTime, photo.updatedTime,
+                              photo.name, photo.width, photo.height, photo.thumbnailUrl, photo.imageUrl);
             }
         } else {
-            qCWarning(lcSocialPlugin) << "Cannot add photo to database:" << photoId << "- empty image source url!";
+            qCWarning(lcSocialPlugin) << "Cannot add photo to database:" << photo.id << "- empty image source url!";
         }
     }
-    // perform a continuation request if required.
-    QJsonObject paging = parsed.value(QLatin1String("paging")).toObject();
-    QString nextUrl = paging.value(QLatin1String("next")).toString();
-    if (!nextUrl.isEmpty() && nextUrl != continuationUrl) {
-        qCDebug(lcSocialPlugin) << "performing continuation request for more photos for Facebook account with id" << accountId << ":" << nextUrl;
-        requestData(accountId, accessToken, nextUrl, fbUserId, fbAlbumId);
-    } else {
-        // this was the laste page, check removed images
-        checkRemovedImages(fbAlbumId);
-    }
-
-    // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
 }
 
 bool FacebookImageSyncAdaptor::haveAlreadyCachedImage(const QString &fbImageId, const QString &imageUrl)
@@ -451,7 +564,7 @@ void FacebookImageSyncAdaptor::possiblyAddNewUser(const QString &fbUserId, int a
                 this, SLOT(sslErrorsHandler(QList<QSslError>)));
         connect(reply, SIGNAL(finished()), this, SLOT(userFinishedHandler()));
 
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("user"));
         setupReplyTimeout(accountId, reply);
     }
 }
@@ -463,11 +576,13 @@ void FacebookImageSyncAdaptor::userFinishedHandler()
     int accountId = reply->property("accountId").toInt();
     disconnect(reply);
     reply->deleteLater();
+    removeReplyTimeout(accountId, reply);
 
     bool ok = false;
     QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
     if (!ok || !parsed.contains(QLatin1String("id"))) {
         qCWarning(lcSocialPlugin) << "unable to read user response for Facebook account with id" << accountId;
+        decrementSemaphore(accountId, QStringLiteral("user"));
         return;
     }
 
@@ -476,7 +591,7 @@ void FacebookImageSyncAdaptor::userFinishedHandler()
     QString updatedStr = parsed.value(QLatin1String("updated_time")).toString();
 
     m_db.addUser(fbUserId, QDateTime::fromString(updatedStr, Qt::ISODate), fbName);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("user"));
 }
 
 bool FacebookImageSyncAdaptor::initRemovalDetectionLists(int accountId)
@@ -486,6 +601,7 @@ bool FacebookImageSyncAdaptor::initRemovalDetectionLists(int accountId)
     // We have to do it this way, as results can be spread across multiple requests
     // if Facebook returns results in paginated form.
     clearRemovalDetectionLists();
+    m_failedPageAccounts.remove(accountId);
 
     bool ok = false;
     QMap<int,QString> accounts = m_db.accounts(&ok);
@@ -512,10 +628,51 @@ void FacebookImageSyncAdaptor::clearRemovalDetectionLists()
     m_cachedAlbums.clear();
     m_serverImageIds.clear();
     m_removedImages.clear();
+    m_albumUpdatedTimes.clear();
+}
+
+void FacebookImageSyncAdaptor::pageFailed(int accountId)
+{
+    // don't perform server-side removal detection during this sync run,
+    // and don't commit the validators of the album listing.  The photo ids
+    // read so far are kept, for the checkpoints of the albums.
+    m_failedPageAccounts.insert(accountId);
+    m_removedImages.clear();
 }
 
-void FacebookImageSyncAdaptor::checkRemovedImages(const QString &fbAlbumId)
+// Saves the page at which the photo listing of the album was interrupted,
+// with the ids of the photos of the previous pages, for the next sync.
+// Continuation urls carry the access token, which is not stored.
+void FacebookImageSyncAdaptor::saveAlbumCheckpoint(int accountId, const QString &fbAlbumId,
+                                                   const QString &pageUrl)
 {
+    if (fbAlbumId.isEmpty()) {
+        return;
+    }
+
+    QJsonArray imageIds;
+    if (!pageUrl.isEmpty()) {
+        Q_FOREACH (const QString &imageId, m_serverImageIds.value(fbAlbumId)) {
+            imageIds.append(imageId);
+        }
+    }
+
+    QJsonObject checkpoint;
+    checkpoint.insert(QLatin1String("updatedTime"), m_albumUpdatedTimes.value(fbAlbumId));
+    checkpoint.insert(QLatin1String("next"), pageUrl.isEmpty()
+                      ? QString()
+                      : SocialdNetworkAccessManager::withoutCredentials(QUrl(pageUrl)).toString());
+    checkpoint.insert(QLatin1String("imageIds"), imageIds);
+    saveCheckpoint(accountId, photosCheckpoint(fbAlbumId), checkpoint);
+}
+
+void FacebookImageSyncAdaptor::checkRemovedImages(int accountId, const QString &fbAlbumId)
+{
+    if (m_failedPageAccounts.contains(accountId)) {
+        // the pages of other albums can't tell what has been removed either.
+        return;
+    }
+
     const QSet<QString> &serverImageIds = m_serverImageIds.value(fbAlbumId);
     QSet<QString> cachedImageIds = m_db.imageIds(fbAlbumId).toSet();
 
@@ -29,6 +29,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QVariantMap>
 #include <QtCore/QList>
+#include <QtCore/QHash>
 #include <QtSql/QSqlDatabase>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
@@ -36,6 +37,8 @@
 
 #include <socialcache/facebookimagesdatabase.h>
 
+class JsonStreamReader;
+
 class FacebookImageSyncAdaptor
         : public FacebookDataTypeSyncAdaptor
 {
@@ -58,10 +61,15 @@ private:
                      const QString &fbUserId, const QString &fbAlbumId);
     bool haveAlreadyCachedImage(const QString &fbImageId, const QString &imageUrl);
     void possiblyAddNewUser(const QString &fbUserId, int accountId, const QString &accessToken);
+    class Photo;
+    void readPhotos(JsonStreamReader *reader, QList<Photo> *photos);
+    void readPhoto(const QJsonObject &imageObject, QList<Photo> *photos);
+    void savePhotos(const QList<Photo> &photos, const QString &fbAlbumId, const QString &fbUserId);
 
 
 private Q_SLOTS:
     void albumsFinishedHandler();
+    void imagesAvailableHandler();
     void imagesFinishedHandler();
     void userFinishedHandler();
 
@@ -69,13 +77,31 @@ private:
     // for server-side removal detection.
     bool initRemovalDetectionLists(int accountId);
     void clearRemovalDetectionLists();
-    void checkRemovedImages(const QString &fbAlbumId);
+    void checkRemovedImages(int accountId, const QString &fbAlbumId);
+    void pageFailed(int accountId);
+    void saveAlbumCheckpoint(int accountId, const QString &fbAlbumId, const QString &pageUrl);
     QMap<QString, FacebookAlbum::ConstPtr> m_cachedAlbums;
     QMap<QString, QSet<QString> > m_serverImageIds;
     QStringList m_removedImages;
+    QSet<int> m_failedPageAccounts; // accounts with album or photo pages which couldn't be read
+    QHash<QString, QString> m_albumUpdatedTimes; // of the albums being synced, for checkpoints
 
     FacebookImagesDatabase m_db;
 
+    // the photos of a page are only saved once the whole page has been read.
+    class Photo {
+    public:
+        QString id;
+        QDateTime createdTime;
+        QDateTime updatedTime;
+        QString name;
+        int width;
+        int height;
+        QString thumbnailUrl;
+        QString imageUrl;
+    };
+    QHash<QNetworkReply*, QList<Photo> > m_streamedPhotos;
+
     // image variants with different dimentions
     class ImageSource {
     public:
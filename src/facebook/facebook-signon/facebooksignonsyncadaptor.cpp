@@ -95,7 +95,7 @@ void FacebookSignonSyncAdaptor::beginSync(int accountId, const QString &accessTo
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
         setupReplyTimeout(accountId, reply);
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("token"));
     } else {
         qCWarning(lcSocialPlugin) << "unable to verify access token via network request for Facebook account:" << accountId;
     }
@@ -114,7 +114,7 @@ void FacebookSignonSyncAdaptor::requestFinishedHandler()
 
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, skipping signon sync reply handling";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("token"));
         return;
     }
 
@@ -164,7 +164,7 @@ void FacebookSignonSyncAdaptor::requestFinishedHandler()
         qCWarning(lcSocialPlugin) << "unable to parse response information for verification request for Facebook account:" << accountId;
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("token"));
 }
 
 Accounts::Account *FacebookSignonSyncAdaptor::loadAccount(int accountId)
@@ -267,7 +267,7 @@ void FacebookSignonSyncAdaptor::forceTokenExpiry(int seconds, int accountId, con
                 this, &FacebookSignonSyncAdaptor::forceTokenExpiryError,
                 Qt::UniqueConnection);
 
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("forceTokenExpiry"));
         session->setProperty("accountId", accountId);
         session->setProperty("seconds", seconds);
         session->process(SignOn::SessionData(signonSessionData), mechanism);
@@ -296,7 +296,7 @@ void FacebookSignonSyncAdaptor::forceTokenExpiryResponse(const SignOn::SessionDa
         // successfully forced new ExpiresIn value
         lowerCredentialsNeedUpdateFlag(accountId);
     }
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("forceTokenExpiry"));
 }
 
 void FacebookSignonSyncAdaptor::forceTokenExpiryError(const SignOn::Error &error)
@@ -316,6 +316,6 @@ void FacebookSignonSyncAdaptor::forceTokenExpiryError(const SignOn::Error &error
         // don't raise or lower the flag.  If was previously not raised,
         // presumably it's because ExpiresIn hadn't reached zero.
     }
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("forceTokenExpiry"));
 }
 
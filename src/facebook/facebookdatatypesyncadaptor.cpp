@@ -20,16 +20,16 @@
  ****************************************************************************/
 
 #include "facebookdatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "trace.h"
 
+#include <QtCore/QTimer>
 #include <QtCore/QVariantMap>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
-
-//libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
+#include <QtCore/QUrl>
 
 // libaccounts-qt5
 #include <Accounts/Manager>
@@ -43,7 +43,7 @@
 #include <SignOn/SessionData>
 
 FacebookDataTypeSyncAdaptor::FacebookDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
-    : SocialNetworkSyncAdaptor("facebook", dataType, 0, parent), m_triedLoading(false)
+    : SocialNetworkSyncAdaptor("facebook", dataType, 0, parent)
 {
 }
 
@@ -81,7 +81,7 @@ void FacebookDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
@@ -101,6 +101,10 @@ void FacebookDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
     QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
     if (ok && parsed.contains(QLatin1String("error"))) {
         QJsonObject errorReply = parsed.value("error").toObject();
+        // the access token is invalid, e.g. expired or revoked.
+        if (errorReply.value("code").toDouble() == 190) {
+            invalidateAccessTokens(accountId);
+        }
         // Password Changed on server side
         if (errorReply.value("code").toDouble() == 190 &&
                 errorReply.value("error_subcode").toDouble() == 460) {
@@ -132,10 +136,7 @@ void FacebookDataTypeSyncAdaptor::sslErrorsHandler(const QList<QSslError> &errs)
 
 QString FacebookDataTypeSyncAdaptor::clientId()
 {
-    if (!m_triedLoading) {
-        loadClientId();
-    }
-    return m_clientId;
+    return KeyProviderCache::storedKey("facebook", "facebook-sync", "client_id");
 }
 
 QString FacebookDataTypeSyncAdaptor::graphAPI(const QString &request) const
@@ -143,18 +144,12 @@ QString FacebookDataTypeSyncAdaptor::graphAPI(const QString &request) const
     return m_graphAPI + request;
 }
 
-void FacebookDataTypeSyncAdaptor::loadClientId()
+void FacebookDataTypeSyncAdaptor::setGraphAPI(const QString &graphAPI)
 {
-    m_triedLoading = true;
-    char *cClientId = NULL;
-    int cSuccess = SailfishKeyProvider_storedKey("facebook", "facebook-sync", "client_id", &cClientId);
-    if (cSuccess != 0 || cClientId == NULL) {
-        return;
-    }
-
-    m_clientId = QLatin1String(cClientId);
-    free(cClientId);
-    return;
+    m_graphAPI = graphAPI;
+    // the Graph API throttles apps which send bursts of calls for a single user.
+    setRequestRateLimit(QUrl(m_graphAPI).host(), 4, 8);
+    setRequestRetryLimit(QUrl(m_graphAPI).host(), 3);
 }
 
 void FacebookDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
@@ -173,35 +168,45 @@ void FacebookDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     // Fetch consumer key and secret from keyprovider
     int accountId = account->id();
     if (!checkAccount(account) || clientId().isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    // grab out a valid identity for the sync service.
     Accounts::Service srv(m_accountManager->service(syncServiceName()));
     account->selectService(srv);
+    Accounts::AccountService accSrv(account, srv);
+    QString method = accSrv.authData().method();
+    QString mechanism = accSrv.authData().mechanism();
+    QVariantMap signonSessionData = accSrv.authData().parameters();
+    signonSessionData.insert("ClientId", clientId());
+    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
+
+    // another data type of the account may have signed in recently.
+    const QString tokenScope = accessTokenScope(mechanism, signonSessionData);
+    const QString cachedToken = cachedAccessToken(accountId, tokenScope);
+    if (!cachedToken.isEmpty()) {
+        QTimer::singleShot(0, account, [this, account, cachedToken] {
+            signedIn(account, cachedToken);
+        });
+        return;
+    }
+
+    // grab out a valid identity for the sync service.
     SignOn::Identity *identity = account->credentialsId() > 0 ? SignOn::Identity::existingIdentity(account->credentialsId()) : 0;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "account" << accountId << "has no valid credentials, cannot sign in";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    Accounts::AccountService accSrv(account, srv);
-    QString method = accSrv.authData().method();
-    QString mechanism = accSrv.authData().mechanism();
     SignOn::AuthSession *session = identity->createSession(method);
     if (!session) {
         qCWarning(lcSocialPlugin) << "could not create signon session for account" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    QVariantMap signonSessionData = accSrv.authData().parameters();
-    signonSessionData.insert("ClientId", clientId());
-    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
-
     connect(session, &SignOn::AuthSession::response,
             this, &FacebookDataTypeSyncAdaptor::signOnResponse,
             Qt::UniqueConnection);
@@ -210,6 +215,7 @@ void FacebookDataTypeSyncAdaptor::signIn(Accounts::Account *account)
             Qt::UniqueConnection);
 
     session->setProperty("account", QVariant::fromValue<Accounts::Account*>(account));
+    session->setProperty("tokenScope", tokenScope);
     session->setProperty("identity", QVariant::fromValue<SignOn::Identity*>(identity));
     session->process(SignOn::SessionData(signonSessionData), mechanism);
 }
@@ -236,7 +242,7 @@ void FacebookDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void FacebookDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -257,16 +263,26 @@ void FacebookDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &resp
         qCInfo(lcSocialPlugin) << "signon response for account with id" << accountId << "contained no access token";
     }
 
-    m_graphAPI = account->value(QStringLiteral("graph_api/Host")).toString();
+    cacheAccessToken(accountId, session->property("tokenScope").toString(), data);
 
     session->disconnect(this);
     identity->destroySession(session);
     identity->deleteLater();
+
+    signedIn(account, accessToken);
+}
+
+void FacebookDataTypeSyncAdaptor::signedIn(Accounts::Account *account, const QString &accessToken)
+{
+    int accountId = account->id();
+
+    setGraphAPI(account->value(QStringLiteral("graph_api/Host")).toString());
+
     account->deleteLater();
 
     if (!accessToken.isEmpty()) {
         beginSync(accountId, accessToken); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
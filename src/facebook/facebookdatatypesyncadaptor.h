@@ -56,6 +56,7 @@ public:
 protected:
     QString clientId();
     QString graphAPI(const QString &request = QString()) const;
+    void setGraphAPI(const QString &graphAPI);
     virtual void updateDataForAccount(int accountIds);
     virtual void beginSync(int accountId, const QString &accessToken) = 0;
 
@@ -68,11 +69,9 @@ private Q_SLOTS:
     void signOnResponse(const SignOn::SessionData &responseData);
 
 private:
-    void loadClientId();
     void setCredentialsNeedUpdate(Accounts::Account *account);
     void signIn(Accounts::Account *account);
-    bool m_triedLoading; // Is true if we tried to load (even if we failed)
-    QString m_clientId;
+    void signedIn(Accounts::Account *account, const QString &accessToken);
     QString m_graphAPI;
 };
 
@@ -70,18 +70,11 @@ void errorDumpStr(const QString &str)
     }
 }
 
-void traceDumpStr(const QString &str)
+// the paging progress of the events of a calendar is stored as a checkpoint
+// if their download is interrupted, see SocialNetworkSyncAdaptor::saveCheckpoint().
+QString eventsCheckpoint(const QString &calendarId)
 {
-    if (!lcSocialPluginTrace().isDebugEnabled()) {
-        return;
-    }
-
-    // Dump the entire string to the log.
-    // Note that the log cannot handle newlines,
-    // so we separate the string into chunks.
-    Q_FOREACH (const QString &chunk, str.split('\n', QString::SkipEmptyParts)) {
-        qCDebug(lcSocialPluginTrace) << chunk;
-    }
+    return QStringLiteral("events/") + calendarId;
 }
 
 // returns true if the ghost-event cleanup sync has been performed.
@@ -518,7 +511,7 @@ void extractRecurrence(const QJsonArray &recurrence, KCalendarCore::Event::Ptr e
             KCalendarCore::RecurrenceRule *rrule = new KCalendarCore::RecurrenceRule;
             if (!icalFormat.fromString(rrule, ruleStr.mid(6))) {
                 qCDebug(lcSocialPlugin) << "unable to parse RRULE information:" << ruleStr;
-                traceDumpStr(QString::fromUtf8(QJsonDocument(recurrence).toJson()));
+                SOCIALD_TRACE_DUMP(QJsonDocument(recurrence).toJson());
             } else {
                 // Set the recurrence start to be the event start
                 rrule->setStartDt(event->dtStart());
@@ -528,7 +521,7 @@ void extractRecurrence(const QJsonArray &recurrence, KCalendarCore::Event::Ptr e
             KCalendarCore::RecurrenceRule *exrule = new KCalendarCore::RecurrenceRule;
             if (!icalFormat.fromString(exrule, ruleStr.mid(7))) {
                 qCDebug(lcSocialPlugin) << "unable to parse EXRULE information:" << ruleStr;
-                traceDumpStr(QString::fromUtf8(QJsonDocument(recurrence).toJson()));
+                SOCIALD_TRACE_DUMP(QJsonDocument(recurrence).toJson());
             } else {
                 kcalRecurrence->addExRule(exrule);
             }
@@ -537,7 +530,7 @@ void extractRecurrence(const QJsonArray &recurrence, KCalendarCore::Event::Ptr e
             QList<QDateTime> rdatetimes = datetimesFromExRDateStr(ruleStr, &isDateOnly);
             if (!rdatetimes.size()) {
                 qCDebug(lcSocialPlugin) << "unable to parse RDATE information:" << ruleStr;
-                traceDumpStr(QString::fromUtf8(QJsonDocument(recurrence).toJson()));
+                SOCIALD_TRACE_DUMP(QJsonDocument(recurrence).toJson());
             } else {
                 Q_FOREACH (const QDateTime &dt, rdatetimes) {
                     if (isDateOnly) {
@@ -552,7 +545,7 @@ void extractRecurrence(const QJsonArray &recurrence, KCalendarCore::Event::Ptr e
             QList<QDateTime> exdatetimes = datetimesFromExRDateStr(ruleStr, &isDateOnly);
             if (!exdatetimes.size()) {
                 qCDebug(lcSocialPlugin) << "unable to parse EXDATE information:" << ruleStr;
-                traceDumpStr(QString::fromUtf8(QJsonDocument(recurrence).toJson()));
+                SOCIALD_TRACE_DUMP(QJsonDocument(recurrence).toJson());
             } else {
                 Q_FOREACH (const QDateTime &dt, exdatetimes) {
                     if (isDateOnly) {
@@ -564,7 +557,7 @@ void extractRecurrence(const QJsonArray &recurrence, KCalendarCore::Event::Ptr e
             }
         } else {
           qCDebug(lcSocialPlugin) << "unknown recurrence information:" << ruleStr;
-          traceDumpStr(QString::fromUtf8(QJsonDocument(recurrence).toJson()));
+          SOCIALD_TRACE_DUMP(QJsonDocument(recurrence).toJson());
         }
     }
 }
@@ -1205,7 +1198,7 @@ void GoogleCalendarSyncAdaptor::requestCalendars(const QString &accessToken, boo
     QNetworkReply *reply = m_networkAccessManager->get(request);
 
     // we're requesting data.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(m_accountId);
+    incrementSemaphore(m_accountId, QStringLiteral("calendars"));
 
     if (reply) {
         reply->setProperty("accountId", m_accountId);
@@ -1221,7 +1214,7 @@ void GoogleCalendarSyncAdaptor::requestCalendars(const QString &accessToken, boo
     } else {
         qCWarning(lcSocialPlugin) << "unable to request calendars from Google account with id" << m_accountId;
         m_syncSucceeded = false;
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("calendars"));
     }
 }
 
@@ -1296,7 +1289,7 @@ void GoogleCalendarSyncAdaptor::calendarsFinishedHandler()
     }
 
     // we're finished with this request.
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("calendars"));
 }
 
 void GoogleCalendarSyncAdaptor::updateLocalCalendarNotebooks(const QString &accessToken, bool needCleanSync)
@@ -1452,6 +1445,28 @@ void GoogleCalendarSyncAdaptor::requestEvents(const QString &accessToken, const
     query.setQueryItems(queryItems);
     url.setQuery(query);
 
+    QString requestPageToken = pageToken;
+    if (pageToken.isEmpty()) {
+        // if an earlier sync was interrupted after receiving the first pages of
+        // this same request, continue from where it stopped.
+        const QJsonObject checkpoint = takeCheckpoint(m_accountId, eventsCheckpoint(calendarId));
+        if (!checkpoint.isEmpty()
+                && checkpoint.value(QStringLiteral("syncToken")).toString() == (needCleanSync ? QString() : syncToken)) {
+            url = QUrl(checkpoint.value(QStringLiteral("url")).toString());
+            requestPageToken = QUrlQuery(url).queryItemValue(QStringLiteral("pageToken"));
+            syncDate = QDateTime::fromString(checkpoint.value(QStringLiteral("since")).toString(), Qt::ISODate);
+            if (checkpoint.contains(QStringLiteral("defaultReminder"))) {
+                m_serverCalendarIdToDefaultReminderTimes[calendarId] = checkpoint.value(QStringLiteral("defaultReminder")).toInt();
+            }
+            const QJsonArray events = checkpoint.value(QStringLiteral("events")).toArray();
+            for (int i = events.size() - 1; i >= 0; --i) {
+                m_calendarIdToEventObjects.insertMulti(calendarId, events.at(i).toObject());
+            }
+            qCInfo(lcSocialPlugin) << "resuming download of events for calendar" << calendarId
+                                   << "from Google account" << m_accountId << "after" << events.size() << "events";
+        }
+    }
+
     QNetworkRequest request(url);
     request.setRawHeader("GData-Version", "3.0");
     request.setRawHeader("Authorization",
@@ -1460,7 +1475,7 @@ void GoogleCalendarSyncAdaptor::requestEvents(const QString &accessToken, const
     QNetworkReply *reply = m_networkAccessManager->get(request);
 
     // we're requesting data.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(m_accountId);
+    incrementSemaphore(m_accountId, QStringLiteral("events"));
 
     if (reply) {
         reply->setProperty("accountId", m_accountId);
@@ -1468,6 +1483,7 @@ void GoogleCalendarSyncAdaptor::requestEvents(const QString &accessToken, const
         reply->setProperty("calendarId", calendarId);
         reply->setProperty("syncToken", needCleanSync ? QString() : syncToken);
         reply->setProperty("since", syncDate);
+        reply->setProperty("pageToken", requestPageToken);
         connect(reply, SIGNAL(error(QNetworkReply::NetworkError)),
                 this, SLOT(errorHandler(QNetworkReply::NetworkError)));
         connect(reply, SIGNAL(sslErrors(QList<QSslError>)),
@@ -1481,7 +1497,7 @@ void GoogleCalendarSyncAdaptor::requestEvents(const QString &accessToken, const
         qCWarning(lcSocialPlugin) << "unable to request events for calendar" << calendarId
                                   << "from Google account with id" << m_accountId;
         m_syncSucceeded = false;
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("events"));
     }
 }
 
@@ -1494,18 +1510,17 @@ void GoogleCalendarSyncAdaptor::eventsFinishedHandler()
     QString accessToken = reply->property("accessToken").toString();
     QString syncToken = reply->property("syncToken").toString();
     QDateTime since = reply->property("since").toDateTime();
+    QString pageToken = reply->property("pageToken").toString();
+    QUrl requestUrl = reply->request().url();
     bool isError = reply->property("isError").toBool();
 
     QByteArray replyData = reply->readAll();
     int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
-    QString replyString = QString::fromUtf8(replyData);
     qCDebug(lcSocialPluginTrace) << "-------------------------------";
     qCDebug(lcSocialPluginTrace) << "Events response for calendar:" << calendarId << "from account:" << m_accountId;
     qCDebug(lcSocialPluginTrace) << "HTTP CODE:" << httpCode;
-    Q_FOREACH (QString line, replyString.split('\n', QString::SkipEmptyParts)) {
-        qCDebug(lcSocialPluginTrace) << line.replace('\r', ' ');
-    }
+    SOCIALD_TRACE_DUMP(replyData);
     qCDebug(lcSocialPluginTrace) << "-------------------------------";
 
     disconnect(reply);
@@ -1567,6 +1582,24 @@ void GoogleCalendarSyncAdaptor::eventsFinishedHandler()
             qCWarning(lcSocialPlugin) << "unable to parse event data from request with account"
                                       << m_accountId << "; got:";
             errorDumpStr(QString::fromUtf8(replyData.constData()));
+
+            if (!pageToken.isEmpty()) {
+                // the previous pages were received, the next sync can continue from this one.
+                QJsonObject checkpoint;
+                checkpoint.insert(QStringLiteral("url"), requestUrl.toString(QUrl::FullyEncoded));
+                checkpoint.insert(QStringLiteral("syncToken"), syncToken);
+                checkpoint.insert(QStringLiteral("since"), since.toUTC().toString(Qt::ISODate));
+                if (m_serverCalendarIdToDefaultReminderTimes.contains(calendarId)) {
+                    checkpoint.insert(QStringLiteral("defaultReminder"),
+                                      m_serverCalendarIdToDefaultReminderTimes.value(calendarId));
+                }
+                QJsonArray events;
+                foreach (const QJsonObject &eventData, m_calendarIdToEventObjects.values(calendarId)) {
+                    events.append(eventData);
+                }
+                checkpoint.insert(QStringLiteral("events"), events);
+                saveCheckpoint(m_accountId, eventsCheckpoint(calendarId), checkpoint);
+            }
         }
         m_syncSucceeded = false;
     }
@@ -1579,7 +1612,7 @@ void GoogleCalendarSyncAdaptor::eventsFinishedHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("events"));
 }
 
 mKCal::Notebook::Ptr GoogleCalendarSyncAdaptor::notebookForCalendarId(const QString &calendarId) const
@@ -2042,7 +2075,7 @@ QList<GoogleCalendarSyncAdaptor::UpsyncChange> GoogleCalendarSyncAdaptor::determ
                 localModified++;
                 QByteArray eventBlob = QJsonDocument(localEventData).toJson();
                 qCDebug(lcSocialPluginTrace) << "queueing upsync modification for gcal id:" << updatedGcalId;
-                traceDumpStr(QString::fromUtf8(eventBlob));
+                SOCIALD_TRACE_DUMP(eventBlob);
                 UpsyncChange modification;
                 modification.accessToken = accessToken;
                 modification.upsyncType = GoogleCalendarSyncAdaptor::Modify;
@@ -2119,7 +2152,7 @@ QList<GoogleCalendarSyncAdaptor::UpsyncChange> GoogleCalendarSyncAdaptor::determ
                     localModified++;
                     QByteArray eventBlob = QJsonDocument(localEventData).toJson();
                     qCDebug(lcSocialPluginTrace) << "queueing upsync modification for gcal id:" << gcalId;
-                    traceDumpStr(QString::fromUtf8(eventBlob));
+                    SOCIALD_TRACE_DUMP(eventBlob);
                     UpsyncChange modification;
                     modification.accessToken = accessToken;
                     modification.upsyncType = GoogleCalendarSyncAdaptor::Modify;
@@ -2188,7 +2221,7 @@ void GoogleCalendarSyncAdaptor::queueSequencedInsertion(QList<UpsyncChange> &cha
     insertion.calendarId = calendarId;
     insertion.eventId = insertionGcalId;
     insertion.eventData = QJsonDocument(eventJson).toJson();
-    traceDumpStr(QString::fromUtf8(insertion.eventData));
+    SOCIALD_TRACE_DUMP(insertion.eventData);
 
     // At this point we either add the upsync change to the default queue, or to the sequenced queue
     if (parentChange && !parentChange->eventId.isEmpty()) {
@@ -2246,7 +2279,7 @@ void GoogleCalendarSyncAdaptor::upsyncChanges(const UpsyncChange &changeToUpsync
     }
 
     // we're performing a request.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(m_accountId);
+    incrementSemaphore(m_accountId, QStringLiteral("upsync"));
 
     if (reply) {
         reply->setProperty("accountId", m_accountId);
@@ -2270,12 +2303,12 @@ void GoogleCalendarSyncAdaptor::upsyncChanges(const UpsyncChange &changeToUpsync
                                 << "to calendarId:" << calendarId
                                 << "of account" << m_accountId
                                 << "to" << request.url().toString();
-        traceDumpStr(QString::fromUtf8(eventData));
+        SOCIALD_TRACE_DUMP(eventData);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request upsync for calendar" << calendarId
                                   << "from Google account with id" << m_accountId;
         m_syncSucceeded = false;
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("upsync"));
     }
 }
 
@@ -2448,7 +2481,7 @@ void GoogleCalendarSyncAdaptor::handleInsertModifyReply(QNetworkReply *reply)
                 m_syncSucceeded = false;
             } else {
                 qCDebug(lcSocialPluginTrace) << "Local upsync response json:";
-                traceDumpStr(QString::fromUtf8(replyData));
+                SOCIALD_TRACE_DUMP(replyData);
                 m_changesFromUpsync.insertMulti(calendarId, qMakePair<KCalendarCore::Event::Ptr,QJsonObject>(event, parsed));
                 flagUploadSuccess(kcalEventId);
             }
@@ -2507,7 +2540,7 @@ void GoogleCalendarSyncAdaptor::upsyncFinishedHandler()
     }
 
     // we're finished with this request.
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("upsync"));
 }
 
 void GoogleCalendarSyncAdaptor::setCalendarProperties(
@@ -46,6 +46,9 @@
 static const char *IMAGE_DOWNLOADER_TOKEN_KEY = "url";
 static const char *IMAGE_DOWNLOADER_IDENTIFIER_KEY = "identifier";
 
+// avatars which are not downloaded on metered links are downloaded by a later sync.
+static const qint64 AvatarSizeEstimate = 64 * 1024; // bytes
+
 namespace {
 
 const QString CollectionKeySyncToken = QStringLiteral("syncToken");
@@ -358,7 +361,8 @@ void GoogleTwoWayContactSyncAdaptor::requestData(
     qCDebug(lcSocialPluginTrace) << "requesting" << requestUrl << "with account" << m_accountId;
 
     // we're requesting data.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(m_accountId);
+    const QString task = requestType == ContactGroupRequest ? QStringLiteral("groups") : QStringLiteral("contacts");
+    incrementSemaphore(m_accountId, task);
 
     QNetworkReply *reply = m_networkAccessManager->get(req);
     if (reply) {
@@ -381,7 +385,7 @@ void GoogleTwoWayContactSyncAdaptor::requestData(
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from Google account with id" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, task);
     }
 }
 
@@ -396,12 +400,12 @@ void GoogleTwoWayContactSyncAdaptor::groupsFinishedHandler()
     if (isError) {
         qCWarning(lcSocialPlugin) << "error occurred when performing groups request for Google account" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("groups"));
         return;
     } else if (data.isEmpty()) {
         qCWarning(lcSocialPlugin) << "no groups data in reply from Google with account" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("groups"));
         return;
     }
 
@@ -409,7 +413,7 @@ void GoogleTwoWayContactSyncAdaptor::groupsFinishedHandler()
     if (!GooglePeopleApiResponse::readResponse(data, &response)) {
         qCWarning(lcSocialPlugin) << "unable to parse groups data from reply from Google using account with id" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("groups"));
         return;
     }
 
@@ -437,7 +441,7 @@ void GoogleTwoWayContactSyncAdaptor::groupsFinishedHandler()
         m_sqliteSync->remoteCollectionsDetermined(QList<QContactCollection>());
     }
 
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("groups"));
 }
 
 void GoogleTwoWayContactSyncAdaptor::contactsFinishedHandler()
@@ -458,7 +462,7 @@ void GoogleTwoWayContactSyncAdaptor::contactsFinishedHandler()
             m_connectionsListParams.syncToken.clear();
             m_retriedConnectionsList = true;
             requestData(requestType, contactChangeNotifier);
-            decrementSemaphore(m_accountId);
+            decrementSemaphore(m_accountId, QStringLiteral("contacts"));
             return;
         }
     }
@@ -475,12 +479,12 @@ void GoogleTwoWayContactSyncAdaptor::contactsFinishedHandler()
                           << ", network error was:" << reply->error() << reply->errorString()
                           << "HTTP code:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("contacts"));
         return;
     } else if (data.isEmpty()) {
         qCWarning(lcSocialPlugin) << "no contact data in reply from Google with account" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("contacts"));
         return;
     }
 
@@ -489,7 +493,7 @@ void GoogleTwoWayContactSyncAdaptor::contactsFinishedHandler()
         qCWarning(lcSocialPlugin) << "unable to parse contacts data from reply from Google using account with id"
                           << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("contacts"));
         return;
     }
 
@@ -591,7 +595,7 @@ void GoogleTwoWayContactSyncAdaptor::contactsFinishedHandler()
         continueSync(contactChangeNotifier);
     }
 
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("contacts"));
 }
 
 void GoogleTwoWayContactSyncAdaptor::continueSync(ContactChangeNotifier contactChangeNotifier)
@@ -791,7 +795,7 @@ void GoogleTwoWayContactSyncAdaptor::storeToRemote(const QByteArray &encodedCont
     req.setHeader(QNetworkRequest::ContentLengthHeader, encodedContactUpdates.size());
 
     // we're posting data.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(m_accountId);
+    incrementSemaphore(m_accountId, QStringLiteral("upsync"));
     QNetworkReply *reply = m_networkAccessManager->post(req, encodedContactUpdates);
     if (reply) {
         connect(reply, &QNetworkReply::finished,
@@ -805,7 +809,7 @@ void GoogleTwoWayContactSyncAdaptor::storeToRemote(const QByteArray &encodedCont
     } else {
         qCWarning(lcSocialPlugin) << "unable to post contacts to Google account with id" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("upsync"));
     }
 }
 
@@ -820,7 +824,7 @@ void GoogleTwoWayContactSyncAdaptor::postFinishedHandler()
         qCWarning(lcSocialPlugin) << "error occurred posting contact data to google with account" << m_accountId
                                   << "," << "got response:" << QString::fromUtf8(response);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("upsync"));
         return;
     }
 
@@ -828,7 +832,7 @@ void GoogleTwoWayContactSyncAdaptor::postFinishedHandler()
     if (!GooglePeopleApiResponse::readMultiPartResponse(response, &operationResponses)) {
         qCWarning(lcSocialPlugin) << "unable to read response for batch operation with Google account" << m_accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("upsync"));
         return;
     }
 
@@ -948,7 +952,7 @@ void GoogleTwoWayContactSyncAdaptor::postFinishedHandler()
     }
 
     // finished with this request, so decrementing semaphore.
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("upsync"));
 }
 
 void GoogleTwoWayContactSyncAdaptor::postErrorHandler()
@@ -990,14 +994,15 @@ void GoogleTwoWayContactSyncAdaptor::queueOutstandingAvatars()
 
 bool GoogleTwoWayContactSyncAdaptor::queueAvatarForDownload(const QString &contactGuid, const QString &imageUrl)
 {
-    if (m_apiRequestsRemaining > 0 && !m_queuedAvatarsForDownload.contains(contactGuid)) {
+    if (m_apiRequestsRemaining > 0 && !m_queuedAvatarsForDownload.contains(contactGuid)
+            && allowBulkTransfer(AvatarSizeEstimate)) {
         m_apiRequestsRemaining -= 1;
         m_queuedAvatarsForDownload[contactGuid] = imageUrl;
 
         QVariantMap metadata;
         metadata.insert(IMAGE_DOWNLOADER_TOKEN_KEY, m_accessToken);
         metadata.insert(IMAGE_DOWNLOADER_IDENTIFIER_KEY, contactGuid);
-        incrementSemaphore(m_accountId);
+        incrementSemaphore(m_accountId, QStringLiteral("avatar"));
         QMetaObject::invokeMethod(m_workerObject, "queue", Qt::QueuedConnection,
                                   Q_ARG(QString, imageUrl), Q_ARG(QVariantMap, metadata));
 
@@ -1068,7 +1073,7 @@ void GoogleTwoWayContactSyncAdaptor::imageDownloaded(const QString &url, const Q
         m_queuedAvatarsForDownload.remove(contactGuid);
     }
 
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("avatar"));
 }
 
 void GoogleTwoWayContactSyncAdaptor::purgeAccount(int pid)
@@ -176,7 +176,7 @@ void GoogleSignonSyncAdaptor::refreshTokens(int accountId)
             this, &GoogleSignonSyncAdaptor::signonError,
             Qt::UniqueConnection);
 
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("refreshTokens"));
     session->setProperty("accountId", accountId);
     session->setProperty("mechanism", mechanism);
     session->setProperty("signonSessionData", signonSessionData);
@@ -195,7 +195,7 @@ void GoogleSignonSyncAdaptor::initialSignonResponse(const SignOn::SessionData &r
         // while we were attempting to perform signon sync, and that would
         // leave us in a position where we're unable to automatically recover.
         qCInfo(lcSocialPlugin) << "aborting signon sync refresh";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
         return;
     }
 
@@ -278,8 +278,10 @@ void GoogleSignonSyncAdaptor::refreshTokenResponse(const SignOn::SessionData &re
             << QString::fromLatin1("successfully performed signon refresh for Google account %1: new ExpiresIn: %3")
                .arg(accountId).arg(responseData.getProperty("ExpiresIn").toInt());
 
+    // the data types will sign in again with the refreshed token.
+    invalidateAccessTokens(accountId);
     lowerCredentialsNeedUpdateFlag(accountId);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
 }
 
 void GoogleSignonSyncAdaptor::signonError(const SignOn::Error &error)
@@ -306,7 +308,7 @@ void GoogleSignonSyncAdaptor::signonError(const SignOn::Error &error)
         raiseCredentialsNeedUpdateFlag(accountId);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
 }
 
 void GoogleSignonSyncAdaptor::refreshEmailAlias(const QString &accessToken, int accountId)
@@ -331,7 +333,7 @@ void GoogleSignonSyncAdaptor::refreshEmailAlias(const QString &accessToken, int
         setupReplyTimeout(accountId, reply);
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("emailAlias"));
     } else {
         qCWarning(lcSocialPlugin) << "unable to request email alias from Google account with id"; //<< m_accountId;
     }
@@ -346,7 +348,7 @@ void GoogleSignonSyncAdaptor::emailAliasFinishedHandler()
     int accountId = reply->property("accountId").toInt();
 
     if (isError) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("emailAlias"));
         return;
     }
 
@@ -373,7 +375,7 @@ void GoogleSignonSyncAdaptor::emailAliasFinishedHandler()
         qCDebug(lcSocialPlugin) << "Json parse error:" << error.errorString();
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("emailAlias"));
 }
 
 void GoogleSignonSyncAdaptor::setEmailAliases(const QStringList &aliases, int accountId)
@@ -20,17 +20,16 @@
  ****************************************************************************/
 
 #include "googledatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "trace.h"
 
+#include <QtCore/QTimer>
 #include <QtCore/QVariantMap>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
 
-// libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
-
 // libaccounts-qt5
 #include <Accounts/Manager>
 #include <Accounts/Account>
@@ -44,8 +43,11 @@
 
 GoogleDataTypeSyncAdaptor::GoogleDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
     : SocialNetworkSyncAdaptor("google", dataType, nullptr, parent)
-    , m_triedLoading(false)
 {
+    // stay well within the per-user queries per second quota of the Google APIs.
+    setRequestRateLimit(QStringLiteral("googleapis.com"), 5, 10);
+    // and don't fail the whole sync due to a single 5xx or dropped connection.
+    setRequestRetryLimit(QStringLiteral("googleapis.com"), 3);
 }
 
 GoogleDataTypeSyncAdaptor::~GoogleDataTypeSyncAdaptor()
@@ -90,7 +92,7 @@ void GoogleDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
@@ -111,6 +113,8 @@ void GoogleDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
     // XXX TODO: check expires time, force refresh if < 30.
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (err == QNetworkReply::AuthenticationRequiredError) {
+        // the token may have been revoked, don't share it with the other data types.
+        invalidateAccessTokens(reply->property("accountId").toInt());
         //int accountId = sender()->property("accountId").toInt();
         //Account *account = m_accountManager->account(accountId);
         //if (account->status() == Account::Initialized) {
@@ -154,47 +158,12 @@ void GoogleDataTypeSyncAdaptor::sslErrorsHandler(const QList<QSslError> &errs)
 
 QString GoogleDataTypeSyncAdaptor::clientId()
 {
-    if (!m_triedLoading) {
-        loadClientIdAndSecret();
-    }
-    return m_clientId;
+    return KeyProviderCache::storedKey("google", "google-sync", "client_id");
 }
 
 QString GoogleDataTypeSyncAdaptor::clientSecret()
 {
-    if (!m_triedLoading) {
-        loadClientIdAndSecret();
-    }
-    return m_clientSecret;
-}
-
-void GoogleDataTypeSyncAdaptor::loadClientIdAndSecret()
-{
-    m_triedLoading = true;
-    char *cClientId = NULL;
-    char *cClientSecret = NULL;
-
-    int cSuccess = SailfishKeyProvider_storedKey("google", "google-sync", "client_id", &cClientId);
-    if (cClientId == NULL) {
-        return;
-    } else if (cSuccess != 0) {
-        free(cClientId);
-        return;
-    }
-
-    m_clientId = QLatin1String(cClientId);
-    free(cClientId);
-
-    cSuccess = SailfishKeyProvider_storedKey("google", "google-sync", "client_secret", &cClientSecret);
-    if (cClientSecret == NULL) {
-        return;
-    } else if (cSuccess != 0) {
-        free(cClientSecret);
-        return;
-    }
-
-    m_clientSecret = QLatin1String(cClientSecret);
-    free(cClientSecret);
+    return KeyProviderCache::storedKey("google", "google-sync", "client_secret");
 }
 
 void GoogleDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
@@ -213,44 +182,54 @@ void GoogleDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     // Fetch consumer key and secret from keyprovider
     int accountId = account->id();
     if (!checkAccount(account)) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 #ifdef USE_SAILFISHKEYPROVIDER
     if (clientId().isEmpty() || clientSecret().isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 #endif
 
-    // grab out a valid identity for the sync service.
     Accounts::Service srv(m_accountManager->service(syncServiceName()));
     account->selectService(srv);
+    Accounts::AccountService accSrv(account, srv);
+    QString method = accSrv.authData().method();
+    QString mechanism = accSrv.authData().mechanism();
+    QVariantMap signonSessionData = accSrv.authData().parameters();
+    signonSessionData.insert("ClientId", clientId());
+    signonSessionData.insert("ClientSecret", clientSecret());
+    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
+
+    // another data type of the account may have signed in recently.
+    const QString tokenScope = accessTokenScope(mechanism, signonSessionData);
+    const QString cachedToken = cachedAccessToken(accountId, tokenScope);
+    if (!cachedToken.isEmpty()) {
+        QTimer::singleShot(0, account, [this, account, cachedToken] {
+            signedIn(account, cachedToken);
+        });
+        return;
+    }
+
+    // grab out a valid identity for the sync service.
     SignOn::Identity *identity = account->credentialsId() > 0
             ? SignOn::Identity::existingIdentity(account->credentialsId())
             : nullptr;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "account" << accountId << "has no valid credentials; cannot sign in";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    Accounts::AccountService accSrv(account, srv);
-    QString method = accSrv.authData().method();
-    QString mechanism = accSrv.authData().mechanism();
     SignOn::AuthSession *session = identity->createSession(method);
     if (!session) {
         qCWarning(lcSocialPlugin) << "could not create signon session for account" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    QVariantMap signonSessionData = accSrv.authData().parameters();
-    signonSessionData.insert("ClientId", clientId());
-    signonSessionData.insert("ClientSecret", clientSecret());
-    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
-
     connect(session, &SignOn::AuthSession::response,
             this, &GoogleDataTypeSyncAdaptor::signOnResponse,
             Qt::UniqueConnection);
@@ -259,6 +238,7 @@ void GoogleDataTypeSyncAdaptor::signIn(Accounts::Account *account)
             Qt::UniqueConnection);
 
     session->setProperty("account", QVariant::fromValue<Accounts::Account*>(account));
+    session->setProperty("tokenScope", tokenScope);
     session->setProperty("identity", QVariant::fromValue<SignOn::Identity*>(identity));
     session->process(SignOn::SessionData(signonSessionData), mechanism);
 }
@@ -285,7 +265,7 @@ void GoogleDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void GoogleDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -306,14 +286,24 @@ void GoogleDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &respon
         qCInfo(lcSocialPlugin) << "signon response for account with id" << accountId << "contained no access token";
     }
 
+    cacheAccessToken(accountId, session->property("tokenScope").toString(), data);
+
     session->disconnect(this);
     identity->destroySession(session);
     identity->deleteLater();
+
+    signedIn(account, accessToken);
+}
+
+void GoogleDataTypeSyncAdaptor::signedIn(Accounts::Account *account, const QString &accessToken)
+{
+    int accountId = account->id();
+
     account->deleteLater();
 
     if (!accessToken.isEmpty()) {
         beginSync(accountId, accessToken); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
@@ -69,12 +69,9 @@ private Q_SLOTS:
     void signOnResponse(const SignOn::SessionData &responseData);
 
 private:
-    void loadClientIdAndSecret();
     void setCredentialsNeedUpdate(Accounts::Account *account);
     void signIn(Accounts::Account *account);
-    bool m_triedLoading; // Is true if we tried to load (even if we failed)
-    QString m_clientId;
-    QString m_clientSecret;
+    void signedIn(Accounts::Account *account, const QString &accessToken);
 };
 
 #endif // GOOGLEDATATYPESYNCADAPTOR_H
@@ -219,7 +219,7 @@ void OneDriveImageSyncAdaptor::requestResource(int accountId, const QString &acc
         connect(reply, SIGNAL(finished()), this, SLOT(resourceFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("resource"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from OneDrive account with id" << accountId;
@@ -244,7 +244,7 @@ void OneDriveImageSyncAdaptor::requestNextLink(int accountId, const QString &acc
         connect(reply, SIGNAL(finished()), this, SLOT(resourceFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("resource"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request data from OneDrive account with id" << accountId;
@@ -270,7 +270,7 @@ void OneDriveImageSyncAdaptor::resourceFinishedHandler()
         qCWarning(lcSocialPlugin) << "Unable to parse query response for OneDrive account with id" << accountId;
         qCDebug(lcSocialPlugin) << "Received response data:" << replyData;
         clearRemovalDetectionLists(); // don't perform server-side removal detection during this sync run.
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("resource"));
         return;
     }
 
@@ -280,14 +280,14 @@ void OneDriveImageSyncAdaptor::resourceFinishedHandler()
         m_userId = userObj.value("id").toString();
         if (m_userId.isEmpty()) {
             qCDebug(lcSocialPlugin) << "Unable to determine user id for default resource, aborting";
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("resource"));
             return;
         }
         m_db.syncAccount(accountId, m_userId);
     } else if (m_userId != userObj.value("id").toString()) {
         // ignore this album, not created by the current user.
         qCDebug(lcSocialPlugin) << "Ignoring album" << parsed.value("name").toString() << " - different user.";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("resource"));
         return;
     }
 
@@ -366,7 +366,7 @@ void OneDriveImageSyncAdaptor::resourceFinishedHandler()
         requestNextLink(accountId, accessToken, nextLink, defaultResource);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("resource"));
 }
 
 bool OneDriveImageSyncAdaptor::initRemovalDetectionLists(int accountId)
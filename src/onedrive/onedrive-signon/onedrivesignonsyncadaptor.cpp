@@ -177,7 +177,7 @@ void OneDriveSignonSyncAdaptor::refreshTokens(int accountId)
             this, &OneDriveSignonSyncAdaptor::signonError,
             Qt::UniqueConnection);
 
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("refreshTokens"));
     session->setProperty("accountId", accountId);
     session->setProperty("mechanism", mechanism);
     session->setProperty("signonSessionData", signonSessionData);
@@ -196,7 +196,7 @@ void OneDriveSignonSyncAdaptor::initialSignonResponse(const SignOn::SessionData
         // leave us in a position where we're unable to automatically recover.
         int accountId = session->property("accountId").toInt();
         qCInfo(lcSocialPlugin) << "aborting signon sync refresh";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
         return;
     }
 
@@ -276,7 +276,7 @@ void OneDriveSignonSyncAdaptor::refreshTokenResponse(const SignOn::SessionData &
                .arg(accountId).arg(responseData.getProperty("ExpiresIn").toInt());
 
     lowerCredentialsNeedUpdateFlag(accountId);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
 }
 
 void OneDriveSignonSyncAdaptor::signonError(const SignOn::Error &error)
@@ -303,5 +303,5 @@ void OneDriveSignonSyncAdaptor::signonError(const SignOn::Error &error)
         raiseCredentialsNeedUpdateFlag(accountId);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("refreshTokens"));
 }
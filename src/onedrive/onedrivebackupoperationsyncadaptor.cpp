@@ -150,8 +150,8 @@ void OneDriveBackupOperationSyncAdaptor::beginSync(int accountId, const QString
         }
 
         // Wait for org.sailfish.backup service to finish creating the backup.
-        // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        // creating the backup can take longer than any request, don't treat it as stalled.
+        beginExternalWait(accountId, QStringLiteral("backup"));
         m_localFileInfo = QFileInfo(createBackupReply.value());
         break;
     }
@@ -200,22 +200,22 @@ void OneDriveBackupOperationSyncAdaptor::cloudBackupStatusChanged(int accountId,
             qCWarning(lcSocialPlugin) << "Backup finished, but cannot find the backup file:"
                                       << m_localFileInfo.absoluteFilePath();
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(m_accountId);
+            decrementSemaphore(m_accountId, QStringLiteral("backup"));
             return;
         }
 
         beginSyncOperation(m_accountId, m_accessToken);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Canceled")) {
         qCWarning(lcSocialPlugin) << "Cloud backup was canceled";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Error")) {
         qCWarning(lcSocialPlugin) << "Failed to create backup file:" << m_localFileInfo.absoluteFilePath();
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
     }
 }
 
@@ -227,7 +227,7 @@ void OneDriveBackupOperationSyncAdaptor::cloudBackupError(int accountId, const Q
 
     qCWarning(lcSocialPlugin) << "Cloud backup error was:" << error << errorString;
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(m_accountId);
+    decrementSemaphore(m_accountId, QStringLiteral("backup"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::cloudRestoreStatusChanged(int accountId, const QString &status)
@@ -242,12 +242,12 @@ void OneDriveBackupOperationSyncAdaptor::cloudRestoreStatusChanged(int accountId
     if (status == QLatin1String("Canceled")) {
         qCWarning(lcSocialPlugin) << "Cloud backup restore was canceled";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
 
     } else if (status == QLatin1String("Error")) {
         qCWarning(lcSocialPlugin) << "Cloud backup restore failed";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(m_accountId);
+        decrementSemaphore(m_accountId, QStringLiteral("backup"));
     }
 }
 
@@ -287,7 +287,7 @@ void OneDriveBackupOperationSyncAdaptor::beginListOperation(int accountId, const
         connect(reply, &QNetworkReply::finished, this, &OneDriveBackupOperationSyncAdaptor::listOperationFinished);
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("list"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to start directory listing request for OneDrive account with id" << accountId;
@@ -342,7 +342,7 @@ void OneDriveBackupOperationSyncAdaptor::listOperationFinished()
         } else {
             qCWarning(lcSocialPlugin) << errorMessage;
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("list"));
             return;
         }
     }
@@ -377,7 +377,7 @@ void OneDriveBackupOperationSyncAdaptor::listOperationFinished()
     } else {
         qCDebug(lcSocialPlugin) << "Wrote directory listing for profile:" << m_accountSyncProfile->name() << dirListing;
     }
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("list"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::beginSyncOperation(int accountId, const QString &accessToken)
@@ -436,7 +436,7 @@ void OneDriveBackupOperationSyncAdaptor::initialiseAppFolderRequest(int accountI
         connect(reply, SIGNAL(finished()), this, SLOT(initialiseAppFolderFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("appFolder"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to create app folder initialisation request for OneDrive account with id" << accountId;
@@ -504,7 +504,7 @@ void OneDriveBackupOperationSyncAdaptor::initialiseAppFolderFinishedHandler()
         }
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("appFolder"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::getRemoteFolderMetadata(int accountId,
@@ -543,7 +543,7 @@ void OneDriveBackupOperationSyncAdaptor::getRemoteFolderMetadata(int accountId,
         connect(reply, SIGNAL(finished()), this, SLOT(getRemoteFolderMetadataFinishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("folderMetadata"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to perform remote folder metadata request for OneDrive account with id" << accountId;
@@ -579,7 +579,7 @@ void OneDriveBackupOperationSyncAdaptor::getRemoteFolderMetadataFinishedHandler(
         if (!parsed.contains("children")) {
             qCWarning(lcSocialPlugin) << "folder metadata request result had no children!";
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("folderMetadata"));
             return;
         }
 
@@ -619,7 +619,7 @@ void OneDriveBackupOperationSyncAdaptor::getRemoteFolderMetadataFinishedHandler(
                 if (!updatedMetadata) {
                     qCWarning(lcSocialPlugin) << "could not find remote dir in directory metadata:" << remoteDirName;
                     setStatus(SocialNetworkSyncAdaptor::Error);
-                    decrementSemaphore(accountId);
+                    decrementSemaphore(accountId, QStringLiteral("folderMetadata"));
                     return;
                 }
 
@@ -634,7 +634,7 @@ void OneDriveBackupOperationSyncAdaptor::getRemoteFolderMetadataFinishedHandler(
         }
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("folderMetadata"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::requestData(int accountId, const QString &accessToken,
@@ -689,7 +689,7 @@ void OneDriveBackupOperationSyncAdaptor::requestData(int accountId, const QStrin
         }
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("download"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to create download request:" << remotePath << remoteFile << redirectUrl
@@ -713,7 +713,7 @@ void OneDriveBackupOperationSyncAdaptor::remotePathFinishedHandler()
                                   << accountId << ":";
         debugDumpJsonResponse(data);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("download"));
         return;
     }
 
@@ -723,7 +723,7 @@ void OneDriveBackupOperationSyncAdaptor::remotePathFinishedHandler()
         qCWarning(lcSocialPlugin) << "no backup data exists in reply from OneDrive with account" << accountId << ", got:";
         debugDumpJsonResponse(data);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("download"));
         return;
     }
 
@@ -741,7 +741,7 @@ void OneDriveBackupOperationSyncAdaptor::remotePathFinishedHandler()
         }
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("download"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::remoteFileFinishedHandler()
@@ -762,7 +762,7 @@ void OneDriveBackupOperationSyncAdaptor::remoteFileFinishedHandler()
                                   << accountId << ", got:";
         debugDumpJsonResponse(data);
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("download"));
         return;
     }
 
@@ -778,7 +778,7 @@ void OneDriveBackupOperationSyncAdaptor::remoteFileFinishedHandler()
             qCWarning(lcSocialPlugin) << "no content redirect url exists in file metadata for file:" << remoteFile;
             debugDumpJsonResponse(data);
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("download"));
             return;
         }
         qCDebug(lcSocialPlugin) << "redirected from:" << remoteFileName << "to:" << redirectUrl;
@@ -796,7 +796,7 @@ void OneDriveBackupOperationSyncAdaptor::remoteFileFinishedHandler()
         }
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("download"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::uploadData(int accountId, const QString &accessToken,
@@ -932,7 +932,7 @@ void OneDriveBackupOperationSyncAdaptor::uploadData(int accountId, const QString
         }
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("upload"));
         setupReplyTimeout(accountId, reply, 10 * 60 * 1000); // 10 minutes
     } else {
         qCWarning(lcSocialPlugin) << "unable to create upload request:" << localPath << localFile << "->" << remotePath
@@ -963,7 +963,7 @@ void OneDriveBackupOperationSyncAdaptor::createRemotePathFinishedHandler()
             qCWarning(lcSocialPlugin) << "remote path creation failed:" << httpCode;
             debugDumpJsonResponse(data);
             setStatus(SocialNetworkSyncAdaptor::Error);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("upload"));
             return;
         }
     }
@@ -989,7 +989,7 @@ void OneDriveBackupOperationSyncAdaptor::createRemotePathFinishedHandler()
             // contain the remote id.  So, better to have uniform code to handle all cases.
             getRemoteFolderMetadata(accountId, accessToken, localPath, remotePath,
                                     createdDirectoryParentFolderId, createdDirectoryName);
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("upload"));
             return;
         }
     }
@@ -1002,7 +1002,7 @@ void OneDriveBackupOperationSyncAdaptor::createRemotePathFinishedHandler()
         qCDebug(lcSocialPlugin) << "uploading file:" << localFile << "from" << localPath << "to:" << remotePath;
         uploadData(accountId, accessToken, localPath, remotePath, localFile);
     }
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("upload"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::createUploadSessionFinishedHandler()
@@ -1038,7 +1038,7 @@ void OneDriveBackupOperationSyncAdaptor::createUploadSessionFinishedHandler()
         uploadData(accountId, accessToken, localPath, remotePath, localFile);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("upload"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::filePartUploadFinishedHandler()
@@ -1100,7 +1100,7 @@ void OneDriveBackupOperationSyncAdaptor::filePartUploadFinishedHandler()
         m_uploadFile = nullptr;
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("upload"));
 }
 
 void OneDriveBackupOperationSyncAdaptor::downloadProgressHandler(qint64 bytesReceived, qint64 bytesTotal)
@@ -20,17 +20,16 @@
  ****************************************************************************/
 
 #include "onedrivedatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "trace.h"
 
+#include <QtCore/QTimer>
 #include <QtCore/QVariantMap>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
 
-//libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
-
 // libaccounts-qt5
 #include <Accounts/Manager>
 #include <Accounts/Account>
@@ -44,7 +43,6 @@
 
 OneDriveDataTypeSyncAdaptor::OneDriveDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
     : SocialNetworkSyncAdaptor("onedrive", dataType, 0, parent)
-    , m_triedLoading(false)
 {
 }
 
@@ -82,7 +80,7 @@ void OneDriveDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
@@ -97,6 +95,8 @@ void OneDriveDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
     const int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
     if (err == QNetworkReply::AuthenticationRequiredError) {
+        // the token may have been revoked, don't share it with the other data types.
+        invalidateAccessTokens(reply->property("accountId").toInt());
         int httpCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         qCInfo(lcSocialPlugin) << "sociald:OneDrive: received:" << httpCode
                                << "would normally set CredentialsNeedUpdate for account"
@@ -137,27 +137,7 @@ QString OneDriveDataTypeSyncAdaptor::api() const
 
 QString OneDriveDataTypeSyncAdaptor::clientId()
 {
-    if (!m_triedLoading) {
-        loadClientId();
-    }
-    return m_clientId;
-}
-
-void OneDriveDataTypeSyncAdaptor::loadClientId()
-{
-    m_triedLoading = true;
-    char *cClientId = NULL;
-
-    int cSuccess = SailfishKeyProvider_storedKey("onedrive", "onedrive-sync", "client_id", &cClientId);
-    if (cClientId == NULL) {
-        return;
-    } else if (cSuccess != 0) {
-        free(cClientId);
-        return;
-    }
-
-    m_clientId = QLatin1String(cClientId);
-    free(cClientId);
+    return KeyProviderCache::storedKey("onedrive", "onedrive-sync", "client_id");
 }
 
 void OneDriveDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
@@ -178,37 +158,47 @@ void OneDriveDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     // Fetch consumer key from keyprovider
     int accountId = account->id();
     if (!checkAccount(account) || clientId().isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    // grab out a valid identity for the sync service.
     Accounts::Service srv(m_accountManager->service(syncServiceName()));
     account->selectService(srv);
+    Accounts::AccountService accSrv(account, srv);
+    QString method = accSrv.authData().method();
+    QString mechanism = accSrv.authData().mechanism();
+    QVariantMap signonSessionData = accSrv.authData().parameters();
+    signonSessionData.insert("ClientId", clientId());
+    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
+
+    // another data type of the account may have signed in recently.
+    const QString tokenScope = accessTokenScope(mechanism, signonSessionData);
+    const QString cachedToken = cachedAccessToken(accountId, tokenScope);
+    if (!cachedToken.isEmpty()) {
+        QTimer::singleShot(0, account, [this, account, cachedToken] {
+            signedIn(account, cachedToken);
+        });
+        return;
+    }
+
+    // grab out a valid identity for the sync service.
     SignOn::Identity *identity = account->credentialsId() > 0
             ? SignOn::Identity::existingIdentity(account->credentialsId())
             : nullptr;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "account" << accountId << "has no valid credentials; cannot sign in";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    Accounts::AccountService accSrv(account, srv);
-    QString method = accSrv.authData().method();
-    QString mechanism = accSrv.authData().mechanism();
     SignOn::AuthSession *session = identity->createSession(method);
     if (!session) {
         qCWarning(lcSocialPlugin) << "could not create signon session for account" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    QVariantMap signonSessionData = accSrv.authData().parameters();
-    signonSessionData.insert("ClientId", clientId());
-    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
-
     connect(session, &SignOn::AuthSession::response,
             this, &OneDriveDataTypeSyncAdaptor::signOnResponse,
             Qt::UniqueConnection);
@@ -217,6 +207,7 @@ void OneDriveDataTypeSyncAdaptor::signIn(Accounts::Account *account)
             Qt::UniqueConnection);
 
     session->setProperty("account", QVariant::fromValue<Accounts::Account*>(account));
+    session->setProperty("tokenScope", tokenScope);
     session->setProperty("identity", QVariant::fromValue<SignOn::Identity*>(identity));
     session->process(SignOn::SessionData(signonSessionData), mechanism);
 }
@@ -243,7 +234,7 @@ void OneDriveDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void OneDriveDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -264,16 +255,26 @@ void OneDriveDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &resp
         qCInfo(lcSocialPlugin) << "signon response for account with id" << accountId << "contained no access token";
     }
 
-    m_api = account->value(QStringLiteral("api/Host")).toString();
+    cacheAccessToken(accountId, session->property("tokenScope").toString(), data);
 
     session->disconnect(this);
     identity->destroySession(session);
     identity->deleteLater();
+
+    signedIn(account, accessToken);
+}
+
+void OneDriveDataTypeSyncAdaptor::signedIn(Accounts::Account *account, const QString &accessToken)
+{
+    int accountId = account->id();
+
+    m_api = account->value(QStringLiteral("api/Host")).toString();
+
     account->deleteLater();
 
     if (!accessToken.isEmpty()) {
         beginSync(accountId, accessToken); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
@@ -2,8 +2,8 @@ TARGET = sociald-client
 
 include($$PWD/../common.pri)
 
-HEADERS += socialdplugin.h
-SOURCES += socialdplugin.cpp
+HEADERS += socialdplugin.h socialdsyncscheduler.h
+SOURCES += socialdplugin.cpp socialdsyncscheduler.cpp
 
 sociald_sync_profile.path = /etc/buteo/profiles/sync
 sociald_sync_profile.files = $$PWD/sociald.All.xml
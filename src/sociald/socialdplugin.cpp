@@ -19,14 +19,13 @@
  ****************************************************************************/
 
 #include "socialdplugin.h"
+#include "socialdsyncscheduler.h"
+#include "networkcostpolicy_p.h"
 #include "trace.h"
 
 #include <QCoreApplication>
 #include <QTranslator>
 #include <QStringList>
-#include <QDBusConnection>
-#include <QDBusMessage>
-#include <QDBusPendingCall>
 
 #include <PluginCbInterface.h>
 
@@ -35,7 +34,11 @@ SocialdPlugin::SocialdPlugin(const QString& pluginName,
                              const Buteo::SyncProfile& profile,
                              Buteo::PluginCbInterface *callbackInterface)
     : ClientPlugin(pluginName, profile, callbackInterface)
+    , m_scheduler(new SocialdSyncScheduler(this))
+    , m_deferredQueued(false)
 {
+    connect(m_scheduler, &SocialdSyncScheduler::finished,
+            this, &SocialdPlugin::schedulerFinished);
 }
 
 SocialdPlugin::~SocialdPlugin()
@@ -71,45 +74,56 @@ bool SocialdPlugin::uninit()
 
 bool SocialdPlugin::startSync()
 {
-    QStringList startSyncParams;
+    if (m_scheduler->isRunning()) {
+        qCDebug(lcSocialPlugin) << "sync of" << getProfileName() << "is still in progress";
+        return false;
+    }
+
+    QStringList profileNames;
     if (!m_dataType.isEmpty() && !m_serviceName.isEmpty()) {
         // trigger sync of specific data type with all accounts.
-        startSyncParams.append(QStringLiteral("%1.%2").arg(m_serviceName, m_dataType));
+        profileNames.append(QStringLiteral("%1.%2").arg(m_serviceName, m_dataType));
     } else {
-        // trigger sync of all known data types with all accounts.
-        startSyncParams << "google.Calendars";
-        startSyncParams << "google.Contacts";
-        startSyncParams << "facebook.Calendars";
-        startSyncParams << "facebook.Contacts";
-        startSyncParams << "facebook.Images";
-        startSyncParams << "facebook.Notifications";
-        //startSyncParams << "facebook.Posts";
-        startSyncParams << "twitter.Notifications";
-        startSyncParams << "twitter.Posts";
-        startSyncParams << "vk.Posts";
-        startSyncParams << "vk.Notifications";
-        startSyncParams << "vk.Calendars";
-        startSyncParams << "vk.Contacts";
-        startSyncParams << "vk.Images";
+        // trigger sync of all installed data types with all accounts.
+        profileNames = SocialdSyncScheduler::installedDataTypeProfiles(&m_profileManager);
     }
 
-    foreach (const QString &param, startSyncParams) {
-        QDBusMessage message = QDBusMessage::createMethodCall(
-                "com.meego.msyncd", "/synchronizer", "com.meego.msyncd", "startSync");
-        message.setArguments(QVariantList() << param);
-        QDBusConnection::sessionBus().asyncCall(message);
+    bool ok = false;
+    const int maxConcurrency = profile().key(QStringLiteral("max_concurrency")).toInt(&ok);
+    if (ok) {
+        m_scheduler->setMaxConcurrency(maxConcurrency);
     }
 
-    // always "succeed" even though the actual sync may fail.
-    updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
-                                     Buteo::SyncResults::SYNC_RESULT_SUCCESS,
-                                     Buteo::SyncResults::NO_ERROR));
-
+    m_profileNames = profileNames;
+    m_deferredQueued = false;
+    m_scheduler->start(profileNames);
     return true;
 }
 
+void SocialdPlugin::schedulerFinished()
+{
+    const QString message = QStringLiteral("%1 of %2 data types synced")
+            .arg(m_scheduler->succeededCount()).arg(m_scheduler->totalCount());
+
+    // the failures of the individual data types are reported by their own
+    // profiles, so only fail if nothing could be synced at all.
+    if (m_scheduler->isAborted()
+            || (m_scheduler->failedCount() > 0 && m_scheduler->succeededCount() == 0)) {
+        updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
+                                         Buteo::SyncResults::SYNC_RESULT_FAILED,
+                                         Buteo::SyncResults::ABORTED));
+        emit error(getProfileName(), message, Buteo::SyncResults::ABORTED);
+    } else {
+        updateResults(Buteo::SyncResults(QDateTime::currentDateTime(),
+                                         Buteo::SyncResults::SYNC_RESULT_SUCCESS,
+                                         Buteo::SyncResults::NO_ERROR));
+        emit success(getProfileName(), message);
+    }
+}
+
 void SocialdPlugin::abortSync(Sync::SyncStatus)
 {
+    m_scheduler->abort();
 }
 
 bool SocialdPlugin::cleanUp()
@@ -122,12 +136,35 @@ Buteo::SyncResults SocialdPlugin::getSyncResults() const
     return m_syncResults;
 }
 
-void SocialdPlugin::connectivityStateChanged(Sync::ConnectivityType, bool)
+void SocialdPlugin::connectivityStateChanged(Sync::ConnectivityType type, bool state)
 {
-    // TODO, see TransportTracker.cpp:149
-    // Sync::CONNECTIVITY_INTERNET, true|false
-    // Kill all ongoing on false
-    // "Free" single shot sync on wlan?
+    // See TransportTracker.cpp:149
+    if (type != Sync::CONNECTIVITY_INTERNET || !m_scheduler->isRunning()) {
+        return;
+    }
+
+    if (!state) {
+        qCInfo(lcSocialPlugin) << "lost connectivity, aborting sync of" << getProfileName();
+        m_scheduler->abort();
+        return;
+    }
+
+    // on WLAN, sync the data types which deferred transfers once more.
+    if (m_deferredQueued || NetworkCostPolicy::currentLink() != NetworkCostPolicy::Unmetered) {
+        return;
+    }
+    m_deferredQueued = true;
+
+    QStringList deferred;
+    Q_FOREACH (const QString &name, NetworkCostPolicy::deferredProfiles()) {
+        if (m_profileNames.contains(name)) {
+            deferred.append(name);
+        }
+    }
+    const int queued = m_scheduler->enqueue(deferred);
+    if (queued > 0) {
+        qCInfo(lcSocialPlugin) << "unmetered link available, syncing" << queued << "deferred data types again";
+    }
 }
 
 void SocialdPlugin::updateResults(const Buteo::SyncResults &results)
@@ -23,9 +23,12 @@
 
 #include <QString>
 #include <QObject>
+#include <QStringList>
 
 #include "buteosyncfw_p.h"
 
+class SocialdSyncScheduler;
+
 /*
    This plugin implementation provides a simple way
    to trigger syncs of all datatypes for all accounts,
@@ -45,6 +48,12 @@
        sociald.twitter.Notifications.xml
        sociald.twitter.Posts.xml
 
+   The data types synced by sociald.All are those of the
+   installed data type plugins.  They are synced in stages,
+   at most "max_concurrency" (a key of the profile) at a
+   time, with cheap data types such as notifications and
+   calendars before bulk data types such as images.
+
    Note that it does not extend SocialdButeoPlugin
    (from common.pri) as it uses a different mechanism.
 */
@@ -68,12 +77,19 @@ public:
 public slots:
     void connectivityStateChanged(Sync::ConnectivityType type, bool state) override;
 
+private slots:
+    void schedulerFinished();
+
 private:
     void updateResults(const Buteo::SyncResults &results);
 
     Buteo::SyncResults m_syncResults;
+    Buteo::ProfileManager m_profileManager;
+    SocialdSyncScheduler *m_scheduler;
     QString m_dataType;
     QString m_serviceName;
+    QStringList m_profileNames;
+    bool m_deferredQueued;
 };
 
 #endif // SOCIALDPLUGIN_H
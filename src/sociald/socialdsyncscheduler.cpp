@@ -0,0 +1,359 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "socialdsyncscheduler.h"
+#include "trace.h"
+
+#include <QTimer>
+#include <QPair>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+#include <algorithm>
+
+namespace {
+    const QString MsyncdService = QStringLiteral("com.meego.msyncd");
+    const QString MsyncdPath = QStringLiteral("/synchronizer");
+    const QString MsyncdInterface = QStringLiteral("com.meego.msyncd");
+
+    const int DefaultMaxConcurrency = 2;
+    const int DefaultStageTimeout = 30 * 60 * 1000; // msec
+
+    // The data types synced by sociald.All, cheapest and most
+    // time-sensitive first.  Signon and the backup data types
+    // are not part of a regular sync.
+    const QStringList DataTypeOrder = QStringList()
+            << QStringLiteral("Notifications")
+            << QStringLiteral("Calendars")
+            << QStringLiteral("Posts")
+            << QStringLiteral("Messages")
+            << QStringLiteral("Emails")
+            << QStringLiteral("Contacts")
+            << QStringLiteral("Images")
+            << QStringLiteral("Videos");
+
+    void callMsyncd(const QString &method, const QString &profileName)
+    {
+        QDBusMessage message = QDBusMessage::createMethodCall(MsyncdService, MsyncdPath, MsyncdInterface, method);
+        message.setArguments(QVariantList() << profileName);
+        QDBusConnection::sessionBus().asyncCall(message);
+    }
+}
+
+SocialdSyncScheduler::SocialdSyncScheduler(QObject *parent)
+    : QObject(parent)
+    , m_maxConcurrency(DefaultMaxConcurrency)
+    , m_stageTimeout(DefaultStageTimeout)
+    , m_total(0)
+    , m_succeeded(0)
+    , m_failed(0)
+    , m_aborted(false)
+{
+    QDBusConnection::sessionBus().connect(MsyncdService, MsyncdPath, MsyncdInterface,
+                                          QStringLiteral("syncStatus"),
+                                          this, SLOT(syncStatus(QString,int,QString,int)));
+}
+
+SocialdSyncScheduler::~SocialdSyncScheduler()
+{
+}
+
+int SocialdSyncScheduler::dataTypeCost(const QString &dataType)
+{
+    return DataTypeOrder.indexOf(dataType);
+}
+
+QStringList SocialdSyncScheduler::installedDataTypeProfiles(Buteo::ProfileManager *profileManager)
+{
+    QList<QPair<int, QString> > candidates;
+    Q_FOREACH (const QString &name, profileManager->profileNames(Buteo::Profile::TYPE_SYNC)) {
+        // template profiles are named <service>.<DataType>
+        const QStringList servicePlusDataType = name.split(QLatin1Char('.'));
+        if (servicePlusDataType.size() != 2) {
+            continue;
+        }
+        const int cost = dataTypeCost(servicePlusDataType.at(1));
+        if (cost < 0) {
+            continue;
+        }
+
+        // only profiles which are synced by one of our data type plugins,
+        // which are named <service>-<datatype>.
+        Buteo::SyncProfile *profile = profileManager->syncProfile(name);
+        const bool isDataTypeProfile = profile && profile->clientProfile()
+                && profile->clientProfile()->name() == QStringLiteral("%1-%2").arg(servicePlusDataType.at(0),
+                                                                                  servicePlusDataType.at(1).toLower());
+        delete profile;
+        if (isDataTypeProfile) {
+            candidates.append(qMakePair(cost, name));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    QStringList retn;
+    for (int i = 0; i < candidates.size(); ++i) {
+        retn.append(candidates.at(i).second);
+    }
+    return retn;
+}
+
+void SocialdSyncScheduler::setMaxConcurrency(int maxConcurrency)
+{
+    m_maxConcurrency = qMax(1, maxConcurrency);
+}
+
+int SocialdSyncScheduler::maxConcurrency() const
+{
+    return m_maxConcurrency;
+}
+
+void SocialdSyncScheduler::setStageTimeout(int msecs)
+{
+    m_stageTimeout = msecs;
+}
+
+void SocialdSyncScheduler::start(const QStringList &profileNames)
+{
+    m_pending = profileNames;
+    m_total = profileNames.size();
+    m_succeeded = 0;
+    m_failed = 0;
+    m_aborted = false;
+
+    qCInfo(lcSocialPlugin) << "syncing" << m_total << "data types, at most" << m_maxConcurrency
+                           << "at a time:" << profileNames;
+
+    if (m_pending.isEmpty()) {
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+        return;
+    }
+
+    launchNext();
+}
+
+// Queues more data type syncs to a running scheduler, e.g. to sync a data
+// type again.  Profiles which are still pending or running are skipped.
+int SocialdSyncScheduler::enqueue(const QStringList &profileNames)
+{
+    if (!isRunning() || m_aborted) {
+        return 0;
+    }
+
+    int count = 0;
+    Q_FOREACH (const QString &name, profileNames) {
+        if (!m_pending.contains(name) && !m_running.contains(name)) {
+            m_pending.append(name);
+            count += 1;
+        }
+    }
+    m_total += count;
+
+    launchNext();
+    return count;
+}
+
+void SocialdSyncScheduler::abort()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_aborted = true;
+    m_failed += m_pending.size();
+    m_pending.clear();
+
+    const QStringList running = m_running.keys();
+    Q_FOREACH (const QString &name, running) {
+        Stage &stage(m_running[name]);
+        if (!stage.templateDone) {
+            callMsyncd(QStringLiteral("abortSync"), name);
+        }
+        Q_FOREACH (const QString &profileId, stage.activeProfiles) {
+            callMsyncd(QStringLiteral("abortSync"), profileId);
+        }
+        stage.failed = true;
+        completeStage(name);
+    }
+}
+
+bool SocialdSyncScheduler::isRunning() const
+{
+    return !m_pending.isEmpty() || !m_running.isEmpty();
+}
+
+bool SocialdSyncScheduler::isAborted() const
+{
+    return m_aborted;
+}
+
+int SocialdSyncScheduler::totalCount() const
+{
+    return m_total;
+}
+
+int SocialdSyncScheduler::succeededCount() const
+{
+    return m_succeeded;
+}
+
+int SocialdSyncScheduler::failedCount() const
+{
+    return m_failed;
+}
+
+void SocialdSyncScheduler::launchNext()
+{
+    while (!m_pending.isEmpty() && m_running.size() < m_maxConcurrency) {
+        const QString name = m_pending.takeFirst();
+        qCDebug(lcSocialPlugin) << "starting sync of" << name;
+
+        Stage &stage(m_running[name]);
+        stage.timer = new QTimer(this);
+        stage.timer->setSingleShot(true);
+        connect(stage.timer, &QTimer::timeout, this, [this, name] {
+            qCWarning(lcSocialPlugin) << "sync of" << name << "did not finish in time";
+            QHash<QString, Stage>::iterator it = m_running.find(name);
+            if (it != m_running.end()) {
+                it->failed = true;
+                completeStage(name);
+            }
+        });
+        stage.timer->start(m_stageTimeout);
+
+        QDBusMessage message = QDBusMessage::createMethodCall(MsyncdService, MsyncdPath, MsyncdInterface,
+                                                              QStringLiteral("startSync"));
+        message.setArguments(QVariantList() << name);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
+                QDBusConnection::sessionBus().asyncCall(message), this);
+        watcher->setProperty("profileName", name);
+        connect(watcher, &QDBusPendingCallWatcher::finished,
+                this, &SocialdSyncScheduler::startSyncFinished);
+    }
+}
+
+void SocialdSyncScheduler::startSyncFinished(QDBusPendingCallWatcher *watcher)
+{
+    const QString name = watcher->property("profileName").toString();
+    QDBusPendingReply<bool> reply = *watcher;
+    watcher->deleteLater();
+
+    if (!reply.isError() && reply.value()) {
+        return;
+    }
+
+    qCWarning(lcSocialPlugin) << "msyncd did not start sync of" << name << ":" << reply.error().message();
+    QHash<QString, Stage>::iterator it = m_running.find(name);
+    if (it != m_running.end()) {
+        it->templateDone = true;
+        it->failed = true;
+        if (it->activeProfiles.isEmpty()) {
+            completeStage(name);
+        }
+    }
+}
+
+QString SocialdSyncScheduler::stageForProfile(const QString &profileId) const
+{
+    if (m_running.contains(profileId)) {
+        return profileId;
+    }
+
+    // per-account profiles are named <template>-<accountId>
+    const int separator = profileId.lastIndexOf(QLatin1Char('-'));
+    if (separator > 0) {
+        bool isAccountId = false;
+        profileId.mid(separator + 1).toInt(&isAccountId);
+        const QString name = profileId.left(separator);
+        if (isAccountId && m_running.contains(name)) {
+            return name;
+        }
+    }
+
+    return QString();
+}
+
+void SocialdSyncScheduler::syncStatus(const QString &profileId, int status, const QString &message, int statusDetails)
+{
+    Q_UNUSED(statusDetails)
+
+    const QString name = stageForProfile(profileId);
+    if (name.isEmpty()) {
+        return;
+    }
+
+    Stage &stage(m_running[name]);
+    switch (status) {
+    case Sync::SYNC_QUEUED:
+    case Sync::SYNC_STARTED:
+    case Sync::SYNC_PROGRESS:
+    case Sync::SYNC_STOPPING:
+        if (profileId != name) {
+            stage.activeProfiles.insert(profileId);
+        }
+        return;
+    default:
+        break;
+    }
+
+    if (status != Sync::SYNC_DONE) {
+        qCInfo(lcSocialPlugin) << "sync of" << profileId << "failed with status" << status << message;
+        stage.failed = true;
+    }
+
+    if (profileId == name) {
+        stage.templateDone = true;
+    } else {
+        stage.activeProfiles.remove(profileId);
+    }
+
+    if (stage.templateDone && stage.activeProfiles.isEmpty()) {
+        completeStage(name);
+    }
+}
+
+void SocialdSyncScheduler::completeStage(const QString &name)
+{
+    const Stage stage = m_running.take(name);
+    if (stage.timer) {
+        stage.timer->stop();
+        stage.timer->deleteLater();
+    }
+
+    if (stage.failed) {
+        m_failed += 1;
+    } else {
+        m_succeeded += 1;
+    }
+
+    qCDebug(lcSocialPlugin) << "sync of" << name << (stage.failed ? "failed" : "finished");
+    emit progress(m_succeeded + m_failed, m_total);
+
+    if (!m_aborted) {
+        launchNext();
+    }
+    if (!isRunning()) {
+        qCInfo(lcSocialPlugin) << "synced" << m_succeeded << "of" << m_total << "data types," << m_failed << "failed";
+        emit finished();
+    }
+}
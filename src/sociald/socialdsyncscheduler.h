@@ -0,0 +1,103 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALDSYNCSCHEDULER_H
+#define SOCIALDSYNCSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+#include "buteosyncfw_p.h"
+
+class QTimer;
+class QDBusPendingCallWatcher;
+
+/*
+   Triggers the syncs of a list of data type template
+   profiles (e.g. google.Calendars) via msyncd, running at
+   most maxConcurrency of them at the same time.
+
+   A data type sync counts as running until msyncd reports
+   that the template profile sync, and the syncs of all the
+   per-account profiles it triggered (e.g. google.Calendars-3),
+   have finished, or until the stage timeout expires.
+*/
+class SocialdSyncScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SocialdSyncScheduler(QObject *parent = 0);
+    ~SocialdSyncScheduler();
+
+    // Returns the installed data type template profiles which should be synced
+    // by sociald.All, cheap and high-value data types first.
+    static QStringList installedDataTypeProfiles(Buteo::ProfileManager *profileManager);
+    static int dataTypeCost(const QString &dataType);
+
+    void setMaxConcurrency(int maxConcurrency);
+    int maxConcurrency() const;
+    void setStageTimeout(int msecs);
+
+    void start(const QStringList &profileNames);
+    int enqueue(const QStringList &profileNames);
+    void abort();
+    bool isRunning() const;
+    bool isAborted() const;
+
+    int totalCount() const;
+    int succeededCount() const;
+    int failedCount() const;
+
+Q_SIGNALS:
+    void progress(int completed, int total);
+    void finished();
+
+private Q_SLOTS:
+    void syncStatus(const QString &profileId, int status, const QString &message, int statusDetails);
+    void startSyncFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    struct Stage {
+        Stage() : templateDone(false), failed(false), timer(0) {}
+        QSet<QString> activeProfiles;
+        bool templateDone;
+        bool failed;
+        QTimer *timer;
+    };
+
+    void launchNext();
+    void completeStage(const QString &name);
+    QString stageForProfile(const QString &profileId) const;
+
+    QStringList m_pending;
+    QHash<QString, Stage> m_running;
+    int m_maxConcurrency;
+    int m_stageTimeout;
+    int m_total;
+    int m_succeeded;
+    int m_failed;
+    bool m_aborted;
+};
+
+#endif // SOCIALDSYNCSCHEDULER_H
@@ -138,7 +138,7 @@ void TwitterNotificationSyncAdaptor::requestNotifications(int accountId, const Q
             connect(mreply, SIGNAL(finished()), this, SLOT(finishedMentionsHandler()));
 
             // we're requesting data.  Increment the semaphore so that we know we're still busy.
-            incrementSemaphore(accountId);
+            incrementSemaphore(accountId, QStringLiteral("mentions"));
             setupReplyTimeout(accountId, mreply);
         } else {
             qCWarning(lcSocialPlugin) << "unable to request mention timeline notifications from Twitter account with id" << accountId;
@@ -174,7 +174,7 @@ void TwitterNotificationSyncAdaptor::requestNotifications(int accountId, const Q
             connect(rreply, SIGNAL(finished()), this, SLOT(finishedRetweetsHandler()));
 
             // we're requesting data.  Increment the semaphore so that we know we're still busy.
-            incrementSemaphore(accountId);
+            incrementSemaphore(accountId, QStringLiteral("retweets"));
             setupReplyTimeout(accountId, rreply);
         } else {
             qCWarning(lcSocialPlugin) << "unable to request retweet notifications from Twitter account with id" << accountId;
@@ -210,7 +210,7 @@ void TwitterNotificationSyncAdaptor::requestNotifications(int accountId, const Q
         connect(freply, SIGNAL(finished()), this, SLOT(finishedFollowersHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("followers"));
         setupReplyTimeout(accountId, freply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request followers from Twitter account with id" << accountId;
@@ -229,7 +229,7 @@ void TwitterNotificationSyncAdaptor::finishedMentionsHandler()
 
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, ignoring request response";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("mentions"));
         return;
     }
 
@@ -238,7 +238,7 @@ void TwitterNotificationSyncAdaptor::finishedMentionsHandler()
     if (ok) {
         if (!tweets.size()) {
             qCDebug(lcSocialPlugin) << "no mentions received for account" << accountId;
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("mentions"));
             return;
         }
 
@@ -316,7 +316,7 @@ void TwitterNotificationSyncAdaptor::finishedMentionsHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("mentions"));
 }
 
 void TwitterNotificationSyncAdaptor::finishedRetweetsHandler()
@@ -331,7 +331,7 @@ void TwitterNotificationSyncAdaptor::finishedRetweetsHandler()
 
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, ignoring request response";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("retweets"));
         return;
     }
 
@@ -340,7 +340,7 @@ void TwitterNotificationSyncAdaptor::finishedRetweetsHandler()
     if (ok) {
         if (!tweets.size()) {
             qCDebug(lcSocialPlugin) << "no retweets received for account" << accountId;
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("retweets"));
             return;
         }
 
@@ -416,7 +416,7 @@ void TwitterNotificationSyncAdaptor::finishedRetweetsHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("retweets"));
 }
 
 void TwitterNotificationSyncAdaptor::finishedFollowersHandler()
@@ -433,7 +433,7 @@ void TwitterNotificationSyncAdaptor::finishedFollowersHandler()
 
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, ignoring request response";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("followers"));
         return;
     }
 
@@ -490,7 +490,7 @@ void TwitterNotificationSyncAdaptor::finishedFollowersHandler()
                         connect(sreply, SIGNAL(finished()), this, SLOT(finishedUserShowHandler()));
 
                         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-                        incrementSemaphore(accountId);
+                        incrementSemaphore(accountId, QStringLiteral("userShow"));
                         setupReplyTimeout(accountId, sreply);
                     } else {
                         qCWarning(lcSocialPlugin) << "unable to request user information from Twitter account with id" << accountId;
@@ -533,7 +533,7 @@ void TwitterNotificationSyncAdaptor::finishedFollowersHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("followers"));
 }
 
 void TwitterNotificationSyncAdaptor::finishedUserShowHandler()
@@ -548,7 +548,7 @@ void TwitterNotificationSyncAdaptor::finishedUserShowHandler()
 
     if (syncAborted()) {
         qCInfo(lcSocialPlugin) << "sync aborted, ignoring request response";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("userShow"));
         return;
     }
 
@@ -580,7 +580,7 @@ void TwitterNotificationSyncAdaptor::finishedUserShowHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("userShow"));
 }
 
 Notification *TwitterNotificationSyncAdaptor::createNotification(int accountId, TwitterNotificationType ntype)
@@ -99,7 +99,7 @@ void TwitterHomeTimelineSyncAdaptor::requestMe(int accountId, const QString &oau
         connect(reply, SIGNAL(finished()), this, SLOT(finishedMeHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("me"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request user verification from Twitter account with id" << accountId;
@@ -140,7 +140,7 @@ void TwitterHomeTimelineSyncAdaptor::requestPosts(int accountId, const QString &
         connect(reply, SIGNAL(finished()), this, SLOT(finishedPostsHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("posts"));
         setupReplyTimeout(accountId, reply);
     } else {
         qCWarning(lcSocialPlugin) << "unable to request user timeline posts from Twitter account with id" << accountId;
@@ -176,7 +176,7 @@ void TwitterHomeTimelineSyncAdaptor::finishedMeHandler()
                                   << "," << "got:" << replyData;
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("me"));
 }
 
 void TwitterHomeTimelineSyncAdaptor::finishedPostsHandler()
@@ -196,7 +196,7 @@ void TwitterHomeTimelineSyncAdaptor::finishedPostsHandler()
     if (ok) {
         if (!tweets.size()) {
             qCDebug(lcSocialPlugin) << "no feed posts received for account" << accountId;
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("posts"));
             return;
         }
 
@@ -277,5 +277,5 @@ void TwitterHomeTimelineSyncAdaptor::finishedPostsHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("posts"));
 }
@@ -20,6 +20,7 @@
  ****************************************************************************/
 
 #include "twitterdatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "trace.h"
 
 #include <QtCore/QDebug>
@@ -35,9 +36,6 @@
 #include <QCryptographicHash>
 #include <QJsonDocument>
 
-//libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
-
 // libaccounts-qt5
 #include <Accounts/Manager>
 #include <Accounts/Account>
@@ -51,8 +49,10 @@
 
 TwitterDataTypeSyncAdaptor::TwitterDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
     : SocialNetworkSyncAdaptor("twitter", dataType, 0, parent)
-    , m_triedLoading(false)
 {
+    // Twitter limits are per 15 minute window, which are enforced via the
+    // X-Rate-Limit-* headers; this just avoids bursts.
+    setRequestRateLimit(QStringLiteral("api.twitter.com"), 1, 5);
 }
 
 TwitterDataTypeSyncAdaptor::~TwitterDataTypeSyncAdaptor()
@@ -85,30 +85,24 @@ void TwitterDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     if (!account) {
         qCWarning(lcSocialPlugin) << "existing account with id" << accountId << "couldn't be retrieved";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
 
 QString TwitterDataTypeSyncAdaptor::consumerKey()
 {
-    if (!m_triedLoading) {
-        loadConsumerKeyAndSecret();
-    }
-    return m_consumerKey;
+    return KeyProviderCache::storedKey("twitter", "twitter-sync", "consumer_key");
 }
 
 QString TwitterDataTypeSyncAdaptor::consumerSecret()
 {
-    if (!m_triedLoading) {
-        loadConsumerKeyAndSecret();
-    }
-    return m_consumerSecret;
+    return KeyProviderCache::storedKey("twitter", "twitter-sync", "consumer_secret");
 }
 
 void TwitterDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
@@ -279,25 +273,6 @@ QDateTime TwitterDataTypeSyncAdaptor::parseTwitterDateTime(const QString &tdt)
     return time;
 }
 
-void TwitterDataTypeSyncAdaptor::loadConsumerKeyAndSecret()
-{
-    m_triedLoading = true;
-    char *cConsumerKey = NULL;
-    char *cConsumerSecret = NULL;
-    int ckSuccess = SailfishKeyProvider_storedKey("twitter", "twitter-sync", "consumer_key", &cConsumerKey);
-    int csSuccess = SailfishKeyProvider_storedKey("twitter", "twitter-sync", "consumer_secret", &cConsumerSecret);
-
-    if (ckSuccess != 0 || cConsumerKey == NULL || csSuccess != 0 || cConsumerSecret == NULL) {
-        qCInfo(lcSocialPlugin) << "No valid OAuth2 keys found";
-        return;
-    }
-
-    m_consumerKey = QLatin1String(cConsumerKey);
-    m_consumerSecret = QLatin1String(cConsumerSecret);
-    free(cConsumerKey);
-    free(cConsumerSecret);
-}
-
 void TwitterDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
 {
     qWarning() << "sociald:Twitter: setting CredentialsNeedUpdate to true for account:" << account->id();
@@ -316,7 +291,7 @@ void TwitterDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     QString secret = consumerSecret();
     int accountId = account->id();
     if (!checkAccount(account) || key.isEmpty() || secret.isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
@@ -326,7 +301,7 @@ void TwitterDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     SignOn::Identity *identity = account->credentialsId() > 0 ? SignOn::Identity::existingIdentity(account->credentialsId()) : 0;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "account" << accountId << "has no valid credentials, cannot sign in";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
@@ -337,7 +312,7 @@ void TwitterDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     if (!session) {
         qCWarning(lcSocialPlugin) << "could not create signon session for account" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
@@ -380,7 +355,7 @@ void TwitterDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void TwitterDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -418,5 +393,5 @@ void TwitterDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &respo
         beginSync(accountId, oauthToken, oauthTokenSecret); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
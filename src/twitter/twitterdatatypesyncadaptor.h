@@ -71,12 +71,8 @@ private Q_SLOTS:
     void signOnResponse(const SignOn::SessionData &sessionData);
 
 private:
-    void loadConsumerKeyAndSecret();
     void setCredentialsNeedUpdate(Accounts::Account *account);
     void signIn(Accounts::Account *account);
-    bool m_triedLoading; // Is true if we tried to load (even if we failed)
-    QString m_consumerKey;
-    QString m_consumerSecret;
 };
 
 #endif // TWITTERDATATYPESYNCADAPTOR_H
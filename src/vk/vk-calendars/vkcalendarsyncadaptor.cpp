@@ -218,7 +218,7 @@ void VKCalendarSyncAdaptor::retryThrottledRequest(const QString &request, const
         qCDebug(lcSocialPlugin) << "retrying Calendars" << request << "request for VK account:" << accountId;
         requestEvents(accountId, args[1].toString(), args[2].toInt());
     }
-    decrementSemaphore(accountId); // finished waiting for the request.
+    decrementSemaphore(accountId, QStringLiteral("throttled")); // finished waiting for the request.
 }
 
 void VKCalendarSyncAdaptor::requestEvents(int accountId, const QString &accessToken, int offset)
@@ -247,16 +247,16 @@ void VKCalendarSyncAdaptor::requestEvents(int accountId, const QString &accessTo
         connect(reply, SIGNAL(finished()), this, SLOT(finishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("events"));
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << accessToken << offset;
         enqueueThrottledRequest(QStringLiteral("requestEvents"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -335,5 +335,5 @@ void VKCalendarSyncAdaptor::finishedHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("events"));
 }
@@ -47,6 +47,9 @@ static const char *IMAGE_DOWNLOADER_TOKEN_KEY = "token";
 static const char *IMAGE_DOWNLOADER_ACCOUNT_ID_KEY = "account_id";
 static const char *IMAGE_DOWNLOADER_IDENTIFIER_KEY = "identifier";
 
+// avatars which are not downloaded on metered links are downloaded by a later sync.
+static const qint64 AvatarSizeEstimate = 64 * 1024; // bytes
+
 namespace {
 
 const QString FriendCollectionName = QStringLiteral("VK");
@@ -304,7 +307,7 @@ void VKContactSyncAdaptor::retryThrottledRequest(const QString &request, const Q
         qCDebug(lcSocialPlugin) << "retrying Contacts" << request << "request for VK account:" << accountId;
         requestData(accountId, args[1].toInt());
     }
-    decrementSemaphore(accountId); // finished waiting for the request.
+    decrementSemaphore(accountId, QStringLiteral("throttled")); // finished waiting for the request.
 }
 
 void VKContactSyncAdaptor::beginSync(int accountId, const QString &accessToken)
@@ -347,7 +350,7 @@ void VKContactSyncAdaptor::requestData(int accountId, int startIndex)
     QNetworkRequest req(requestUrl);
 
     // we're requesting data.  Increment the semaphore so that we know we're still busy.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("contacts"));
     QNetworkReply *reply = m_networkAccessManager->get(req);
     if (reply) {
         reply->setProperty("accountId", accountId);
@@ -362,13 +365,13 @@ void VKContactSyncAdaptor::requestData(int accountId, int startIndex)
         m_apiRequestsRemaining[accountId] = m_apiRequestsRemaining[accountId] - 1;
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << startIndex;
         enqueueThrottledRequest(QStringLiteral("requestData"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -385,9 +388,7 @@ void VKContactSyncAdaptor::contactsFinishedHandler()
     removeReplyTimeout(accountId, reply);
 
     qCDebug(lcSocialPluginTrace) << "received VK friends data for account:" << accountId << ":";
-    Q_FOREACH (const QString &line, QString::fromUtf8(data).split('\n', QString::SkipEmptyParts)) {
-        qCDebug(lcSocialPluginTrace) << line;
-    }
+    SOCIALD_TRACE_DUMP(data);
 
     if (isError) {
         QVariantList args;
@@ -402,12 +403,12 @@ void VKContactSyncAdaptor::contactsFinishedHandler()
         }
         qCWarning(lcSocialPlugin) << "error occurred when performing contacts request for VK account:" << accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("contacts"));
         return;
     } else if (data.isEmpty()) {
         qCWarning(lcSocialPlugin) << "no contact data in reply from VK with account:" << accountId;
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("contacts"));
         return;
     }
 
@@ -430,12 +431,13 @@ void VKContactSyncAdaptor::contactsFinishedHandler()
         sqliteSync->remoteContactsDetermined(sqliteSync->m_collection, m_remoteContacts[accountId]);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("contacts"));
 }
 
 bool VKContactSyncAdaptor::queueAvatarForDownload(int accountId, const QString &accessToken, const QString &contactGuid, const QString &imageUrl)
 {
-    if (m_apiRequestsRemaining[accountId] > 0 && !m_queuedAvatarsForDownload[accountId].contains(contactGuid)) {
+    if (m_apiRequestsRemaining[accountId] > 0 && !m_queuedAvatarsForDownload[accountId].contains(contactGuid)
+            && allowBulkTransfer(AvatarSizeEstimate)) {
         m_apiRequestsRemaining[accountId] = m_apiRequestsRemaining[accountId] - 1;
         m_queuedAvatarsForDownload[accountId][contactGuid] = imageUrl;
 
@@ -443,7 +445,7 @@ bool VKContactSyncAdaptor::queueAvatarForDownload(int accountId, const QString &
         metadata.insert(IMAGE_DOWNLOADER_ACCOUNT_ID_KEY, accountId);
         metadata.insert(IMAGE_DOWNLOADER_TOKEN_KEY, accessToken);
         metadata.insert(IMAGE_DOWNLOADER_IDENTIFIER_KEY, contactGuid);
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("avatar"));
         m_workerObject->queue(imageUrl, metadata);
 
         return true;
@@ -630,7 +632,7 @@ void VKContactSyncAdaptor::imageDownloaded(const QString &url, const QString &pa
         m_downloadedContactAvatars[accountId].insert(contactGuid, path);
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("avatar"));
 }
 
 void VKContactSyncAdaptor::deleteDownloadedAvatar(const QContact &contact)
@@ -20,17 +20,39 @@
  ****************************************************************************/
 
 #include "vkimagesyncadaptor.h"
+#include "socialdnetworkaccessmanager_p.h"
 #include "trace.h"
 
 #include <QtCore/QPair>
 #include <QtCore/QVariantMap>
 #include <QtCore/QByteArray>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtCore/QUrlQuery>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 
 #define VK_IMAGES_MAX_COUNT 1000 /* maximum images returned per request */
 
+namespace {
+    // the photo listing of an album is resumed from the page at which
+    // it was interrupted, see SocialNetworkSyncAdaptor::saveCheckpoint().
+    QString photosCheckpoint(const QString &ownerId, const QString &albumId)
+    {
+        return QStringLiteral("photos-%1-%2").arg(ownerId, albumId);
+    }
+
+    QString withAccessToken(const QString &url, const QString &accessToken)
+    {
+        QUrl retn(url);
+        QUrlQuery query(retn);
+        query.removeAllQueryItems(QStringLiteral("access_token"));
+        query.addQueryItem(QStringLiteral("access_token"), accessToken);
+        retn.setQuery(query);
+        return retn.toString();
+    }
+}
+
 // Currently, we integrate with the device image gallery via saving thumbnails to the
 // ~/.local/share/system/privileged/Images directory, and filling the
 // ~/.local/share/system/privileged/Images/vk.db with appropriate data
@@ -216,7 +238,7 @@ void VKImageSyncAdaptor::retryThrottledRequest(const QString &request, const QVa
                                args[2].toString());
         }
     }
-    decrementSemaphore(accountId); // finished waiting for the request.
+    decrementSemaphore(accountId, QStringLiteral("throttled")); // finished waiting for the request.
 }
 
 void VKImageSyncAdaptor::requestData(int accountId,
@@ -227,6 +249,7 @@ void VKImageSyncAdaptor::requestData(int accountId,
 {
     if (syncAborted()) {
         qCDebug(lcSocialPlugin) << "skipping data request due to sync abort";
+        saveAlbumCheckpoint(accountId, vkUserId, vkAlbumId, continuationUrl);
         m_syncError = true;
         return;
     }
@@ -283,16 +306,16 @@ void VKImageSyncAdaptor::requestData(int accountId,
         }
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, vkAlbumId.isEmpty() ? QStringLiteral("albums") : QStringLiteral("images"));
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << accessToken << continuationUrl << vkUserId << vkAlbumId;
         enqueueThrottledRequest(QStringLiteral("requestData"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -321,14 +344,14 @@ void VKImageSyncAdaptor::albumsFinishedHandler()
 
         qCWarning(lcSocialPlugin) << "unable to read albums response for VK account with id" << accountId;
         m_syncError = true;
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("albums"));
         return;
     }
 
     QJsonArray items = parsed.value(QLatin1String("response")).toObject().value(QLatin1String("items")).toArray();
     if (items.size() == 0) {
         qCDebug(lcSocialPlugin) << "VK account with id" << accountId << "has no albums";
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("albums"));
         return;
     }
 
@@ -362,7 +385,9 @@ void VKImageSyncAdaptor::albumsFinishedHandler()
         if (created > lastSyncTimestampForAlbum || updated > lastSyncTimestampForAlbum || (created == 0 && updated == 0)) {
             qCDebug(lcSocialPlugin) << "Need to request photos for album:" << id << title
                                     << "with timestamps:" << created << "+" << updated << ">" << lastSyncTimestampForAlbum;
-            m_requestedPhotosForOwnerAndAlbum.append(QStringLiteral("%1:%2:%3").arg(ownerId).arg(id).arg(accountId));
+            const QString album = QStringLiteral("%1:%2:%3").arg(ownerId).arg(id).arg(accountId);
+            m_requestedPhotosForOwnerAndAlbum.append(album);
+            m_albumUpdated.insert(album, updated);
         } else {
             qCDebug(lcSocialPlugin) << "No need to request photos for album:" << id << title
                                     << "with timestamps:" << created << "+" << updated << "<=" << lastSyncTimestampForAlbum;
@@ -377,7 +402,7 @@ void VKImageSyncAdaptor::albumsFinishedHandler()
     requestQueuedAlbum(accessToken);
 
     // Finally, reduce our semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("albums"));
 }
 
 void VKImageSyncAdaptor::imagesFinishedHandler()
@@ -389,6 +414,7 @@ void VKImageSyncAdaptor::imagesFinishedHandler()
     QString vkUserId = reply->property("vkUserId").toString();
     QString vkAlbumId = reply->property("vkAlbumId").toString();
     QString continuationUrl = reply->property("continuationUrl").toString();
+    const QUrl requestUrl = reply->url();
     QByteArray replyData = reply->readAll();
     disconnect(reply);
     reply->deleteLater();
@@ -398,7 +424,7 @@ void VKImageSyncAdaptor::imagesFinishedHandler()
     bool ok = false;
     QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
     if (isError || !ok || !parsed.contains(QLatin1String("response"))) {
-        QVariantList args; args << accountId << accessToken << vkUserId << vkAlbumId << continuationUrl;
+        QVariantList args; args << accountId << accessToken << continuationUrl << vkUserId << vkAlbumId;
         if (enqueueServerThrottledRequestIfRequired(parsed, QStringLiteral("requestData"), args)) {
             // we hit the throttle limit, let throttle timer repeat the request
             // don't decrement semaphore yet as we're still waiting for it.
@@ -407,8 +433,9 @@ void VKImageSyncAdaptor::imagesFinishedHandler()
         }
 
         qCWarning(lcSocialPlugin) << "unable to read photos response for VK account with id" << accountId;
+        saveAlbumCheckpoint(accountId, vkUserId, vkAlbumId, continuationUrl);
         m_syncError = true;
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("images"));
         return;
     }
 
@@ -461,15 +488,22 @@ void VKImageSyncAdaptor::imagesFinishedHandler()
         // append the photo to our internal list.
         qCDebug(lcSocialPlugin) << "have new photo:" << id << src << height << width << date;
 
-        m_receivedPhotos.append(VKImage::create(id, vkAlbumId, vkUserId, text, thumbSrc,
-                                                src, QString(), QString(),
-                                                width, height, date, accountId));
+        QJsonObject photo;
+        photo.insert(QLatin1String("id"), id);
+        photo.insert(QLatin1String("text"), text);
+        photo.insert(QLatin1String("date"), date);
+        photo.insert(QLatin1String("width"), width);
+        photo.insert(QLatin1String("height"), height);
+        photo.insert(QLatin1String("src"), src);
+        photo.insert(QLatin1String("thumbSrc"), thumbSrc);
+        m_albumPhotos.append(photo);
+        addPhoto(photo, accountId, vkAlbumId, vkUserId);
         requestImagesCount += 1;
     }
 
     // perform a continuation request if required.   set offset in url + 1000 to current offset.
     if (requestImagesCount == VK_IMAGES_MAX_COUNT) {
-        QUrl continuation = QUrl(continuationUrl);
+        QUrl continuation = requestUrl;
         QUrlQuery queryItems(continuation);
         int offset = queryItems.hasQueryItem("offset")
                    ? queryItems.queryItemValue("offset").toInt() + VK_IMAGES_MAX_COUNT
@@ -485,7 +519,38 @@ void VKImageSyncAdaptor::imagesFinishedHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("images"));
+}
+
+void VKImageSyncAdaptor::addPhoto(const QJsonObject &photo, int accountId,
+                                  const QString &vkAlbumId, const QString &vkUserId)
+{
+    m_receivedPhotos.append(VKImage::create(photo.value(QLatin1String("id")).toString(), vkAlbumId, vkUserId,
+                                            photo.value(QLatin1String("text")).toString(),
+                                            photo.value(QLatin1String("thumbSrc")).toString(),
+                                            photo.value(QLatin1String("src")).toString(), QString(), QString(),
+                                            photo.value(QLatin1String("width")).toInt(),
+                                            photo.value(QLatin1String("height")).toInt(),
+                                            photo.value(QLatin1String("date")).toInt(), accountId));
+}
+
+// Saves the offset at which the photo listing of the album was interrupted,
+// with the photos of the previous pages, for the next sync.  Nothing of the
+// album is stored when its first page fails, so it is synced from the start.
+// Continuation urls carry the access token, which is not stored.
+void VKImageSyncAdaptor::saveAlbumCheckpoint(int accountId, const QString &vkUserId,
+                                             const QString &vkAlbumId, const QString &pageUrl)
+{
+    if (vkAlbumId.isEmpty() || pageUrl.isEmpty()) {
+        return;
+    }
+
+    const QString album = QStringLiteral("%1:%2:%3").arg(vkUserId).arg(vkAlbumId).arg(accountId);
+    QJsonObject checkpoint;
+    checkpoint.insert(QLatin1String("updated"), m_albumUpdated.value(album));
+    checkpoint.insert(QLatin1String("next"), SocialdNetworkAccessManager::withoutCredentials(QUrl(pageUrl)).toString());
+    checkpoint.insert(QLatin1String("photos"), m_albumPhotos);
+    saveCheckpoint(accountId, photosCheckpoint(vkUserId, vkAlbumId), checkpoint);
 }
 
 void VKImageSyncAdaptor::possiblyAddNewUser(int accountId, const QString &accessToken, const QString &vkUserId)
@@ -521,16 +586,16 @@ void VKImageSyncAdaptor::possiblyAddNewUser(int accountId, const QString &access
                 this, SLOT(sslErrorsHandler(QList<QSslError>)));
         connect(reply, SIGNAL(finished()), this, SLOT(userFinishedHandler()));
 
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("user"));
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << accessToken << vkUserId;
         enqueueThrottledRequest(QStringLiteral("possiblyAddNewUser"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -566,7 +631,7 @@ void VKImageSyncAdaptor::userFinishedHandler()
     QString photoSrc = userObject.value(QLatin1String("photo_medium")).toString();
     m_receivedUsers.append(VKUser::create(id, firstName, lastName, photoSrc, QString(), accountId));
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("user"));
 }
 
 void VKImageSyncAdaptor::requestQueuedAlbum(const QString &accessToken)
@@ -578,7 +643,26 @@ void VKImageSyncAdaptor::requestQueuedAlbum(const QString &accessToken)
         QString id = parts.at(1);
         int accountId = parts.at(2).toInt();
         qCDebug(lcSocialPlugin) << "start loading VK album:" << id << ownerId << accountId;
+
+        // if the album hasn't changed since, continue from the interrupted page.
+        m_albumPhotos = QJsonArray();
+        const QJsonObject checkpoint = takeCheckpoint(accountId, photosCheckpoint(ownerId, id));
+        QString resumeUrl;
+        if (checkpoint.value(QLatin1String("updated")).toInt()
+                == m_albumUpdated.value(m_requestedPhotosForOwnerAndAlbum.at(m_currentAlbumIndex))) {
+            resumeUrl = checkpoint.value(QLatin1String("next")).toString();
+        }
+        if (!resumeUrl.isEmpty()) {
+            m_albumPhotos = checkpoint.value(QLatin1String("photos")).toArray();
+            Q_FOREACH (const QJsonValue &photo, m_albumPhotos) {
+                addPhoto(photo.toObject(), accountId, id, ownerId);
+            }
+            qCInfo(lcSocialPlugin) << "resuming photos of VK album" << id << "for account" << accountId
+                                   << "after" << m_albumPhotos.size() << "photos";
+            resumeUrl = withAccessToken(resumeUrl, accessToken);
+        }
+
         m_currentAlbumIndex++;
-        requestData(accountId, accessToken, QString(), ownerId, id);
+        requestData(accountId, accessToken, resumeUrl, ownerId, id);
     }
 }
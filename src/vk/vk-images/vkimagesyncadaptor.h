@@ -29,6 +29,9 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QVariantMap>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtSql/QSqlDatabase>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
@@ -58,6 +61,8 @@ private:
                      const QString &vkUserId, const QString &vkAlbumId);
     void possiblyAddNewUser(int accountId, const QString &accessToken, const QString &vkUserId);
     void requestQueuedAlbum(const QString &accessToken);
+    void addPhoto(const QJsonObject &photo, int accountId, const QString &vkAlbumId, const QString &vkUserId);
+    void saveAlbumCheckpoint(int accountId, const QString &vkUserId, const QString &vkAlbumId, const QString &pageUrl);
 
 private Q_SLOTS:
     void albumsFinishedHandler();
@@ -71,6 +76,8 @@ private:
     QSet<QString> m_requestedUsers; // only want to request the user information once.
     QList<QString> m_requestedPhotosForOwnerAndAlbum; // owner_id:album_id:account_id
     QList<VKAlbum::ConstPtr> m_emptyAlbums;
+    QHash<QString, int> m_albumUpdated; // owner_id:album_id:account_id to the updated time of the album
+    QJsonArray m_albumPhotos; // of the album being downloaded, for its checkpoint
     VKImagesDatabase m_db;
     bool m_syncError;
     int m_currentAlbumIndex;
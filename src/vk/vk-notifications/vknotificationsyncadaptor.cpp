@@ -73,7 +73,7 @@ void VKNotificationSyncAdaptor::retryThrottledRequest(const QString &request, co
         qCDebug(lcSocialPlugin) << "retrying Notifications" << request << "request for VK account:" << accountId;
         requestNotifications(accountId, args[1].toString(), args[2].toString(), args[3].toString());
     }
-    decrementSemaphore(accountId); // finished waiting for the request.
+    decrementSemaphore(accountId, QStringLiteral("throttled")); // finished waiting for the request.
 }
 
 void VKNotificationSyncAdaptor::requestNotifications(int accountId, const QString &accessToken, const QString &until, const QString &pagingToken)
@@ -100,16 +100,16 @@ void VKNotificationSyncAdaptor::requestNotifications(int accountId, const QStrin
         connect(reply, SIGNAL(finished()), this, SLOT(finishedHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("notifications"));
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << accessToken << until << pagingToken;
         enqueueThrottledRequest(QStringLiteral("requestNotifications"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -146,7 +146,7 @@ void VKNotificationSyncAdaptor::finishedHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("notifications"));
 }
 
 void VKNotificationSyncAdaptor::saveVKNotificationFromObject(int accountId, const QJsonObject &notif, const QList<UserProfile> &userProfiles)
@@ -95,7 +95,7 @@ void VKPostSyncAdaptor::retryThrottledRequest(const QString &request, const QVar
         qCDebug(lcSocialPlugin) << "retrying Posts" << request << "request for VK account:" << accountId;
         requestPosts(accountId, args[1].toString());
     }
-    decrementSemaphore(accountId); // finished waiting for the request.
+    decrementSemaphore(accountId, QStringLiteral("throttled")); // finished waiting for the request.
 }
 
 void VKPostSyncAdaptor::requestPosts(int accountId, const QString &accessToken)
@@ -129,16 +129,16 @@ void VKPostSyncAdaptor::requestPosts(int accountId, const QString &accessToken)
         connect(reply, SIGNAL(finished()), this, SLOT(finishedPostsHandler()));
 
         // we're requesting data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId);
+        incrementSemaphore(accountId, QStringLiteral("posts"));
         setupReplyTimeout(accountId, reply);
     } else {
-        // request was throttled by VKNetworkAccessManager
+        // no reply could be created, retry the request later
         QVariantList args;
         args << accountId << accessToken;
         enqueueThrottledRequest(QStringLiteral("requestPosts"), args);
 
         // we are waiting to request data.  Increment the semaphore so that we know we're still busy.
-        incrementSemaphore(accountId); // decremented in retryThrottledRequest().
+        incrementSemaphore(accountId, QStringLiteral("throttled")); // decremented in retryThrottledRequest().
     }
 }
 
@@ -162,7 +162,7 @@ void VKPostSyncAdaptor::finishedPostsHandler()
         QJsonArray items = responseObj.value(QStringLiteral("items")).toArray();
         if (!items.size()) {
             qCDebug(lcSocialPlugin) << "no feed posts received for account:" << accountId;
-            decrementSemaphore(accountId);
+            decrementSemaphore(accountId, QStringLiteral("posts"));
             return;
         }
 
@@ -215,7 +215,7 @@ void VKPostSyncAdaptor::finishedPostsHandler()
     }
 
     // we're finished this request.  Decrement our busy semaphore.
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("posts"));
 }
 
 void VKPostSyncAdaptor::saveVKPostFromObject(int accountId, const QJsonObject &post, const QList<UserProfile> &userProfiles, const QList<GroupProfile> &groupProfiles)
@@ -384,7 +384,7 @@ void VKPostSyncAdaptor::saveVKPostFromObject(int accountId, const QJsonObject &p
         newPost.link = QStringLiteral("https://m.vk.com/wall") + identifier;
     }
 
-    Q_FOREACH (const QString &line, body.split('\n')) { qCDebug(lcSocialPluginTrace) << line; }
+    SOCIALD_TRACE_DUMP(body);
 
     if (hasValidContent) {
         m_db.addVKPost(identifier, createdTime, body, newPost, images, posterName, posterIcon, accountId);
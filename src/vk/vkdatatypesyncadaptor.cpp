@@ -6,18 +6,18 @@
  ****************************************************************************/
 
 #include "vkdatatypesyncadaptor.h"
+#include "keyprovidercache_p.h"
 #include "vknetworkaccessmanager_p.h"
+#include "replaynetworkaccessmanager_p.h"
 #include "trace.h"
 
+#include <QtCore/QTimer>
 #include <QtCore/QVariantMap>
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
 
-//libsailfishkeyprovider
-#include <sailfishkeyprovider.h>
-
 //libaccounts-qt
 #include <Accounts/Manager>
 #include <Accounts/Account>
@@ -155,7 +155,11 @@ QDateTime VKDataTypeSyncAdaptor::parseVKDateTime(const QJsonValue &v)
 
 
 VKDataTypeSyncAdaptor::VKDataTypeSyncAdaptor(SocialNetworkSyncAdaptor::DataType dataType, QObject *parent)
-    : SocialNetworkSyncAdaptor("vk", dataType, new VKNetworkAccessManager, parent), m_triedLoading(false)
+    : SocialNetworkSyncAdaptor("vk", dataType,
+                               ReplayNetworkAccessManager::isConfigured()
+                                    ? defaultNetworkAccessManager(QStringLiteral("vk"), dataType)
+                                    : new VKNetworkAccessManager,
+                               parent)
 {
     m_throttleTimer.setSingleShot(true);
     connect(&m_throttleTimer, &QTimer::timeout, this, &VKDataTypeSyncAdaptor::throttleTimerTimeout);
@@ -245,12 +249,12 @@ void VKDataTypeSyncAdaptor::updateDataForAccount(int accountId)
     if (!account) {
         qCWarning(lcSocialPlugin) << "existing account with id" << accountId << "couldn't be retrieved";
         setStatus(SocialNetworkSyncAdaptor::Error);
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
     // will be decremented by either signOnError or signOnResponse.
-    incrementSemaphore(accountId);
+    incrementSemaphore(accountId, QStringLiteral("signIn"));
     signIn(account);
 }
 
@@ -271,6 +275,11 @@ void VKDataTypeSyncAdaptor::errorHandler(QNetworkReply::NetworkError err)
 
     bool ok = false;
     QJsonObject parsed = parseJsonObjectReplyData(replyData, &ok);
+    if (err == QNetworkReply::AuthenticationRequiredError
+            || (ok && parsed.value("error").toObject().value("error_code").toDouble() == 5)) {
+        // user authorization failed, the token may have been revoked.
+        invalidateAccessTokens(accountId);
+    }
     if (ok && parsed.contains(QLatin1String("error"))) {
         QJsonObject errorReply = parsed.value("error").toObject();
         // Password Changed on server side
@@ -304,24 +313,7 @@ void VKDataTypeSyncAdaptor::sslErrorsHandler(const QList<QSslError> &errs)
 
 QString VKDataTypeSyncAdaptor::clientId()
 {
-    if (!m_triedLoading) {
-        loadClientId();
-    }
-    return m_clientId;
-}
-
-void VKDataTypeSyncAdaptor::loadClientId()
-{
-    m_triedLoading = true;
-    char *cClientId = NULL;
-    int cSuccess = SailfishKeyProvider_storedKey("vk", "vk-sync", "client_id", &cClientId);
-    if (cSuccess != 0 || cClientId == NULL) {
-        return;
-    }
-
-    m_clientId = QLatin1String(cClientId);
-    free(cClientId);
-    return;
+    return KeyProviderCache::storedKey("vk", "vk-sync", "client_id");
 }
 
 void VKDataTypeSyncAdaptor::setCredentialsNeedUpdate(Accounts::Account *account)
@@ -340,35 +332,45 @@ void VKDataTypeSyncAdaptor::signIn(Accounts::Account *account)
     // Fetch clientId from keyprovider
     int accountId = account->id();
     if (!checkAccount(account) || clientId().isEmpty()) {
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    // grab out a valid identity for the sync service.
     Accounts::Service srv(m_accountManager->service(syncServiceName()));
     account->selectService(srv);
+    Accounts::AccountService accSrv(account, srv);
+    QString method = accSrv.authData().method();
+    QString mechanism = accSrv.authData().mechanism();
+    QVariantMap signonSessionData = accSrv.authData().parameters();
+    signonSessionData.insert("ClientId", clientId());
+    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
+
+    // another data type of the account may have signed in recently.
+    const QString tokenScope = accessTokenScope(mechanism, signonSessionData);
+    const QString cachedToken = cachedAccessToken(accountId, tokenScope);
+    if (!cachedToken.isEmpty()) {
+        QTimer::singleShot(0, account, [this, account, cachedToken] {
+            signedIn(account, cachedToken);
+        });
+        return;
+    }
+
+    // grab out a valid identity for the sync service.
     SignOn::Identity *identity = account->credentialsId() > 0 ? SignOn::Identity::existingIdentity(account->credentialsId()) : 0;
     if (!identity) {
         qCWarning(lcSocialPlugin) << "error: account has no valid credentials, cannot sign in:" << accountId;
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    Accounts::AccountService accSrv(account, srv);
-    QString method = accSrv.authData().method();
-    QString mechanism = accSrv.authData().mechanism();
     SignOn::AuthSession *session = identity->createSession(method);
     if (!session) {
         qCWarning(lcSocialPlugin) << "error: could not create signon session for account:" << accountId;
         identity->deleteLater();
-        decrementSemaphore(accountId);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
         return;
     }
 
-    QVariantMap signonSessionData = accSrv.authData().parameters();
-    signonSessionData.insert("ClientId", clientId());
-    signonSessionData.insert("UiPolicy", SignOn::NoUserInteractionPolicy);
-
     connect(session, &SignOn::AuthSession::response,
             this, &VKDataTypeSyncAdaptor::signOnResponse,
             Qt::UniqueConnection);
@@ -377,6 +379,7 @@ void VKDataTypeSyncAdaptor::signIn(Accounts::Account *account)
             Qt::UniqueConnection);
 
     session->setProperty("account", QVariant::fromValue<Accounts::Account*>(account));
+    session->setProperty("tokenScope", tokenScope);
     session->setProperty("identity", QVariant::fromValue<SignOn::Identity*>(identity));
     session->process(SignOn::SessionData(signonSessionData), mechanism);
 }
@@ -403,7 +406,7 @@ void VKDataTypeSyncAdaptor::signOnError(const SignOn::Error &error)
 
     // if we couldn't sign in, we can't sync with this account.
     setStatus(SocialNetworkSyncAdaptor::Error);
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
 
 void VKDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseData)
@@ -425,14 +428,24 @@ void VKDataTypeSyncAdaptor::signOnResponse(const SignOn::SessionData &responseDa
         qCInfo(lcSocialPlugin) << "signon response for account with id" << accountId << "contained no oauth token";
     }
 
+    cacheAccessToken(accountId, session->property("tokenScope").toString(), data);
+
     session->disconnect(this);
     identity->destroySession(session);
     identity->deleteLater();
+
+    signedIn(account, accessToken);
+}
+
+void VKDataTypeSyncAdaptor::signedIn(Accounts::Account *account, const QString &accessToken)
+{
+    int accountId = account->id();
+
     account->deleteLater();
 
     if (!accessToken.isEmpty()) {
         beginSync(accountId, accessToken); // call the derived-class sync entrypoint.
     }
 
-    decrementSemaphore(accountId);
+    decrementSemaphore(accountId, QStringLiteral("signIn"));
 }
@@ -20,59 +20,23 @@
  ****************************************************************************/
 
 #include "vknetworkaccessmanager_p.h"
+#include "sharedslotscheduler_p.h"
 #include "buteosyncfw_p.h"
 #include "trace.h"
 
-#include <QDateTime>
 #include <QString>
-#include <QObject>
-#include <QNetworkReply>
-
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <sys/time.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <utime.h>
+#include <QNetworkRequest>
 
 namespace {
-    bool touchTimestampFile()
+    // The VK processes (posts, images, contacts, calendars, notifications)
+    // may all sync at the same time, and share the request budget.
+    SharedSlotScheduler *requestSlots()
     {
-        static const QString timestampFileName = QString::fromLatin1("%1/%2/vktimestamp")
-                .arg(PRIVILEGED_DATA_DIR)
-                .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
-        QByteArray tsfnba = timestampFileName.toUtf8();
-
-        int fd = open(tsfnba.constData(), O_WRONLY|O_CREAT|O_NOCTTY|O_NONBLOCK, 0666);
-        if (fd < 0) {
-            return false;
-        }
-
-        int rv = utimensat(AT_FDCWD, tsfnba.constData(), 0, 0);
-        close(fd);
-        if (rv != 0) {
-            return false;
-        }
-
-        return true;
-    }
-
-    qint64 readTimestampFile()
-    {
-        static const QString timestampFileName = QString::fromLatin1("%1/%2/vktimestamp")
-                .arg(PRIVILEGED_DATA_DIR)
-                .arg(QString::fromLatin1(SYNC_DATABASE_DIR));
-        QByteArray tsfnba = timestampFileName.toUtf8();
-
-        struct stat buf;
-        if (stat(tsfnba.constData(), &buf) < 0) {
-            return 0;
-        }
-
-        time_t tvsec = buf.st_mtim.tv_sec;
-        long nanosec = buf.st_mtim.tv_nsec;
-        qint64 msecs = (tvsec*1000) + (nanosec/1000000);
-        return msecs;
+        static SharedSlotScheduler scheduler(QString::fromLatin1("%1/%2/vkrequestslots")
+                                                     .arg(PRIVILEGED_DATA_DIR)
+                                                     .arg(QString::fromLatin1(SYNC_DATABASE_DIR)),
+                                             VK_REQUEST_INTERVAL);
+        return &scheduler;
     }
 }
 
@@ -81,24 +45,19 @@ VKNetworkAccessManager::VKNetworkAccessManager(QObject *parent)
 {
 }
 
-QNetworkReply *VKNetworkAccessManager::createRequest(
-                                 QNetworkAccessManager::Operation op,
-                                 const QNetworkRequest &req,
-                                 QIODevice *outgoingData)
+qint64 VKNetworkAccessManager::requestDelay(QNetworkAccessManager::Operation op, const QNetworkRequest &req)
 {
-    // VK throttles requests.  We want to wait at least 550 ms between each request.
-    // To do this properly, we need to protect the file access with a semaphore
-    // or link-lock to prevent concurrent process access.  For now, we use the
-    // naive approach.
-
-    qint64 currTime = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch();
-    qint64 lastRequestTime = readTimestampFile();
-    qint64 delta = currTime - lastRequestTime;
-    if (lastRequestTime == 0 || delta > VK_THROTTLE_INTERVAL) {
-        touchTimestampFile();
-        return SocialdNetworkAccessManager::createRequest(op, req, outgoingData);
+    // VK throttles API requests.  Rather than rejecting requests which are
+    // sent too early, each request is given the next free send slot, and
+    // is delayed until then.
+    qint64 delay = SocialdNetworkAccessManager::requestDelay(op, req);
+    const QString host = req.url().host();
+    if (host == QLatin1String("vk.com") || host.endsWith(QLatin1String(".vk.com"))) {
+        const qint64 slot = requestSlots()->reserve();
+        if (slot > 0) {
+            qCDebug(lcSocialPlugin) << "Throttling request to" << host << "by" << slot << "msec";
+        }
+        delay = qMax(delay, slot);
     }
-
-    qCDebug(lcSocialPlugin) << "Throttling request! lastRequestTime:" << lastRequestTime << ", currTime:" << currTime << ", so delta:" << delta;
-    return 0; // tell the client to resubmit their request, it was throttled.
+    return delay;
 }
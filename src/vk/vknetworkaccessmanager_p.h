@@ -24,6 +24,7 @@
 
 #include "socialdnetworkaccessmanager_p.h"
 
+#define VK_REQUEST_INTERVAL 340 /* msec, VK allows 3 requests per second */
 #define VK_THROTTLE_INTERVAL 550 /* msec */
 #define VK_THROTTLE_EXTRA_INTERVAL 3000 /* msec */
 #define VK_THROTTLE_ERROR_CODE 6
@@ -37,9 +38,7 @@ public:
     VKNetworkAccessManager(QObject *parent = 0);
 
 protected:
-    QNetworkReply *createRequest(QNetworkAccessManager::Operation op,
-                                 const QNetworkRequest &req,
-                                 QIODevice *outgoingData = 0) override;
+    qint64 requestDelay(QNetworkAccessManager::Operation op, const QNetworkRequest &req) override;
 };
 
 #endif // SOCIALD_VK_QNAMFACTORY_P_H
@@ -0,0 +1,22 @@
+# Benchmarks which drive a sync adaptor end to end, from sync() until the
+# adaptor is inactive again, over synthetic fixtures replayed by
+# ReplayNetworkAccessManager.  Include this after common.pri and the .pri
+# files of the adaptor, which build the adaptor as a plugin.
+
+include($$PWD/benchmarks.pri)
+
+TEMPLATE = app
+CONFIG -= plugin
+
+# SyncResourceUsage interposes malloc() and write(), which the libraries
+# only resolve to the benchmark if it exports them.
+QMAKE_LFLAGS += -rdynamic
+LIBS += -ldl
+
+HEADERS += \
+    $$PWD/common/adaptorbenchmark.h \
+    $$PWD/common/syncresourceusage.h
+
+SOURCES += \
+    $$PWD/common/adaptorbenchmark.cpp \
+    $$PWD/common/syncresourceusage.cpp
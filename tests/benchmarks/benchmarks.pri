@@ -0,0 +1,27 @@
+# Benchmarks of the hot paths of the common sync plugin library.  They
+# use synthetic payloads of the given sizes, so they run without accounts
+# or network access.  Run them with e.g. -callgrind or -tickcounter for
+# measurements other than the wall time.
+
+TEMPLATE = app
+CONFIG += testcase
+
+QT += testlib network
+QT -= gui
+
+INCLUDEPATH += \
+    $$PWD/common \
+    $$PWD/../../src/common
+
+LIBS += -L$$OUT_PWD/../../../src/common -lsyncpluginscommon
+
+HEADERS += \
+    $$PWD/common/benchmarkfixtures.h \
+    $$PWD/common/benchmarkpayloads.h
+
+SOURCES += \
+    $$PWD/common/benchmarkfixtures.cpp \
+    $$PWD/common/benchmarkpayloads.cpp
+
+target.path = /opt/tests/buteo-sync-plugins-social/benchmarks
+INSTALLS += target
@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+SUBDIRS = \
+    jsonstreamreader \
+    syncreplay \
+    tracedump
+
+CONFIG(facebook): {
+    SUBDIRS += facebookimages
+}
+
+CONFIG(google): {
+    SUBDIRS += \
+        googlecalendars \
+        googlecontacts
+}
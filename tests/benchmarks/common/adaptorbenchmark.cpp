@@ -0,0 +1,74 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "adaptorbenchmark.h"
+#include "socialnetworksyncadaptor.h"
+#include "syncresourceusage.h"
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QTimer>
+
+namespace {
+    // generous, as the largest presets take minutes on a device.
+    const int SyncTimeout = 30 * 60 * 1000; // msec
+}
+
+namespace AdaptorBenchmark {
+
+void setUp(const QString &home)
+{
+    qputenv("HOME", QFile::encodeName(home));
+    qunsetenv("XDG_CACHE_HOME");
+    qunsetenv("XDG_CONFIG_HOME");
+    qunsetenv("XDG_DATA_HOME");
+
+    qputenv("SOCIALD_NETWORK_REPLAY_LATENCY", "0");
+    qunsetenv("SOCIALD_NETWORK_REPLAY_BANDWIDTH");
+    qunsetenv("SOCIALD_NETWORK_RECORD");
+}
+
+void replayFrom(const QString &fixtureRoot)
+{
+    qputenv("SOCIALD_NETWORK_REPLAY", QFile::encodeName(fixtureRoot));
+}
+
+bool sync(SocialNetworkSyncAdaptor *adaptor, const QString &dataType, int accountId,
+          SyncResourceUsage *usage)
+{
+    QEventLoop loop;
+    QObject::connect(adaptor, &SocialNetworkSyncAdaptor::statusChanged, &loop, [adaptor, &loop] {
+        if (adaptor->status() != SocialNetworkSyncAdaptor::Busy) {
+            loop.quit();
+        }
+    });
+    QTimer::singleShot(SyncTimeout, &loop, &QEventLoop::quit);
+
+    usage->start();
+    adaptor->sync(dataType, accountId);
+    if (adaptor->status() == SocialNetworkSyncAdaptor::Busy) {
+        loop.exec();
+    }
+    usage->stop();
+
+    return adaptor->status() == SocialNetworkSyncAdaptor::Inactive;
+}
+
+}
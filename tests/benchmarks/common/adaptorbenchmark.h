@@ -0,0 +1,53 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_ADAPTORBENCHMARK_H
+#define SOCIALD_ADAPTORBENCHMARK_H
+
+#include <QtCore/QString>
+
+class SocialNetworkSyncAdaptor;
+class SyncResourceUsage;
+
+/*
+    Runs a sync adaptor as its Buteo plugin would, but in a scratch home
+    directory and over fixtures replayed by ReplayNetworkAccessManager,
+    so that a sync can be measured from sync() until the adaptor is
+    inactive again without an account or network access.
+*/
+namespace AdaptorBenchmark {
+
+// Keeps the databases of the adaptors in home instead of the home of
+// the user, and replays the fixtures without latency.  Must be called
+// before any adaptor (or database) is constructed.
+void setUp(const QString &home);
+
+// Replays the fixtures below fixtureRoot to the adaptors constructed
+// from now on.
+void replayFrom(const QString &fixtureRoot);
+
+// Syncs the given data type of the account, measuring the run with
+// usage, and returns whether the sync finished without errors.
+bool sync(SocialNetworkSyncAdaptor *adaptor, const QString &dataType, int accountId,
+          SyncResourceUsage *usage);
+
+}
+
+#endif // SOCIALD_ADAPTORBENCHMARK_H
@@ -0,0 +1,58 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "benchmarkfixtures.h"
+#include "replaynetworkaccessmanager_p.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtNetwork/QNetworkRequest>
+
+namespace BenchmarkFixtures {
+
+bool writeGet(const ReplayNetworkAccessManager &manager, const QUrl &url,
+              const QByteArray &body, int occurrence)
+{
+    const QString key = ReplayNetworkAccessManager::fixtureKey(QNetworkAccessManager::GetOperation,
+                                                               QNetworkRequest(url));
+
+    QJsonObject fixture;
+    fixture.insert(QStringLiteral("method"), QStringLiteral("GET"));
+    fixture.insert(QStringLiteral("url"), QString::fromUtf8(SocialdNetworkAccessManager::withoutCredentials(url).toEncoded()));
+    fixture.insert(QStringLiteral("status"), 200);
+    fixture.insert(QStringLiteral("reason"), QStringLiteral("OK"));
+    fixture.insert(QStringLiteral("headers"), QJsonArray {
+        QJsonArray { QStringLiteral("Content-Type"), QStringLiteral("application/json; charset=UTF-8") },
+        QJsonArray { QStringLiteral("Content-Length"), QString::number(body.size()) }
+    });
+    fixture.insert(QStringLiteral("body"), QString::fromLatin1(body.toBase64()));
+    fixture.insert(QStringLiteral("error"), 0);
+    fixture.insert(QStringLiteral("headerLatency"), 0);
+
+    QFile file(manager.fixtureFileName(key, occurrence));
+    return QDir().mkpath(manager.fixtureDirectory())
+            && file.open(QIODevice::WriteOnly)
+            && file.write(QJsonDocument(fixture).toJson(QJsonDocument::Compact)) > 0;
+}
+
+}
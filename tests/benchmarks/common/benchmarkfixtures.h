@@ -0,0 +1,42 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_BENCHMARKFIXTURES_H
+#define SOCIALD_BENCHMARKFIXTURES_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QUrl>
+
+class ReplayNetworkAccessManager;
+
+/*
+    Writes fixtures as ReplayNetworkAccessManager records them, so that
+    synthetic payloads can be replayed to the sync adaptors.
+*/
+namespace BenchmarkFixtures {
+
+// Answers the occurrence'th GET of url with body, in the fixture
+// directory replayed by manager.
+bool writeGet(const ReplayNetworkAccessManager &manager, const QUrl &url,
+              const QByteArray &body, int occurrence = 0);
+
+}
+
+#endif // SOCIALD_BENCHMARKFIXTURES_H
@@ -0,0 +1,246 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "benchmarkpayloads.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace BenchmarkPayloads {
+
+QByteArray photoPage(int first, int count, const QString &next)
+{
+    QJsonArray data;
+    for (int i = first; i < first + count; ++i) {
+        const QString id = QString::number(100000000 + i);
+        QJsonArray images;
+        for (int size = 1; size <= 4; ++size) {
+            QJsonObject image;
+            image.insert(QStringLiteral("height"), 180 * size);
+            image.insert(QStringLiteral("width"), 320 * size);
+            image.insert(QStringLiteral("source"), QStringLiteral("https://scontent.xx.fbcdn.net/v/t1.0-9/%1_%2_n.jpg?oh=0123456789abcdef&oe=5F000000")
+                                                   .arg(id).arg(size));
+            images.append(image);
+        }
+        QJsonObject photo;
+        photo.insert(QStringLiteral("id"), id);
+        photo.insert(QStringLiteral("created_time"), QStringLiteral("2026-01-01T12:00:00+0000"));
+        photo.insert(QStringLiteral("updated_time"), QStringLiteral("2026-01-02T12:00:00+0000"));
+        photo.insert(QStringLiteral("name"), QStringLiteral("Photo %1 \"quoted\" \\ caption").arg(i));
+        photo.insert(QStringLiteral("width"), 1280);
+        photo.insert(QStringLiteral("height"), 720);
+        photo.insert(QStringLiteral("picture"), images.last().toObject().value(QStringLiteral("source")));
+        photo.insert(QStringLiteral("images"), images);
+        data.append(photo);
+    }
+
+    QJsonObject paging;
+    paging.insert(QStringLiteral("cursors"), QJsonObject {
+        { QStringLiteral("before"), QString::number(first) },
+        { QStringLiteral("after"), QString::number(first + count) }
+    });
+    if (!next.isEmpty()) {
+        paging.insert(QStringLiteral("next"), next);
+    }
+
+    QJsonObject page;
+    page.insert(QStringLiteral("data"), data);
+    page.insert(QStringLiteral("paging"), paging);
+    return QJsonDocument(page).toJson(QJsonDocument::Compact);
+}
+
+QByteArray albumsPage(const QString &userId, int albumCount, int photosPerAlbum)
+{
+    QJsonArray data;
+    for (int i = 0; i < albumCount; ++i) {
+        QJsonObject album;
+        album.insert(QStringLiteral("id"), QString::number(200000000 + i));
+        album.insert(QStringLiteral("from"), QJsonObject {
+            { QStringLiteral("id"), userId },
+            { QStringLiteral("name"), QStringLiteral("Benchmark User") }
+        });
+        album.insert(QStringLiteral("name"), QStringLiteral("Album %1").arg(i));
+        album.insert(QStringLiteral("created_time"), QStringLiteral("2026-01-01T12:00:00+0000"));
+        album.insert(QStringLiteral("updated_time"), QStringLiteral("2026-01-02T12:00:00+0000"));
+        album.insert(QStringLiteral("count"), photosPerAlbum);
+        data.append(album);
+    }
+
+    QJsonObject page;
+    page.insert(QStringLiteral("data"), data);
+    return QJsonDocument(page).toJson(QJsonDocument::Compact);
+}
+
+QByteArray user(const QString &userId)
+{
+    QJsonObject user;
+    user.insert(QStringLiteral("id"), userId);
+    user.insert(QStringLiteral("name"), QStringLiteral("Benchmark User"));
+    user.insert(QStringLiteral("updated_time"), QStringLiteral("2026-01-01T12:00:00+0000"));
+    user.insert(QStringLiteral("picture"), QJsonObject {
+        { QStringLiteral("data"), QJsonObject {
+            { QStringLiteral("url"), QStringLiteral("https://scontent.xx.fbcdn.net/v/t1.0-1/p50x50/%1_n.jpg").arg(userId) }
+        } }
+    });
+    return QJsonDocument(user).toJson(QJsonDocument::Compact);
+}
+
+QByteArray calendarListPage(const QString &calendarId)
+{
+    QJsonObject calendar;
+    calendar.insert(QStringLiteral("kind"), QStringLiteral("calendar#calendarListEntry"));
+    calendar.insert(QStringLiteral("id"), calendarId);
+    calendar.insert(QStringLiteral("summary"), QStringLiteral("Benchmark calendar"));
+    calendar.insert(QStringLiteral("description"), QStringLiteral("Events of the benchmark"));
+    calendar.insert(QStringLiteral("backgroundColor"), QStringLiteral("#9fe1e7"));
+    calendar.insert(QStringLiteral("accessRole"), QStringLiteral("owner"));
+
+    QJsonObject page;
+    page.insert(QStringLiteral("kind"), QStringLiteral("calendar#calendarList"));
+    page.insert(QStringLiteral("items"), QJsonArray { calendar });
+    page.insert(QStringLiteral("nextSyncToken"), QStringLiteral("CPDAlvWDx70CEPDAlvWDx70CGAU="));
+    return QJsonDocument(page).toJson(QJsonDocument::Indented);
+}
+
+QByteArray eventsPage(int count)
+{
+    return eventsPage(0, count, QString());
+}
+
+QByteArray eventsPage(int first, int count, const QString &nextPageToken)
+{
+    QJsonArray items;
+    for (int i = first; i < first + count; ++i) {
+        QJsonObject event;
+        event.insert(QStringLiteral("kind"), QStringLiteral("calendar#event"));
+        event.insert(QStringLiteral("etag"), QStringLiteral("\"3181159875584000\""));
+        event.insert(QStringLiteral("id"), QStringLiteral("event%1").arg(i));
+        event.insert(QStringLiteral("status"), QStringLiteral("confirmed"));
+        event.insert(QStringLiteral("summary"), QStringLiteral("Event %1").arg(i));
+        event.insert(QStringLiteral("description"), QStringLiteral("First line\nSecond line\nThird line"));
+        event.insert(QStringLiteral("start"), QJsonObject {
+            { QStringLiteral("dateTime"), QStringLiteral("2026-03-01T10:00:00+02:00") }
+        });
+        event.insert(QStringLiteral("end"), QJsonObject {
+            { QStringLiteral("dateTime"), QStringLiteral("2026-03-01T11:00:00+02:00") }
+        });
+        if (i % 10 == 0) {
+            event.insert(QStringLiteral("recurrence"), QJsonArray {
+                QStringLiteral("RRULE:FREQ=WEEKLY;BYDAY=MO,WE;UNTIL=20261231T000000Z")
+            });
+        }
+        items.append(event);
+    }
+
+    QJsonObject page;
+    page.insert(QStringLiteral("kind"), QStringLiteral("calendar#events"));
+    page.insert(QStringLiteral("summary"), QStringLiteral("Benchmark calendar"));
+    page.insert(QStringLiteral("items"), items);
+    if (nextPageToken.isEmpty()) {
+        page.insert(QStringLiteral("nextSyncToken"), QStringLiteral("CPDAlvWDx70CEPDAlvWDx70CGAU="));
+    } else {
+        page.insert(QStringLiteral("nextPageToken"), nextPageToken);
+    }
+    // Google pretty-prints its replies, which is what the trace dumps split into lines.
+    return QJsonDocument(page).toJson(QJsonDocument::Indented);
+}
+
+QByteArray contactGroupsPage(int memberCount)
+{
+    QJsonObject myContacts;
+    myContacts.insert(QStringLiteral("resourceName"), QStringLiteral("contactGroups/myContacts"));
+    myContacts.insert(QStringLiteral("etag"), QStringLiteral("QlRDUy1DHRM="));
+    myContacts.insert(QStringLiteral("groupType"), QStringLiteral("SYSTEM_CONTACT_GROUP"));
+    myContacts.insert(QStringLiteral("name"), QStringLiteral("myContacts"));
+    myContacts.insert(QStringLiteral("formattedName"), QStringLiteral("My Contacts"));
+    myContacts.insert(QStringLiteral("memberCount"), memberCount);
+
+    QJsonObject page;
+    page.insert(QStringLiteral("contactGroups"), QJsonArray { myContacts });
+    page.insert(QStringLiteral("totalItems"), 1);
+    page.insert(QStringLiteral("nextSyncToken"), QStringLiteral("EPi8o7jP9vYC"));
+    return QJsonDocument(page).toJson(QJsonDocument::Indented);
+}
+
+QByteArray connectionsPage(int first, int count, int totalPeople, const QString &nextPageToken)
+{
+    QJsonArray connections;
+    for (int i = first; i < first + count; ++i) {
+        const QString id = QStringLiteral("%1").arg(0x10000000 + i, 0, 16);
+        const QString etag = QStringLiteral("#%1=").arg(id);
+        const QJsonObject source {
+            { QStringLiteral("type"), QStringLiteral("CONTACT") },
+            { QStringLiteral("id"), id }
+        };
+        const QJsonObject fieldMetadata {
+            { QStringLiteral("primary"), true },
+            { QStringLiteral("source"), source }
+        };
+
+        QJsonObject person;
+        person.insert(QStringLiteral("resourceName"), QStringLiteral("people/c%1").arg(id));
+        person.insert(QStringLiteral("etag"), etag);
+        person.insert(QStringLiteral("metadata"), QJsonObject {
+            { QStringLiteral("sources"), QJsonArray { QJsonObject {
+                { QStringLiteral("type"), QStringLiteral("CONTACT") },
+                { QStringLiteral("id"), id },
+                { QStringLiteral("etag"), etag }
+            } } }
+        });
+        person.insert(QStringLiteral("names"), QJsonArray { QJsonObject {
+            { QStringLiteral("metadata"), fieldMetadata },
+            { QStringLiteral("givenName"), QStringLiteral("Given%1").arg(i) },
+            { QStringLiteral("familyName"), QStringLiteral("Family%1").arg(i % 1000) }
+        } });
+        person.insert(QStringLiteral("emailAddresses"), QJsonArray { QJsonObject {
+            { QStringLiteral("metadata"), fieldMetadata },
+            { QStringLiteral("value"), QStringLiteral("contact%1@example.com").arg(i) },
+            { QStringLiteral("type"), QStringLiteral("home") }
+        } });
+        person.insert(QStringLiteral("phoneNumbers"), QJsonArray { QJsonObject {
+            { QStringLiteral("metadata"), fieldMetadata },
+            { QStringLiteral("value"), QStringLiteral("+358 40 %1").arg(1000000 + i) },
+            { QStringLiteral("type"), QStringLiteral("mobile") }
+        } });
+        person.insert(QStringLiteral("memberships"), QJsonArray { QJsonObject {
+            { QStringLiteral("metadata"), QJsonObject {
+                { QStringLiteral("source"), source }
+            } },
+            { QStringLiteral("contactGroupMembership"), QJsonObject {
+                { QStringLiteral("contactGroupResourceName"), QStringLiteral("contactGroups/myContacts") }
+            } }
+        } });
+        connections.append(person);
+    }
+
+    QJsonObject page;
+    page.insert(QStringLiteral("connections"), connections);
+    page.insert(QStringLiteral("totalPeople"), QString::number(totalPeople));
+    page.insert(QStringLiteral("totalItems"), QString::number(totalPeople));
+    if (nextPageToken.isEmpty()) {
+        page.insert(QStringLiteral("nextSyncToken"), QStringLiteral("^CAESAggBGgIIAQ"));
+    } else {
+        page.insert(QStringLiteral("nextPageToken"), nextPageToken);
+    }
+    return QJsonDocument(page).toJson(QJsonDocument::Indented);
+}
+
+}
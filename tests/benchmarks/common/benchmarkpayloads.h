@@ -0,0 +1,68 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_BENCHMARKPAYLOADS_H
+#define SOCIALD_BENCHMARKPAYLOADS_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+/*
+    Synthetic API responses, shaped like the replies the adaptors parse,
+    so that the benchmarks don't depend on recorded fixtures of real
+    accounts.
+*/
+namespace BenchmarkPayloads {
+
+// A Facebook Graph API page of photos, with the photos numbered from
+// first, and a paging.next link if next isn't empty.
+QByteArray photoPage(int first, int count, const QString &next = QString());
+
+// A Facebook Graph API page of the albums of a user, each holding
+// photosPerAlbum photos.
+QByteArray albumsPage(const QString &userId, int albumCount, int photosPerAlbum);
+
+// A Facebook Graph API user.
+QByteArray user(const QString &userId);
+
+// A Google Calendar API page of calendars, as returned by calendarList.list,
+// with a calendar of the given id.
+QByteArray calendarListPage(const QString &calendarId);
+
+// A Google Calendar API page of events, as returned by events.list.
+QByteArray eventsPage(int count);
+
+// A page of events numbered from first, with a nextPageToken if
+// nextPageToken isn't empty, or else the nextSyncToken of the last page.
+QByteArray eventsPage(int first, int count, const QString &nextPageToken);
+
+// A Google People API page of contact groups, as returned by
+// contactGroups.list, with the My Contacts group of memberCount contacts.
+QByteArray contactGroupsPage(int memberCount);
+
+// A Google People API page of contacts, as returned by
+// people.connections.list, with the contacts numbered from first, and a
+// nextPageToken if nextPageToken isn't empty, or else the nextSyncToken
+// of the last page.
+QByteArray connectionsPage(int first, int count, int totalPeople, const QString &nextPageToken);
+
+}
+
+#endif // SOCIALD_BENCHMARKPAYLOADS_H
@@ -0,0 +1,225 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "syncresourceusage.h"
+#include "memoryusagemonitor_p.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+    QAtomicInteger<qint64> allocationCount;
+    QAtomicInteger<qint64> databaseWriteCount;
+    QAtomicInteger<qint64> databaseWriteBytes;
+
+    // only set while a run is measured, so that the writes of the
+    // setup don't pay for the lookup of their file names.
+    QAtomicInt countingWrites;
+    char databaseDirectory[PATH_MAX];
+    size_t databaseDirectoryLength = 0;
+
+    void countWrite(int fd, ssize_t written)
+    {
+        if (written <= 0 || !countingWrites.loadAcquire()) {
+            return;
+        }
+
+        char link[32];
+        char path[PATH_MAX];
+        snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+        const ssize_t length = readlink(link, path, sizeof(path));
+        if (length > ssize_t(databaseDirectoryLength)
+                && strncmp(path, databaseDirectory, databaseDirectoryLength) == 0
+                && path[databaseDirectoryLength] == '/') {
+            databaseWriteCount.fetchAndAddRelaxed(1);
+            databaseWriteBytes.fetchAndAddRelaxed(written);
+        }
+    }
+
+    template<typename Function>
+    Function nextFunction(const char *name)
+    {
+        return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+    }
+
+    qint64 processCpuMsecs()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return -1;
+        }
+        return (qint64(usage.ru_utime.tv_sec) + qint64(usage.ru_stime.tv_sec)) * 1000
+                + (qint64(usage.ru_utime.tv_usec) + qint64(usage.ru_stime.tv_usec)) / 1000;
+    }
+
+    QString mebibytes(qint64 bytes)
+    {
+        return bytes < 0 ? QStringLiteral("n/a") : QStringLiteral("%1 MiB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+
+    QString count(qint64 value)
+    {
+        return value < 0 ? QStringLiteral("n/a") : QString::number(value);
+    }
+}
+
+extern "C" {
+
+#if defined(__GLIBC__)
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) __THROW
+{
+    allocationCount.fetchAndAddRelaxed(1);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) __THROW
+{
+    allocationCount.fetchAndAddRelaxed(1);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) __THROW
+{
+    allocationCount.fetchAndAddRelaxed(1);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+ssize_t write(int fd, const void *buf, size_t count)
+{
+    static ssize_t (*const libcWrite)(int, const void *, size_t)
+            = nextFunction<ssize_t (*)(int, const void *, size_t)>("write");
+    const ssize_t written = libcWrite(fd, buf, count);
+    countWrite(fd, written);
+    return written;
+}
+
+#if !defined(__USE_FILE_OFFSET64)
+// otherwise pwrite() is an alias of pwrite64() in this build.
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset)
+{
+    static ssize_t (*const libcPwrite)(int, const void *, size_t, off_t)
+            = nextFunction<ssize_t (*)(int, const void *, size_t, off_t)>("pwrite");
+    const ssize_t written = libcPwrite(fd, buf, count, offset);
+    countWrite(fd, written);
+    return written;
+}
+#endif
+
+ssize_t pwrite64(int fd, const void *buf, size_t count, off64_t offset)
+{
+    static ssize_t (*const libcPwrite64)(int, const void *, size_t, off64_t)
+            = nextFunction<ssize_t (*)(int, const void *, size_t, off64_t)>("pwrite64");
+    const ssize_t written = libcPwrite64(fd, buf, count, offset);
+    countWrite(fd, written);
+    return written;
+}
+
+}
+
+SyncResourceUsage::SyncResourceUsage(const QString &databaseDirectory)
+    : m_databaseDirectory(databaseDirectory)
+    , m_cpuMsecs(-1)
+    , m_peakResidentBytes(-1)
+    , m_allocations(-1)
+    , m_databaseWrites(-1)
+    , m_databaseBytesWritten(-1)
+{
+}
+
+void SyncResourceUsage::start()
+{
+    const QByteArray directory = QFile::encodeName(m_databaseDirectory);
+    databaseDirectoryLength = qMin(size_t(directory.size()), sizeof(databaseDirectory) - 1);
+    memcpy(databaseDirectory, directory.constData(), databaseDirectoryLength);
+    databaseDirectory[databaseDirectoryLength] = '\0';
+
+    // resets the kernel high water mark of the resident set size (Linux 4.0+).
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+
+    m_cpuMsecs = processCpuMsecs();
+    m_allocations = allocationCount.loadAcquire();
+    m_databaseWrites = databaseWriteCount.loadAcquire();
+    m_databaseBytesWritten = databaseWriteBytes.loadAcquire();
+    countingWrites.storeRelease(1);
+}
+
+void SyncResourceUsage::stop()
+{
+    countingWrites.storeRelease(0);
+    const qint64 cpu = processCpuMsecs();
+    m_cpuMsecs = cpu < 0 || m_cpuMsecs < 0 ? -1 : cpu - m_cpuMsecs;
+    m_peakResidentBytes = MemoryUsageMonitor::peakResidentBytes();
+#if defined(__GLIBC__)
+    m_allocations = allocationCount.loadAcquire() - m_allocations;
+#else
+    m_allocations = -1;
+#endif
+    m_databaseWrites = databaseWriteCount.loadAcquire() - m_databaseWrites;
+    m_databaseBytesWritten = databaseWriteBytes.loadAcquire() - m_databaseBytesWritten;
+}
+
+qint64 SyncResourceUsage::cpuMsecs() const
+{
+    return m_cpuMsecs;
+}
+
+qint64 SyncResourceUsage::peakResidentBytes() const
+{
+    return m_peakResidentBytes;
+}
+
+qint64 SyncResourceUsage::allocations() const
+{
+    return m_allocations;
+}
+
+qint64 SyncResourceUsage::databaseWrites() const
+{
+    return m_databaseWrites;
+}
+
+qint64 SyncResourceUsage::databaseBytesWritten() const
+{
+    return m_databaseBytesWritten;
+}
+
+void SyncResourceUsage::report(const QString &name) const
+{
+    qInfo().noquote() << QStringLiteral("%1: %2 ms CPU, %3 peak RSS, %4 allocations, %5 database writes (%6)")
+                         .arg(name, count(m_cpuMsecs), mebibytes(m_peakResidentBytes), count(m_allocations),
+                              count(m_databaseWrites), mebibytes(m_databaseBytesWritten));
+}
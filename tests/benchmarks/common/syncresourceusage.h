@@ -0,0 +1,66 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#ifndef SOCIALD_SYNCRESOURCEUSAGE_H
+#define SOCIALD_SYNCRESOURCEUSAGE_H
+
+#include <QtCore/QString>
+
+/*
+    Measures the resources used by a sync run, in addition to the wall
+    time measured by QBENCHMARK: the CPU time of all the threads of the
+    process, the peak resident set size, the heap allocations, and the
+    writes to the databases.
+
+    Allocations are counted by interposing malloc(), calloc() and
+    realloc() of glibc, and database writes by interposing write(),
+    pwrite() and pwrite64() and counting the writes to the files below
+    the database directory, i.e. to the databases of the adaptors and of
+    sociald, their journals, and the small sync state files kept next
+    to them.  The benchmark has to be linked with -rdynamic, so that the
+    libraries resolve these functions to the benchmark.
+*/
+class SyncResourceUsage
+{
+public:
+    explicit SyncResourceUsage(const QString &databaseDirectory);
+
+    void start();
+    void stop();
+
+    // the figures of the last run, or -1 if unavailable.
+    qint64 cpuMsecs() const;
+    qint64 peakResidentBytes() const;
+    qint64 allocations() const;
+    qint64 databaseWrites() const;
+    qint64 databaseBytesWritten() const;
+
+    void report(const QString &name) const;
+
+private:
+    QString m_databaseDirectory;
+    qint64 m_cpuMsecs;
+    qint64 m_peakResidentBytes;
+    qint64 m_allocations;
+    qint64 m_databaseWrites;
+    qint64 m_databaseBytesWritten;
+};
+
+#endif // SOCIALD_SYNCRESOURCEUSAGE_H
@@ -0,0 +1,10 @@
+TARGET = tst_facebookimages
+
+include($$PWD/../../../src/common.pri)
+include($$PWD/../../../src/facebook/facebook-common.pri)
+include($$PWD/../../../src/facebook/facebook-images/facebook-images.pri)
+include($$PWD/../adaptorbenchmarks.pri)
+
+PKGCONFIG += mlite5
+
+SOURCES += tst_facebookimages.cpp
@@ -0,0 +1,187 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "adaptorbenchmark.h"
+#include "benchmarkfixtures.h"
+#include "benchmarkpayloads.h"
+#include "buteosyncfw_p.h"
+#include "facebookimagesyncadaptor.h"
+#include "keyprovidercache_p.h"
+#include "replaynetworkaccessmanager_p.h"
+#include "syncresourceusage.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+namespace {
+    const QString GraphAPI = QStringLiteral("https://graph.facebook.com");
+    const QString AccessToken = QStringLiteral("benchmark-token");
+    const int AccountId = 1;
+    const QString UserId = QStringLiteral("100000000000001");
+    const QString AlbumFields = QStringLiteral("id,from,name,created_time,updated_time,count");
+    const QString PhotoFields = QStringLiteral("id,picture,source,images,width,height,created_time,updated_time,name");
+    const int PhotosPerAlbum = 5000; // the presets are multiples of this
+    const int PageSize = 2000; // as requested by the adaptor
+
+    // the urls as the adaptor requests them, see FacebookImageSyncAdaptor::requestData().
+    QUrl graphUrl(const QString &path, const QList<QPair<QString, QString> > &queryItems)
+    {
+        QUrl url(GraphAPI + path);
+        QUrlQuery query(url);
+        query.addQueryItem(QStringLiteral("access_token"), AccessToken);
+        for (int i = 0; i < queryItems.size(); ++i) {
+            query.addQueryItem(queryItems.at(i).first, queryItems.at(i).second);
+        }
+        url.setQuery(query);
+        return url;
+    }
+
+    QUrl photosUrl(const QString &albumId, int after)
+    {
+        QList<QPair<QString, QString> > queryItems;
+        queryItems.append(qMakePair(QStringLiteral("limit"), QString::number(PageSize)));
+        queryItems.append(qMakePair(QStringLiteral("fields"), PhotoFields));
+        if (after > 0) {
+            queryItems.append(qMakePair(QStringLiteral("after"), QString::number(after)));
+        }
+        return graphUrl(QStringLiteral("/%1/photos").arg(albumId), queryItems);
+    }
+}
+
+// The benchmark runs without the key store of the device, whose client
+// id FacebookDataTypeSyncAdaptor::sync() requires.
+QString KeyProviderCache::storedKey(const char *, const char *, const char *)
+{
+    return QStringLiteral("benchmark-client-id");
+}
+
+/*
+    The Facebook images adaptor, signed in to an account which only
+    exists in the fixtures.
+*/
+class BenchmarkImageSyncAdaptor : public FacebookImageSyncAdaptor
+{
+public:
+    BenchmarkImageSyncAdaptor()
+        : FacebookImageSyncAdaptor(0)
+    {
+        setAccountSyncProfile(new Buteo::SyncProfile(QStringLiteral("facebook.Images.benchmark")));
+    }
+
+protected:
+    // skips the account lookup and the sign in, which need libaccounts
+    // and signond.
+    void updateDataForAccount(int accountId) override
+    {
+        setGraphAPI(GraphAPI);
+        // the fixtures aren't throttled, and the pacing would only add
+        // idle time to the measurement.
+        setRequestRateLimit(QUrl(GraphAPI).host(), 0, 0);
+
+        incrementSemaphore(accountId, QStringLiteral("signIn"));
+        beginSync(accountId, AccessToken);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
+    }
+};
+
+/*
+    Measures a first sync of the Facebook images adaptor: the album
+    listing, the paged photo listings of the albums, and the photos
+    saved to the images database.
+*/
+class tst_FacebookImages : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void images_data();
+    void images();
+
+private:
+    QTemporaryDir m_home;
+    QTemporaryDir m_fixtures;
+};
+
+void tst_FacebookImages::initTestCase()
+{
+    QVERIFY(m_home.isValid());
+    QVERIFY(m_fixtures.isValid());
+    AdaptorBenchmark::setUp(m_home.path());
+}
+
+void tst_FacebookImages::images_data()
+{
+    QTest::addColumn<int>("photoCount");
+
+    QTest::newRow("20k photos") << 20000;
+}
+
+void tst_FacebookImages::images()
+{
+    QFETCH(int, photoCount);
+
+    const QString fixtureRoot = QStringLiteral("%1/%2").arg(m_fixtures.path()).arg(photoCount);
+    AdaptorBenchmark::replayFrom(fixtureRoot);
+
+    const int albumCount = photoCount / PhotosPerAlbum;
+    {
+        const ReplayNetworkAccessManager manager(QStringLiteral("facebook.%1")
+                .arg(SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Images)));
+        QVERIFY(BenchmarkFixtures::writeGet(manager,
+                graphUrl(QStringLiteral("/me/albums"), QList<QPair<QString, QString> >()
+                         << qMakePair(QStringLiteral("limit"), QString::number(PageSize))
+                         << qMakePair(QStringLiteral("fields"), AlbumFields)),
+                BenchmarkPayloads::albumsPage(UserId, albumCount, PhotosPerAlbum)));
+        QVERIFY(BenchmarkFixtures::writeGet(manager,
+                graphUrl(QStringLiteral("/me"), QList<QPair<QString, QString> >()
+                         << qMakePair(QStringLiteral("fields"), QStringLiteral("id,updated_time,name,picture"))),
+                BenchmarkPayloads::user(UserId)));
+        for (int album = 0; album < albumCount; ++album) {
+            // as numbered by BenchmarkPayloads::albumsPage().
+            const QString albumId = QString::number(200000000 + album);
+            for (int first = 0; first < PhotosPerAlbum; first += PageSize) {
+                const int count = qMin(PageSize, PhotosPerAlbum - first);
+                const QString next = first + count < PhotosPerAlbum
+                        ? QString::fromUtf8(photosUrl(albumId, first + count).toEncoded())
+                        : QString();
+                QVERIFY(BenchmarkFixtures::writeGet(manager, photosUrl(albumId, first),
+                        BenchmarkPayloads::photoPage(album * PhotosPerAlbum + first, count, next)));
+            }
+        }
+    }
+
+    BenchmarkImageSyncAdaptor adaptor;
+    SyncResourceUsage usage(PRIVILEGED_DATA_DIR);
+    bool synced = false;
+    QBENCHMARK_ONCE {
+        synced = AdaptorBenchmark::sync(&adaptor, SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Images),
+                                        AccountId, &usage);
+    }
+    QVERIFY(synced);
+    QVERIFY(usage.databaseWrites() > 0);
+    usage.report(QString::fromLatin1(QTest::currentDataTag()));
+}
+
+QTEST_GUILESS_MAIN(tst_FacebookImages)
+
+#include "tst_facebookimages.moc"
@@ -0,0 +1,8 @@
+TARGET = tst_googlecalendars
+
+include($$PWD/../../../src/common.pri)
+include($$PWD/../../../src/google/google-common.pri)
+include($$PWD/../../../src/google/google-calendars/google-calendars.pri)
+include($$PWD/../adaptorbenchmarks.pri)
+
+SOURCES += tst_googlecalendars.cpp
@@ -0,0 +1,155 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "adaptorbenchmark.h"
+#include "benchmarkfixtures.h"
+#include "benchmarkpayloads.h"
+#include "buteosyncfw_p.h"
+#include "googlecalendarsyncadaptor.h"
+#include "replaynetworkaccessmanager_p.h"
+#include "syncresourceusage.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+namespace {
+    const QString AccessToken = QStringLiteral("benchmark-token");
+    const int AccountId = 1;
+    const QString CalendarId = QStringLiteral("benchmark@group.calendar.google.com");
+    const int PageSize = 250; // the default of events.list
+
+    // the urls as the adaptor requests them, see GoogleCalendarSyncAdaptor::requestEvents().
+    // The time window of a clean sync isn't part of the fixture key, so it's left out.
+    QUrl eventsUrl(const QString &pageToken)
+    {
+        QUrl url(QString::fromLatin1("https://www.googleapis.com/calendar/v3/calendars/%1/events")
+                 .arg(QString::fromUtf8(QUrl::toPercentEncoding(CalendarId))));
+        QUrlQuery query(url);
+        query.addQueryItem(QStringLiteral("eventTypes"), QStringLiteral("default"));
+        if (!pageToken.isEmpty()) {
+            query.addQueryItem(QStringLiteral("pageToken"), pageToken);
+        }
+        url.setQuery(query);
+        return url;
+    }
+
+    QString pageToken(int first)
+    {
+        return first > 0 ? QStringLiteral("page%1").arg(first) : QString();
+    }
+}
+
+/*
+    The Google calendars adaptor, signed in to an account which only
+    exists in the fixtures.
+*/
+class BenchmarkCalendarSyncAdaptor : public GoogleCalendarSyncAdaptor
+{
+public:
+    BenchmarkCalendarSyncAdaptor()
+        : GoogleCalendarSyncAdaptor(0)
+    {
+        setAccountSyncProfile(new Buteo::SyncProfile(QStringLiteral("google.Calendars.benchmark")));
+        // the fixtures aren't throttled, and the pacing would only add
+        // idle time to the measurement.
+        setRequestRateLimit(QStringLiteral("googleapis.com"), 0, 0);
+    }
+
+protected:
+    // skips the account lookup and the sign in, which need libaccounts
+    // and signond.
+    void updateDataForAccount(int accountId) override
+    {
+        incrementSemaphore(accountId, QStringLiteral("signIn"));
+        beginSync(accountId, AccessToken);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
+    }
+};
+
+/*
+    Measures a first sync of the Google calendars adaptor: the calendar
+    listing, the paged event listing, and the events saved to the mkcal
+    database when the sync finishes.
+*/
+class tst_GoogleCalendars : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void events_data();
+    void events();
+
+private:
+    QTemporaryDir m_home;
+    QTemporaryDir m_fixtures;
+};
+
+void tst_GoogleCalendars::initTestCase()
+{
+    QVERIFY(m_home.isValid());
+    QVERIFY(m_fixtures.isValid());
+    AdaptorBenchmark::setUp(m_home.path());
+}
+
+void tst_GoogleCalendars::events_data()
+{
+    QTest::addColumn<int>("eventCount");
+
+    QTest::newRow("100k events") << 100000;
+}
+
+void tst_GoogleCalendars::events()
+{
+    QFETCH(int, eventCount);
+
+    const QString fixtureRoot = QStringLiteral("%1/%2").arg(m_fixtures.path()).arg(eventCount);
+    AdaptorBenchmark::replayFrom(fixtureRoot);
+    {
+        const ReplayNetworkAccessManager manager(QStringLiteral("google.%1")
+                .arg(SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Calendars)));
+        QVERIFY(BenchmarkFixtures::writeGet(manager,
+                QUrl(QStringLiteral("https://www.googleapis.com/calendar/v3/users/me/calendarList")),
+                BenchmarkPayloads::calendarListPage(CalendarId)));
+        for (int first = 0; first < eventCount; first += PageSize) {
+            const int count = qMin(PageSize, eventCount - first);
+            const QString next = first + count < eventCount ? pageToken(first + count) : QString();
+            QVERIFY(BenchmarkFixtures::writeGet(manager, eventsUrl(pageToken(first)),
+                                                BenchmarkPayloads::eventsPage(first, count, next)));
+        }
+    }
+
+    BenchmarkCalendarSyncAdaptor adaptor;
+    SyncResourceUsage usage(PRIVILEGED_DATA_DIR);
+    bool synced = false;
+    QBENCHMARK_ONCE {
+        synced = AdaptorBenchmark::sync(&adaptor, SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Calendars),
+                                        AccountId, &usage);
+    }
+    QVERIFY(synced);
+    QVERIFY(usage.databaseWrites() > 0);
+    usage.report(QString::fromLatin1(QTest::currentDataTag()));
+}
+
+QTEST_GUILESS_MAIN(tst_GoogleCalendars)
+
+#include "tst_googlecalendars.moc"
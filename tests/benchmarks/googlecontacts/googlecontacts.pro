@@ -0,0 +1,12 @@
+TARGET = tst_googlecontacts
+
+DEFINES += SOCIALD_USE_QTPIM
+include($$PWD/../../../src/common.pri)
+include($$PWD/../../../src/google/google-common.pri)
+include($$PWD/../../../src/google/google-contacts/google-contacts.pri)
+include($$PWD/../adaptorbenchmarks.pri)
+
+# the contacts adaptor needs QtGui, which benchmarks.pri leaves out.
+QT += gui
+
+SOURCES += tst_googlecontacts.cpp
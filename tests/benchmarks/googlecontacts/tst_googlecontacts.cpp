@@ -0,0 +1,171 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "adaptorbenchmark.h"
+#include "benchmarkfixtures.h"
+#include "benchmarkpayloads.h"
+#include "buteosyncfw_p.h"
+#include "googlepeoplejson.h"
+#include "googletwowaycontactsyncadaptor.h"
+#include "replaynetworkaccessmanager_p.h"
+#include "syncresourceusage.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+namespace {
+    const QString AccessToken = QStringLiteral("benchmark-token");
+    const int PageSize = 100; // the default of people.connections.list
+
+    // the urls as the adaptor requests them, see GoogleTwoWayContactSyncAdaptor::requestData().
+    QUrl connectionsUrl(const QString &pageToken)
+    {
+        QUrl url(QStringLiteral("https://people.googleapis.com/v1/people/me/connections"));
+        QUrlQuery query;
+        query.addQueryItem(QStringLiteral("requestSyncToken"), QStringLiteral("true"));
+        query.addQueryItem(QStringLiteral("personFields"),
+                           GooglePeople::Person::supportedPersonFields().join(','));
+        if (!pageToken.isEmpty()) {
+            query.addQueryItem(QStringLiteral("pageToken"), pageToken);
+        }
+        url.setQuery(query);
+        return url;
+    }
+
+    QString pageToken(int first)
+    {
+        return first > 0 ? QStringLiteral("page%1").arg(first) : QString();
+    }
+}
+
+/*
+    The Google contacts adaptor, signed in to an account which only
+    exists in the fixtures.
+*/
+class BenchmarkContactSyncAdaptor : public GoogleTwoWayContactSyncAdaptor
+{
+public:
+    BenchmarkContactSyncAdaptor()
+        : GoogleTwoWayContactSyncAdaptor(0)
+    {
+        setAccountSyncProfile(new Buteo::SyncProfile(QStringLiteral("google.Contacts.benchmark")));
+        // the fixtures aren't throttled, and the pacing would only add
+        // idle time to the measurement.
+        setRequestRateLimit(QStringLiteral("googleapis.com"), 0, 0);
+    }
+
+protected:
+    // skips the account lookup and the sign in, which need libaccounts
+    // and signond.
+    void updateDataForAccount(int accountId) override
+    {
+        incrementSemaphore(accountId, QStringLiteral("signIn"));
+        beginSync(accountId, AccessToken);
+        decrementSemaphore(accountId, QStringLiteral("signIn"));
+    }
+
+    // the account isn't known to libaccounts, so the cleanup would purge
+    // the contacts just synced as those of a removed account.
+    void finalCleanup() override
+    {
+    }
+};
+
+/*
+    Measures a first sync of the Google contacts adaptor: the contact
+    group listing, the paged contact listing, and the contacts saved to
+    the qtcontacts-sqlite database.
+*/
+class tst_GoogleContacts : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void contacts_data();
+    void contacts();
+
+private:
+    QTemporaryDir m_home;
+    QTemporaryDir m_fixtures;
+};
+
+void tst_GoogleContacts::initTestCase()
+{
+    QVERIFY(m_home.isValid());
+    QVERIFY(m_fixtures.isValid());
+    AdaptorBenchmark::setUp(m_home.path());
+}
+
+void tst_GoogleContacts::contacts_data()
+{
+    QTest::addColumn<int>("accountId");
+    QTest::addColumn<int>("contactCount");
+
+    // each preset syncs an account of its own.
+    QTest::newRow("1k contacts") << 1 << 1000;
+    QTest::newRow("10k contacts") << 2 << 10000;
+    QTest::newRow("50k contacts") << 3 << 50000;
+}
+
+void tst_GoogleContacts::contacts()
+{
+    QFETCH(int, accountId);
+    QFETCH(int, contactCount);
+
+    // the fixture directory of the adaptor doesn't depend on the preset,
+    // so each preset is replayed from a root of its own.
+    const QString fixtureRoot = QStringLiteral("%1/%2").arg(m_fixtures.path()).arg(contactCount);
+    AdaptorBenchmark::replayFrom(fixtureRoot);
+    {
+        const ReplayNetworkAccessManager manager(QStringLiteral("google.%1")
+                .arg(SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Contacts)));
+        QVERIFY(BenchmarkFixtures::writeGet(manager,
+                QUrl(QStringLiteral("https://people.googleapis.com/v1/contactGroups")),
+                BenchmarkPayloads::contactGroupsPage(contactCount)));
+        for (int first = 0; first < contactCount; first += PageSize) {
+            const int count = qMin(PageSize, contactCount - first);
+            const QString next = first + count < contactCount ? pageToken(first + count) : QString();
+            QVERIFY(BenchmarkFixtures::writeGet(manager, connectionsUrl(pageToken(first)),
+                    BenchmarkPayloads::connectionsPage(first, count, contactCount, next)));
+        }
+    }
+
+    BenchmarkContactSyncAdaptor adaptor;
+    SyncResourceUsage usage(PRIVILEGED_DATA_DIR);
+    bool synced = false;
+    QBENCHMARK_ONCE {
+        synced = AdaptorBenchmark::sync(&adaptor, SocialNetworkSyncAdaptor::dataTypeName(SocialNetworkSyncAdaptor::Contacts),
+                                        accountId, &usage);
+    }
+    QVERIFY(synced);
+    QVERIFY(usage.databaseWrites() > 0);
+    usage.report(QString::fromLatin1(QTest::currentDataTag()));
+
+    // so that the next preset starts from an empty database again.  The
+    // adaptor only exposes the purge through its base, as to the plugin.
+    static_cast<SocialNetworkSyncAdaptor *>(&adaptor)->purgeDataForOldAccount(accountId);
+}
+
+QTEST_GUILESS_MAIN(tst_GoogleContacts)
+
+#include "tst_googlecontacts.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_jsonstreamreader
+
+include($$PWD/../benchmarks.pri)
+
+SOURCES += tst_jsonstreamreader.cpp
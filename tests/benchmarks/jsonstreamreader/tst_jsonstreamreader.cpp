@@ -0,0 +1,117 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "benchmarkpayloads.h"
+#include "jsonstreamreader_p.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QtTest>
+
+/*
+    Compares parsing a page of photos into a whole QJsonDocument, as the
+    replies were parsed before JsonStreamReader, with streaming the items
+    of its "data" array, both from the whole reply and from the chunks in
+    which it arrives from the network.
+*/
+class tst_JsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void document_data();
+    void document();
+    void streamed_data();
+    void streamed();
+
+private:
+    void addPages();
+};
+
+void tst_JsonStreamReader::addPages()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<int>("chunkSize");
+
+    // the chunk size is that of a typical readyRead(), 0 for the whole reply.
+    const int counts[] = { 100, 2000, 10000 };
+    for (int count : counts) {
+        const QByteArray payload = BenchmarkPayloads::photoPage(0, count);
+        QTest::newRow(qPrintable(QStringLiteral("%1 photos").arg(count))) << payload << 0;
+        QTest::newRow(qPrintable(QStringLiteral("%1 photos, chunked").arg(count))) << payload << 16 * 1024;
+    }
+}
+
+void tst_JsonStreamReader::document_data()
+{
+    addPages();
+}
+
+void tst_JsonStreamReader::document()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(int, chunkSize);
+
+    int items = 0;
+    QBENCHMARK {
+        // the reply has to be buffered in full before it can be parsed.
+        QByteArray replyData;
+        for (int offset = 0; offset < payload.size(); offset += chunkSize > 0 ? chunkSize : payload.size()) {
+            replyData.append(payload.mid(offset, chunkSize > 0 ? chunkSize : -1));
+        }
+        const QJsonObject parsed = QJsonDocument::fromJson(replyData).object();
+        items = 0;
+        Q_FOREACH (const QJsonValue &item, parsed.value(QStringLiteral("data")).toArray()) {
+            items += item.toObject().isEmpty() ? 0 : 1;
+        }
+    }
+    QVERIFY(items > 0);
+}
+
+void tst_JsonStreamReader::streamed_data()
+{
+    addPages();
+}
+
+void tst_JsonStreamReader::streamed()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(int, chunkSize);
+
+    int items = 0;
+    QBENCHMARK {
+        JsonStreamReader reader(QStringList() << QStringLiteral("data"), false);
+        items = 0;
+        for (int offset = 0; offset < payload.size(); offset += chunkSize > 0 ? chunkSize : payload.size()) {
+            reader.addData(payload.mid(offset, chunkSize > 0 ? chunkSize : -1));
+            while (reader.readNext()) {
+                items += reader.item().toObject().isEmpty() ? 0 : 1;
+            }
+        }
+        QVERIFY(reader.finish());
+        QVERIFY(reader.envelope().object().contains(QStringLiteral("paging")));
+    }
+    QVERIFY(items > 0);
+}
+
+QTEST_GUILESS_MAIN(tst_JsonStreamReader)
+
+#include "tst_jsonstreamreader.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_syncreplay
+
+include($$PWD/../benchmarks.pri)
+
+SOURCES += tst_syncreplay.cpp
@@ -0,0 +1,152 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "benchmarkfixtures.h"
+#include "benchmarkpayloads.h"
+#include "jsonstreamreader_p.h"
+#include "replaynetworkaccessmanager_p.h"
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtNetwork/QNetworkReply>
+#include <QtTest/QtTest>
+
+namespace {
+    const int PageSize = 500;
+
+    QUrl pageUrl(int first)
+    {
+        QUrl url(QStringLiteral("https://graph.facebook.com/v2.6/me/photos"));
+        url.setQuery(QStringLiteral("fields=id,created_time,updated_time,name,width,height,picture,images&limit=%1&after=%2")
+                     .arg(PageSize).arg(first));
+        return url;
+    }
+}
+
+/*
+    Replays the paged download of a photo library through
+    ReplayNetworkAccessManager, as the Facebook images adaptor performs
+    it: each page is streamed through JsonStreamReader as it arrives, and
+    the next page is requested when it has finished.  The fixtures are
+    generated for the synthetic library sizes, and replayed without
+    latency, so that the benchmark measures the client side of the sync.
+*/
+class tst_SyncReplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void photos_data();
+    void photos();
+
+private:
+    QString fixtureName(int photoCount) const;
+
+    QTemporaryDir m_fixtures;
+};
+
+QString tst_SyncReplay::fixtureName(int photoCount) const
+{
+    return QStringLiteral("photos-%1").arg(photoCount);
+}
+
+void tst_SyncReplay::initTestCase()
+{
+    QVERIFY(m_fixtures.isValid());
+    qputenv("SOCIALD_NETWORK_REPLAY", QFile::encodeName(m_fixtures.path()));
+    qputenv("SOCIALD_NETWORK_REPLAY_LATENCY", "0");
+    qunsetenv("SOCIALD_NETWORK_REPLAY_BANDWIDTH");
+
+    const int photoCounts[] = { 1000, 20000 };
+    for (int photoCount : photoCounts) {
+        const ReplayNetworkAccessManager manager(fixtureName(photoCount));
+        for (int first = 0; first < photoCount; first += PageSize) {
+            const int count = qMin(PageSize, photoCount - first);
+            const QString next = first + count < photoCount
+                    ? QString::fromUtf8(pageUrl(first + count).toEncoded())
+                    : QString();
+            QVERIFY(BenchmarkFixtures::writeGet(manager, pageUrl(first),
+                                                BenchmarkPayloads::photoPage(first, count, next)));
+        }
+    }
+}
+
+void tst_SyncReplay::photos_data()
+{
+    QTest::addColumn<int>("photoCount");
+
+    QTest::newRow("1k photos") << 1000;
+    QTest::newRow("20k photos") << 20000;
+}
+
+void tst_SyncReplay::photos()
+{
+    QFETCH(int, photoCount);
+
+    int photos = 0;
+    int pages = 0;
+    QBENCHMARK {
+        ReplayNetworkAccessManager manager(fixtureName(photoCount));
+        QCOMPARE(manager.mode(), ReplayNetworkAccessManager::Replay);
+
+        photos = 0;
+        pages = 0;
+        QUrl url = pageUrl(0);
+        while (!url.isEmpty()) {
+            QNetworkReply *reply = manager.get(QNetworkRequest(url));
+            JsonStreamReader *reader = JsonStreamReader::attach(reply, QStringList() << QStringLiteral("data"), false);
+            connect(reader, &JsonStreamReader::itemsAvailable, reader, [reader, &photos] {
+                while (reader->readNext()) {
+                    photos += reader->item().toObject().isEmpty() ? 0 : 1;
+                }
+            });
+
+            QEventLoop loop;
+            connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+            if (!reply->isFinished()) {
+                loop.exec();
+            }
+
+            QCOMPARE(reply->error(), QNetworkReply::NoError);
+            reader->addData(reply->readAll());
+            QVERIFY(reader->finish());
+            while (reader->readNext()) {
+                photos += reader->item().toObject().isEmpty() ? 0 : 1;
+            }
+            pages += 1;
+
+            const QJsonObject paging = reader->envelope().object().value(QStringLiteral("paging")).toObject();
+            url = QUrl(paging.value(QStringLiteral("next")).toString());
+            delete reply;
+        }
+    }
+
+    QCOMPARE(photos, photoCount);
+    QCOMPARE(pages, (photoCount + PageSize - 1) / PageSize);
+}
+
+QTEST_GUILESS_MAIN(tst_SyncReplay)
+
+#include "tst_syncreplay.moc"
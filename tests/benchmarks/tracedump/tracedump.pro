@@ -0,0 +1,5 @@
+TARGET = tst_tracedump
+
+include($$PWD/../benchmarks.pri)
+
+SOURCES += tst_tracedump.cpp
@@ -0,0 +1,134 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2026 Jolla Ltd.
+ **
+ ** This program/library is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public License
+ ** version 2.1 as published by the Free Software Foundation.
+ **
+ ** This program/library is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this program/library; if not, write to the Free
+ ** Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ ** 02110-1301 USA
+ **
+ ****************************************************************************/
+
+#include "benchmarkpayloads.h"
+#include "trace.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QtTest>
+
+namespace {
+    // The dump helper the adaptors used before SOCIALD_TRACE_DUMP(): it
+    // checks the category, but only after its argument has been built.
+    void eagerTraceDump(const QString &str)
+    {
+        if (!lcSocialPluginTrace().isDebugEnabled()) {
+            return;
+        }
+        Q_FOREACH (const QString &chunk, str.split(QLatin1Char('\n'), QString::SkipEmptyParts)) {
+            qCDebug(lcSocialPluginTrace) << chunk;
+        }
+    }
+}
+
+/*
+    Measures the cost of the trace dumps of a Google events page when the
+    trace category is disabled, which is the default: the dump of the
+    whole reply, and the dumps of every event as it is serialized again.
+*/
+class tst_TraceDump : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void replyDump_data();
+    void replyDump();
+    void eventDumps_data();
+    void eventDumps();
+
+private:
+    void addPages();
+};
+
+void tst_TraceDump::initTestCase()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("buteo.plugin.social.trace.debug=false"));
+    QVERIFY(!lcSocialPluginTrace().isDebugEnabled());
+}
+
+void tst_TraceDump::addPages()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<bool>("lazy");
+
+    const int counts[] = { 250, 2500 };
+    for (int count : counts) {
+        const QByteArray payload = BenchmarkPayloads::eventsPage(count);
+        QTest::newRow(qPrintable(QStringLiteral("%1 events, eager").arg(count))) << payload << false;
+        QTest::newRow(qPrintable(QStringLiteral("%1 events, lazy").arg(count))) << payload << true;
+    }
+}
+
+void tst_TraceDump::replyDump_data()
+{
+    addPages();
+}
+
+void tst_TraceDump::replyDump()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(bool, lazy);
+
+    if (lazy) {
+        QBENCHMARK {
+            SOCIALD_TRACE_DUMP(QString::fromUtf8(payload));
+        }
+    } else {
+        QBENCHMARK {
+            eagerTraceDump(QString::fromUtf8(payload));
+        }
+    }
+}
+
+void tst_TraceDump::eventDumps_data()
+{
+    addPages();
+}
+
+void tst_TraceDump::eventDumps()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(bool, lazy);
+
+    const QJsonArray items = QJsonDocument::fromJson(payload).object().value(QStringLiteral("items")).toArray();
+    QVERIFY(!items.isEmpty());
+
+    if (lazy) {
+        QBENCHMARK {
+            Q_FOREACH (const QJsonValue &item, items) {
+                SOCIALD_TRACE_DUMP(QJsonDocument(item.toObject()).toJson());
+            }
+        }
+    } else {
+        QBENCHMARK {
+            Q_FOREACH (const QJsonValue &item, items) {
+                eagerTraceDump(QString::fromUtf8(QJsonDocument(item.toObject()).toJson()));
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_TraceDump)
+
+#include "tst_tracedump.moc"